@@ -28,6 +28,15 @@ data class SpectrogramData(
     val frequencies: FloatArray         // Frequencies (in Hz) for each mel bin
 )
 
+data class EncodedSpectrogramData(
+    val data: ByteArray,     // timeSteps * nMels values, row-major, little-endian
+    val outputFormat: Int,   // 1 = float16, 2 = uint8
+    val timeSteps: Int,
+    val nMels: Int,
+    val quantScale: Float,   // uint8 only: value = quantOffset + q * quantScale
+    val quantOffset: Float
+)
+
 class AudioProcessor(private val filesDir: File) {
     companion object {
         const val DCT_SQRT_DIVISOR = 2.0
@@ -1711,6 +1720,59 @@ class AudioProcessor(private val filesDir: File) {
         return SpectrogramData(melSpectrogram, timeStamps, frequencies)
     }
 
+    // extractMelSpectrogram with a compact bridge payload (outputFormat 1 = float16, 2 = uint8)
+    fun extractMelSpectrogramEncoded(
+        audioData: AudioData,
+        outputFormat: Int,
+        windowSizeMs: Float = 25f,
+        hopLengthMs: Float = 10f,
+        nMels: Int = 128,
+        fftLength: Int = 2048,
+        fMin: Float = 0f,
+        fMax: Float = audioData.sampleRate.toFloat() / 2,
+        windowType: String = "hann",
+        logScaling: Boolean = true,
+        normalize: Boolean = false
+    ): EncodedSpectrogramData {
+        val sampleRate = audioData.sampleRate.toFloat()
+        val samples = convertToFloatArray(audioData.data, audioData.bitDepth)
+
+        val windowSizeSamples = (windowSizeMs * sampleRate / 1000).toInt()
+        val hopLengthSamples = (hopLengthMs * sampleRate / 1000).toInt()
+
+        val windowTypeInt = when (windowType.lowercase()) {
+            "hann" -> 0
+            "hamming" -> 1
+            else -> throw IllegalArgumentException("Unsupported windowType: $windowType")
+        }
+
+        val meta = FloatArray(4)
+        val data = MelSpectrogramNative.computeEncoded(
+            samples = samples,
+            sampleRate = sampleRate.toInt(),
+            fftLength = fftLength,
+            windowSizeSamples = windowSizeSamples,
+            hopLengthSamples = hopLengthSamples,
+            nMels = nMels,
+            fMin = fMin,
+            fMax = fMax,
+            windowType = windowTypeInt,
+            logScale = logScaling,
+            normalize = normalize,
+            outputFormat = outputFormat,
+            meta = meta
+        ) ?: ByteArray(0)
+
+        return EncodedSpectrogramData(
+            data = data,
+            outputFormat = outputFormat,
+            timeSteps = meta[0].toInt(),
+            nMels = if (data.isEmpty()) nMels else meta[1].toInt(),
+            quantScale = meta[2],
+            quantOffset = meta[3]
+        )
+    }
+
     // Compute Short-Time Fourier Transform
     private fun computeSTFT(
         samples: FloatArray,
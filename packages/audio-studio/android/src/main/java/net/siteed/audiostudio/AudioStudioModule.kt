@@ -495,6 +495,7 @@ class AudioStudioModule : Module(), EventSender {
                 val windowType = options["windowType"] as? String ?: "hann"
                 val normalize = options["normalize"] as? Boolean ?: false
                 val logScale = options["logScale"] as? Boolean ?: true
+                val outputFormat = options["outputFormat"] as? String ?: "float32"
                 
                 // Fix the conversion from Number to Long to preserve decimal values
                 val startTimeMsNumber = options["startTimeMs"] as? Number
@@ -608,6 +609,38 @@ class AudioStudioModule : Module(), EventSender {
                     )
                 }
 
+                // Compact formats cross the bridge as one base64 payload instead of nested arrays
+                val outputFormatCode = when (outputFormat) {
+                    "float16" -> 1
+                    "uint8" -> 2
+                    else -> 0
+                }
+                if (outputFormatCode != 0) {
+                    val encoded = audioProcessor.extractMelSpectrogramEncoded(
+                        audioData = audioData,
+                        outputFormat = outputFormatCode,
+                        windowSizeMs = windowSizeMs.toFloat(),
+                        hopLengthMs = hopLengthMs.toFloat(),
+                        nMels = nMels,
+                        fMin = fMin.toFloat(),
+                        fMax = fMax?.toFloat() ?: (audioData.sampleRate.toFloat() / 2),
+                        normalize = normalize,
+                        logScaling = logScale,
+                        windowType = windowType
+                    )
+                    promise.resolve(mapOf(
+                        "encodedSpectrogram" to AudioDataEncoder().encodeToBase64(encoded.data),
+                        "outputFormat" to outputFormat,
+                        "quantScale" to encoded.quantScale,
+                        "quantOffset" to encoded.quantOffset,
+                        "sampleRate" to audioData.sampleRate,
+                        "nMels" to encoded.nMels,
+                        "timeSteps" to encoded.timeSteps,
+                        "durationMs" to audioData.durationMs
+                    ))
+                    return@AsyncFunction
+                }
+
                 // Compute mel-spectrogram
                 LogUtils.d(CLASS_NAME, "Computing mel-spectrogram...")
                 val spectrogramData = audioProcessor.extractMelSpectrogram(
@@ -19,6 +19,27 @@ object MelSpectrogramNative {
         normalize: Boolean
     ): Array<FloatArray>
 
+    /**
+     * [compute] with a compact [outputFormat] (1 = float16, 2 = uint8): the values as
+     * little-endian bytes, row-major. [meta] (4 values) receives timeSteps, nMels and
+     * the uint8 scale and offset (value = offset + q * scale).
+     */
+    external fun computeEncoded(
+        samples: FloatArray,
+        sampleRate: Int,
+        fftLength: Int,
+        windowSizeSamples: Int,
+        hopLengthSamples: Int,
+        nMels: Int,
+        fMin: Float,
+        fMax: Float,
+        windowType: Int,
+        logScale: Boolean,
+        normalize: Boolean,
+        outputFormat: Int,
+        meta: FloatArray
+    ): ByteArray?
+
     external fun init(
         sampleRate: Int,
         fftLength: Int,
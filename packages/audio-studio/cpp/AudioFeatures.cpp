@@ -7,12 +7,17 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+AudioFeaturesConfig AudioFeaturesProcessor::normalizedConfig(const AudioFeaturesConfig& config) {
+    AudioFeaturesConfig c = config;
+    if (c.sampleRate <= 0) c.sampleRate = 16000;
+    if (c.fftLength <= 0) c.fftLength = 1024;
+    if (c.nMfcc <= 0) c.nMfcc = 13;
+    if (c.nMelFilters <= 0) c.nMelFilters = 26;
+    return c;
+}
+
 AudioFeaturesProcessor::AudioFeaturesProcessor(const AudioFeaturesConfig& config)
-    : config_(config), fftCfg_(nullptr) {
-    if (config_.sampleRate <= 0) config_.sampleRate = 16000;
-    if (config_.fftLength <= 0) config_.fftLength = 1024;
-    if (config_.nMfcc <= 0) config_.nMfcc = 13;
-    if (config_.nMelFilters <= 0) config_.nMelFilters = 26;
+    : config_(normalizedConfig(config)), fftCfg_(nullptr) {
     numBins_ = config_.fftLength / 2 + 1;
     fftCfg_ = kiss_fftr_alloc(config_.fftLength, 0, nullptr, nullptr);
     buildWindow();
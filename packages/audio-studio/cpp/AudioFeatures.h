@@ -41,6 +41,9 @@ public:
     AudioFeaturesProcessor(const AudioFeaturesProcessor&) = delete;
     AudioFeaturesProcessor& operator=(const AudioFeaturesProcessor&) = delete;
 
+    // config with invalid values replaced by the defaults the processor runs with
+    static AudioFeaturesConfig normalizedConfig(const AudioFeaturesConfig& config);
+
     AudioFeaturesResult compute(const float* samples, int numSamples);
 
     const AudioFeaturesConfig& config() const { return config_; }
@@ -0,0 +1,345 @@
+#include "FeatureStore.h"
+#include "HalfFloat.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char kMagic[4] = {'A', 'S', 'F', 'S'};
+const uint16_t kVersion = 1;
+const uint32_t kDataOffset = 64;
+
+struct Fnv1a {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    template <typename T>
+    void add(const T& value) {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        for (unsigned char b : bytes) {
+            hash ^= b;
+            hash *= 0x100000001b3ULL;
+        }
+    }
+};
+
+size_t dtypeSize(FeatureStoreDType dtype) {
+    return dtype == FeatureStoreDType::Float16 ? sizeof(uint16_t) : sizeof(float);
+}
+
+bool writeFully(int fd, const void* buffer, size_t size, off_t offset) {
+    const uint8_t* p = static_cast<const uint8_t*>(buffer);
+    while (size > 0) {
+        ssize_t written = pwrite(fd, p, size, offset);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += written;
+        offset += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool readHeader(int fd, FeatureStoreHeader& header) {
+    return pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+           std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+           header.version == kVersion &&
+           header.dataOffset >= sizeof(FeatureStoreHeader) &&
+           header.frameSize > 0 &&
+           header.dtype <= static_cast<uint16_t>(FeatureStoreDType::Float16);
+}
+
+} // namespace
+
+uint64_t featureStoreConfigHash(const MelSpectrogramConfig& requested) {
+    // Hash what the processor runs with, so fMax = 0 and fMax = sampleRate / 2
+    // (and the other defaulted fields) match the stores they produce
+    const MelSpectrogramConfig config = MelSpectrogramProcessor::normalizedConfig(requested);
+    Fnv1a h;
+    h.add(uint32_t{0x4D454C31});  // "MEL1"
+    h.add(config.sampleRate);
+    h.add(config.fftLength);
+    h.add(config.windowSizeSamples);
+    h.add(config.hopLengthSamples);
+    h.add(config.nMels);
+    h.add(config.fMin);
+    h.add(config.fMax);
+    h.add(config.windowType);
+    h.add(config.logScale);
+    h.add(config.normalize);
+    h.add(config.paddingMode);
+    return h.hash;
+}
+
+uint64_t featureStoreConfigHash(const AudioFeaturesConfig& requested) {
+    const AudioFeaturesConfig config = AudioFeaturesProcessor::normalizedConfig(requested);
+    Fnv1a h;
+    h.add(uint32_t{0x46454131});  // "FEA1"
+    h.add(config.sampleRate);
+    h.add(config.fftLength);
+    h.add(config.nMfcc);
+    h.add(config.nMelFilters);
+    h.add(config.computeMfcc);
+    h.add(config.computeChroma);
+    return h.hash;
+}
+
+int audioFeaturesFrameSize(const AudioFeaturesConfig& config) {
+    return 4 + (config.computeMfcc ? config.nMfcc : 0) + (config.computeChroma ? 12 : 0);
+}
+
+void flattenAudioFeatures(const AudioFeaturesResult& result, const AudioFeaturesConfig& config, float* row) {
+    row[0] = result.spectralCentroid;
+    row[1] = result.spectralFlatness;
+    row[2] = result.spectralRolloff;
+    row[3] = result.spectralBandwidth;
+    float* p = row + 4;
+    if (config.computeMfcc) {
+        for (int i = 0; i < config.nMfcc; ++i) {
+            *p++ = i < static_cast<int>(result.mfcc.size()) ? result.mfcc[i] : 0.0f;
+        }
+    }
+    if (config.computeChroma) {
+        for (int i = 0; i < 12; ++i) {
+            *p++ = i < static_cast<int>(result.chromagram.size()) ? result.chromagram[i] : 0.0f;
+        }
+    }
+}
+
+AudioFeaturesResult unflattenAudioFeatures(const float* row, const AudioFeaturesConfig& config) {
+    AudioFeaturesResult result;
+    result.spectralCentroid = row[0];
+    result.spectralFlatness = row[1];
+    result.spectralRolloff = row[2];
+    result.spectralBandwidth = row[3];
+    const float* p = row + 4;
+    if (config.computeMfcc) {
+        result.mfcc.assign(p, p + config.nMfcc);
+        p += config.nMfcc;
+    }
+    if (config.computeChroma) {
+        result.chromagram.assign(p, p + 12);
+    }
+    return result;
+}
+
+std::string featureStorePath(const std::string& wavPath, const std::string& kind) {
+    return wavPath + "." + kind + ".asfs";
+}
+
+// ---------------------------------------------------------------------------
+// Writer
+
+FeatureStoreWriter::~FeatureStoreWriter() {
+    close();
+}
+
+FeatureStoreStatus FeatureStoreWriter::open(const std::string& path, const FeatureStoreInfo& info, bool resume) {
+    close();
+    if (info.frameSize <= 0) {
+        return FeatureStoreStatus::Invalid;
+    }
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+        return FeatureStoreStatus::IoError;
+    }
+    info_ = info;
+    frameCount_ = 0;
+
+    FeatureStoreHeader existing;
+    if (resume && readHeader(fd_, existing) &&
+        existing.configHash == info.configHash &&
+        existing.frameSize == static_cast<uint32_t>(info.frameSize) &&
+        existing.dtype == static_cast<uint16_t>(info.dtype) &&
+        existing.dataOffset == kDataOffset) {
+        frameCount_ = existing.frameCount;
+    }
+
+    // Drop anything past the last complete frame (e.g. a write interrupted by a crash)
+    const off_t end = static_cast<off_t>(kDataOffset + frameCount_ * info_.frameSize * dtypeSize(info_.dtype));
+    if (ftruncate(fd_, end) != 0 || !writeHeader()) {
+        close();
+        return FeatureStoreStatus::IoError;
+    }
+    return FeatureStoreStatus::Ok;
+}
+
+bool FeatureStoreWriter::writeHeader() {
+    FeatureStoreHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.dtype = static_cast<uint16_t>(info_.dtype);
+    header.configHash = info_.configHash;
+    header.sampleRate = static_cast<uint32_t>(info_.sampleRate);
+    header.hopLengthSamples = static_cast<uint32_t>(info_.hopLengthSamples);
+    header.frameSize = static_cast<uint32_t>(info_.frameSize);
+    header.dataOffset = kDataOffset;
+    header.frameCount = frameCount_;
+    return writeFully(fd_, &header, sizeof(header), 0);
+}
+
+bool FeatureStoreWriter::append(const float* frames, int numFrames) {
+    if (fd_ < 0 || !frames || numFrames <= 0) {
+        return fd_ >= 0 && numFrames == 0;
+    }
+
+    const size_t count = static_cast<size_t>(numFrames) * info_.frameSize;
+    const size_t elemSize = dtypeSize(info_.dtype);
+    const off_t offset = static_cast<off_t>(kDataOffset + frameCount_ * info_.frameSize * elemSize);
+
+    bool ok;
+    if (info_.dtype == FeatureStoreDType::Float16) {
+        halfBuffer_.resize(count);
+        floatToHalfArray(frames, halfBuffer_.data(), count);
+        ok = writeFully(fd_, halfBuffer_.data(), count * elemSize, offset);
+    } else {
+        ok = writeFully(fd_, frames, count * elemSize, offset);
+    }
+    if (!ok) {
+        return false;
+    }
+
+    // Publish the new frames only once their data is on disk
+    frameCount_ += static_cast<uint64_t>(numFrames);
+    return writeFully(fd_, &frameCount_, sizeof(frameCount_), offsetof(FeatureStoreHeader, frameCount));
+}
+
+bool FeatureStoreWriter::append(const MelSpectrogramResult& result) {
+    if (result.nMels != info_.frameSize) {
+        return false;
+    }
+    if (result.outputFormat == 0) {
+        return append(result.data.data(), result.timeSteps);
+    }
+    if (result.outputFormat != 1 || info_.dtype != FeatureStoreDType::Float16) {
+        return false;  // uint8 has no store dtype; half results need a Float16 store
+    }
+    if (fd_ < 0 || result.timeSteps <= 0) {
+        return fd_ >= 0 && result.timeSteps == 0;
+    }
+
+    // Already half precision: write as is
+    const size_t bytes = result.dataF16.size() * sizeof(uint16_t);
+    const off_t offset = static_cast<off_t>(kDataOffset + frameCount_ * info_.frameSize * sizeof(uint16_t));
+    if (!writeFully(fd_, result.dataF16.data(), bytes, offset)) {
+        return false;
+    }
+    frameCount_ += static_cast<uint64_t>(result.timeSteps);
+    return writeFully(fd_, &frameCount_, sizeof(frameCount_), offsetof(FeatureStoreHeader, frameCount));
+}
+
+void FeatureStoreWriter::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    halfBuffer_.clear();
+    halfBuffer_.shrink_to_fit();
+}
+
+// ---------------------------------------------------------------------------
+// Reader
+
+FeatureStoreReader::~FeatureStoreReader() {
+    close();
+}
+
+FeatureStoreStatus FeatureStoreReader::open(const std::string& path, uint64_t expectedConfigHash) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return errno == ENOENT ? FeatureStoreStatus::NotFound : FeatureStoreStatus::IoError;
+    }
+
+    FeatureStoreHeader header;
+    struct stat st;
+    if (!readHeader(fd, header) || fstat(fd, &st) != 0) {
+        ::close(fd);
+        return FeatureStoreStatus::Invalid;
+    }
+    if (header.configHash != expectedConfigHash) {
+        ::close(fd);
+        return FeatureStoreStatus::ConfigMismatch;
+    }
+
+    const FeatureStoreDType dtype = static_cast<FeatureStoreDType>(header.dtype);
+    const uint64_t needed = header.dataOffset + header.frameCount * header.frameSize * dtypeSize(dtype);
+    if (static_cast<uint64_t>(st.st_size) < needed) {
+        ::close(fd);
+        return FeatureStoreStatus::Invalid;
+    }
+
+    void* mapping = mmap(nullptr, static_cast<size_t>(needed), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // the mapping keeps the file referenced
+    if (mapping == MAP_FAILED) {
+        return FeatureStoreStatus::IoError;
+    }
+
+    mapping_ = mapping;
+    mappingSize_ = static_cast<size_t>(needed);
+    data_ = static_cast<const uint8_t*>(mapping) + header.dataOffset;
+    info_.configHash = header.configHash;
+    info_.sampleRate = static_cast<int>(header.sampleRate);
+    info_.hopLengthSamples = static_cast<int>(header.hopLengthSamples);
+    info_.frameSize = static_cast<int>(header.frameSize);
+    info_.dtype = dtype;
+    frameCount_ = header.frameCount;
+    return FeatureStoreStatus::Ok;
+}
+
+void FeatureStoreReader::close() {
+    if (mapping_) {
+        munmap(mapping_, mappingSize_);
+    }
+    mapping_ = nullptr;
+    mappingSize_ = 0;
+    data_ = nullptr;
+    info_ = FeatureStoreInfo();
+    frameCount_ = 0;
+}
+
+const float* FeatureStoreReader::float32Data() const {
+    return (data_ && info_.dtype == FeatureStoreDType::Float32)
+        ? reinterpret_cast<const float*>(data_) : nullptr;
+}
+
+const uint16_t* FeatureStoreReader::float16Data() const {
+    return (data_ && info_.dtype == FeatureStoreDType::Float16)
+        ? reinterpret_cast<const uint16_t*>(data_) : nullptr;
+}
+
+bool FeatureStoreReader::readFrames(uint64_t start, uint64_t count, float* out) const {
+    if (!data_ || !out || start > frameCount_ || count > frameCount_ - start) {
+        return false;
+    }
+    const size_t offset = static_cast<size_t>(start) * info_.frameSize;
+    const size_t n = static_cast<size_t>(count) * info_.frameSize;
+    if (info_.dtype == FeatureStoreDType::Float16) {
+        halfToFloatArray(float16Data() + offset, out, n);
+    } else {
+        std::memcpy(out, float32Data() + offset, n * sizeof(float));
+    }
+    return true;
+}
+
+MelSpectrogramResult FeatureStoreReader::toMelSpectrogram() const {
+    MelSpectrogramResult result{{}, 0, info_.frameSize};
+    if (!data_) {
+        return result;
+    }
+    result.timeSteps = static_cast<int>(frameCount_);
+    result.data.resize(static_cast<size_t>(frameCount_) * info_.frameSize);
+    readFrames(0, frameCount_, result.data.data());
+    return result;
+}
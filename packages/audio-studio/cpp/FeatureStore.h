@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "AudioFeatures.h"
+#include "MelSpectrogram.h"
+
+// Compact on-disk store for per-frame analysis results, written next to the WAV
+// and memory-mapped back on reopen.
+//
+// Layout (little-endian):
+//   [0, 64)   FeatureStoreHeader
+//   [64, ...) frameCount * frameSize values of dtype, row-major
+//
+// The header carries a hash of the analysis config; a reader opened with a
+// different hash reports ConfigMismatch so the caller recomputes.
+//
+// Not part of the app targets yet (Android CMake, iOS MelSpectrogramWrapper.mm):
+// add FeatureStore.cpp there together with the bridge entry points that use it.
+
+enum class FeatureStoreDType : uint16_t {
+    Float32 = 0,
+    Float16 = 1,
+};
+
+enum class FeatureStoreStatus {
+    Ok,
+    NotFound,
+    Invalid,         // bad magic/version or truncated file
+    ConfigMismatch,  // written with a different config, recompute
+    IoError,
+};
+
+struct FeatureStoreInfo {
+    uint64_t configHash = 0;
+    int sampleRate = 0;
+    int hopLengthSamples = 0;
+    int frameSize = 0;  // values per frame (e.g. nMels)
+    FeatureStoreDType dtype = FeatureStoreDType::Float32;
+};
+
+#pragma pack(push, 1)
+struct FeatureStoreHeader {
+    char magic[4];           // "ASFS"
+    uint16_t version;
+    uint16_t dtype;          // FeatureStoreDType
+    uint64_t configHash;
+    uint32_t sampleRate;
+    uint32_t hopLengthSamples;
+    uint32_t frameSize;
+    uint32_t dataOffset;     // start of the frame array, 64-byte aligned
+    uint64_t frameCount;     // frames fully written
+    uint8_t reserved[24];
+};
+#pragma pack(pop)
+static_assert(sizeof(FeatureStoreHeader) == 64, "FeatureStoreHeader must be 64 bytes");
+
+// Config hashes (FNV-1a over the fields that change the output)
+uint64_t featureStoreConfigHash(const MelSpectrogramConfig& config);
+uint64_t featureStoreConfigHash(const AudioFeaturesConfig& config);
+
+// Per-segment AudioFeaturesResult stored as one row:
+// [centroid, flatness, rolloff, bandwidth, mfcc[nMfcc]?, chroma[12]?]
+int audioFeaturesFrameSize(const AudioFeaturesConfig& config);
+void flattenAudioFeatures(const AudioFeaturesResult& result, const AudioFeaturesConfig& config, float* row);
+AudioFeaturesResult unflattenAudioFeatures(const float* row, const AudioFeaturesConfig& config);
+
+// "<wavPath>.<kind>.asfs", e.g. recording.wav.mel.asfs
+std::string featureStorePath(const std::string& wavPath, const std::string& kind);
+
+class FeatureStoreWriter {
+public:
+    FeatureStoreWriter() = default;
+    ~FeatureStoreWriter();
+
+    FeatureStoreWriter(const FeatureStoreWriter&) = delete;
+    FeatureStoreWriter& operator=(const FeatureStoreWriter&) = delete;
+
+    // With resume, an existing store with the same hash and shape is appended to
+    // (e.g. a recording that was paused); otherwise the file is recreated.
+    FeatureStoreStatus open(const std::string& path, const FeatureStoreInfo& info, bool resume = true);
+    bool append(const float* frames, int numFrames);
+    bool append(const MelSpectrogramResult& result);  // float32, or float16 into a Float16 store
+    void close();
+
+    bool isOpen() const { return fd_ >= 0; }
+    uint64_t frameCount() const { return frameCount_; }
+
+private:
+    int fd_ = -1;
+    FeatureStoreInfo info_;
+    uint64_t frameCount_ = 0;
+    std::vector<uint16_t> halfBuffer_;
+
+    bool writeHeader();
+};
+
+class FeatureStoreReader {
+public:
+    FeatureStoreReader() = default;
+    ~FeatureStoreReader();
+
+    FeatureStoreReader(const FeatureStoreReader&) = delete;
+    FeatureStoreReader& operator=(const FeatureStoreReader&) = delete;
+
+    // Maps the file read-only; O(1) regardless of length.
+    FeatureStoreStatus open(const std::string& path, uint64_t expectedConfigHash);
+    void close();
+
+    const FeatureStoreInfo& info() const { return info_; }
+    uint64_t frameCount() const { return frameCount_; }
+
+    // Direct views into the mapping (nullptr when the dtype differs)
+    const float* float32Data() const;
+    const uint16_t* float16Data() const;
+
+    // Copies frames [start, start + count) as float32, converting if needed.
+    bool readFrames(uint64_t start, uint64_t count, float* out) const;
+    MelSpectrogramResult toMelSpectrogram() const;
+
+private:
+    void* mapping_ = nullptr;
+    size_t mappingSize_ = 0;
+    const uint8_t* data_ = nullptr;
+    FeatureStoreInfo info_;
+    uint64_t frameCount_ = 0;
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+// IEEE 754 binary16 <-> binary32 conversion (round-to-nearest-even).
+// Scalar path is portable bit manipulation; the array helpers use the hardware
+// converters (AArch64 NEON, x86 F16C) when the target has them.
+
+inline uint16_t floatToHalf(float value) {
+    uint32_t x;
+    std::memcpy(&x, &value, sizeof(x));
+    const uint32_t sign = (x >> 16) & 0x8000u;
+    uint32_t mant = x & 0x007FFFFFu;
+    int32_t exp = static_cast<int32_t>((x >> 23) & 0xFFu);
+
+    if (exp == 0xFF) {
+        // Inf stays Inf, NaN stays a (quiet) NaN
+        return static_cast<uint16_t>(sign | 0x7C00u | (mant ? 0x0200u : 0u));
+    }
+
+    exp = exp - 127 + 15;
+    if (exp >= 0x1F) {
+        return static_cast<uint16_t>(sign | 0x7C00u);  // overflow -> Inf
+    }
+
+    if (exp <= 0) {
+        if (exp < -10) {
+            return static_cast<uint16_t>(sign);  // underflow -> signed zero
+        }
+        // Subnormal half: shift the mantissa (with implicit bit) into place
+        mant |= 0x00800000u;
+        const int shift = 14 - exp;
+        uint32_t half = mant >> shift;
+        const uint32_t rem = mant & ((1u << shift) - 1u);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (rem > halfway || (rem == halfway && (half & 1u))) {
+            ++half;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    uint32_t half = (static_cast<uint32_t>(exp) << 10) | (mant >> 13);
+    const uint32_t rem = mant & 0x1FFFu;
+    // A carry out of the mantissa correctly bumps the exponent (up to Inf)
+    if (rem > 0x1000u || (rem == 0x1000u && (half & 1u))) {
+        ++half;
+    }
+    return static_cast<uint16_t>(sign | half);
+}
+
+inline float halfToFloat(uint16_t h) {
+    const uint32_t sign = static_cast<uint32_t>(h & 0x8000u) << 16;
+    int32_t exp = (h >> 10) & 0x1F;
+    uint32_t mant = h & 0x03FFu;
+    uint32_t bits;
+
+    if (exp == 0) {
+        if (mant == 0) {
+            bits = sign;
+        } else {
+            // Subnormal half -> normal float
+            exp = 1;
+            while (!(mant & 0x0400u)) {
+                mant <<= 1;
+                --exp;
+            }
+            mant &= 0x03FFu;
+            bits = sign | (static_cast<uint32_t>(exp + 127 - 15) << 23) | (mant << 13);
+        }
+    } else if (exp == 0x1F) {
+        bits = sign | 0x7F800000u | (mant << 13);
+    } else {
+        bits = sign | (static_cast<uint32_t>(exp + 127 - 15) << 23) | (mant << 13);
+    }
+
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline void floatToHalfArray(const float* in, uint16_t* out, size_t count) {
+    size_t i = 0;
+#if defined(__aarch64__)
+    for (; i + 4 <= count; i += 4) {
+        vst1_u16(out + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(in + i))));
+    }
+#elif defined(__F16C__)
+    for (; i + 8 <= count; i += 8) {
+        const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), h);
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = floatToHalf(in[i]);
+    }
+}
+
+inline void halfToFloatArray(const uint16_t* in, float* out, size_t count) {
+    size_t i = 0;
+#if defined(__aarch64__)
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(out + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(in + i))));
+    }
+#elif defined(__F16C__)
+    for (; i + 8 <= count; i += 8) {
+        const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm256_storeu_ps(out + i, _mm256_cvtph_ps(h));
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = halfToFloat(in[i]);
+    }
+}
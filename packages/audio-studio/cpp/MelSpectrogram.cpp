@@ -1,4 +1,6 @@
 #include "MelSpectrogram.h"
+#include "HalfFloat.h"
+#include "Quantize8.h"
 
 #include <algorithm>
 #include <cstring>
@@ -8,16 +10,23 @@
 #define M_PI 3.14159265358979323846
 #endif
 
-MelSpectrogramProcessor::MelSpectrogramProcessor(const MelSpectrogramConfig& config)
-    : config_(config), fftCfg_(nullptr) {
+MelSpectrogramConfig MelSpectrogramProcessor::normalizedConfig(const MelSpectrogramConfig& config) {
     // Clamp invalid values to safe defaults to prevent division by zero
-    if (config_.fftLength <= 0) config_.fftLength = 2048;
-    if (config_.hopLengthSamples <= 0) config_.hopLengthSamples = 160;
-    if (config_.windowSizeSamples <= 1) config_.windowSizeSamples = 400;
-    if (config_.nMels <= 0) config_.nMels = 128;
-    if (config_.fMax <= 0.0f) {
-        config_.fMax = static_cast<float>(config_.sampleRate) / 2.0f;
+    MelSpectrogramConfig c = config;
+    if (c.fftLength <= 0) c.fftLength = 2048;
+    if (c.hopLengthSamples <= 0) c.hopLengthSamples = 160;
+    if (c.windowSizeSamples <= 1) c.windowSizeSamples = 400;
+    if (c.nMels <= 0) c.nMels = 128;
+    if (c.paddingMode < 0 || c.paddingMode > 3) c.paddingMode = 0;
+    if (c.outputFormat < 0 || c.outputFormat > 2) c.outputFormat = 0;
+    if (c.fMax <= 0.0f) {
+        c.fMax = static_cast<float>(c.sampleRate) / 2.0f;
     }
+    return c;
+}
+
+MelSpectrogramProcessor::MelSpectrogramProcessor(const MelSpectrogramConfig& config)
+    : config_(normalizedConfig(config)), fftCfg_(nullptr) {
     fftCfg_ = kiss_fftr_alloc(config_.fftLength, 0, nullptr, nullptr);
     buildWindow();
     buildMelFilterbank();
@@ -35,6 +44,9 @@ void MelSpectrogramProcessor::allocateBuffers() {
     fftInput_.resize(config_.fftLength, 0.0f);
     fftOutput_.resize(numBins);
     powerSpectrum_.resize(numBins);
+    if (config_.paddingMode != 0) {
+        edgeFrame_.resize(config_.windowSizeSamples, 0.0f);
+    }
 }
 
 float MelSpectrogramProcessor::hzToMel(float hz) {
@@ -103,76 +115,114 @@ void MelSpectrogramProcessor::buildMelFilterbank() {
     }
 }
 
-MelSpectrogramResult MelSpectrogramProcessor::compute(const float* samples, int numSamples) {
-    const int numBins = config_.fftLength / 2 + 1;
-    const int numFrames = (numSamples - config_.windowSizeSamples) / config_.hopLengthSamples + 1;
+int MelSpectrogramProcessor::numFrames(int numSamples) const {
+    if (numSamples <= 0) {
+        return 0;
+    }
+    if (config_.paddingMode != 0) {
+        // Same count as librosa center=True: 1 + numSamples / hop (for even windows)
+        const int pad = config_.windowSizeSamples / 2;
+        return (numSamples + 2 * pad - config_.windowSizeSamples) / config_.hopLengthSamples + 1;
+    }
+    // A signal shorter than one window still yields a (zero-padded) frame when it
+    // covers more than window - hop samples, matching the original frame count.
+    return (numSamples - config_.windowSizeSamples) / config_.hopLengthSamples + 1;
+}
+
+const float* MelSpectrogramProcessor::frameAt(const float* samples, int numSamples,
+                                              int frameIdx, int& frameLen) {
+    const int window = config_.windowSizeSamples;
+    const int pad = (config_.paddingMode != 0) ? window / 2 : 0;
+    const int start = frameIdx * config_.hopLengthSamples - pad;
 
-    if (numFrames <= 0) {
-        return MelSpectrogramResult{{}, 0, config_.nMels};
+    // Interior frame (or no padding): read the input in place
+    if (pad == 0 || (start >= 0 && start + window <= numSamples)) {
+        frameLen = std::min(window, numSamples - start);
+        return samples + start;
     }
 
-    // Use pre-allocated work buffers
+    // Edge frame: gather through mirrored/clamped indices into one window of scratch
+    const int last = numSamples - 1;
+    for (int i = 0; i < window; ++i) {
+        int idx = start + i;
+        if (idx >= 0 && idx <= last) {
+            edgeFrame_[i] = samples[idx];
+            continue;
+        }
+        switch (config_.paddingMode) {
+            case 2: {
+                // numpy 'reflect' (edge sample not repeated); fold for pads longer than the signal
+                if (last == 0) { idx = 0; break; }
+                const int period = 2 * last;
+                idx = ((idx % period) + period) % period;
+                if (idx > last) idx = period - idx;
+                break;
+            }
+            case 3:
+                idx = idx < 0 ? 0 : last;
+                break;
+            default:
+                idx = -1;  // zero
+                break;
+        }
+        edgeFrame_[i] = idx >= 0 ? samples[idx] : 0.0f;
+    }
+    frameLen = window;
+    return edgeFrame_.data();
+}
+
+const float* MelSpectrogramProcessor::computePowerSpectrum(const float* frame, int frameLen) {
+    const int numBins = config_.fftLength / 2 + 1;
     float* fftIn = fftInput_.data();
     kiss_fft_cpx* fftOut = fftOutput_.data();
     float* power = powerSpectrum_.data();
 
-    // Zero the tail of fftInput once (only matters when windowSize < fftLength)
-    if (config_.windowSizeSamples < config_.fftLength) {
-        std::memset(fftIn + config_.windowSizeSamples, 0,
-                    (config_.fftLength - config_.windowSizeSamples) * sizeof(float));
+    // Apply window to frame, zero-padding up to fftLength
+    const int len = std::min(frameLen, config_.windowSizeSamples);
+    for (int i = 0; i < len; ++i) {
+        fftIn[i] = frame[i] * window_[i];
+    }
+    if (len < config_.fftLength) {
+        std::memset(fftIn + len, 0, (config_.fftLength - len) * sizeof(float));
     }
 
-    // Flat contiguous result buffer
-    MelSpectrogramResult result;
-    result.timeSteps = numFrames;
-    result.nMels = config_.nMels;
-    result.data.resize(numFrames * config_.nMels);
-
-    for (int frameIdx = 0; frameIdx < numFrames; ++frameIdx) {
-        const int start = frameIdx * config_.hopLengthSamples;
-
-        // Apply window to frame
-        const int frameLen = std::min(config_.windowSizeSamples, numSamples - start);
-        for (int i = 0; i < frameLen; ++i) {
-            fftIn[i] = samples[start + i] * window_[i];
-        }
-
-        // Compute real FFT
-        kiss_fftr(fftCfg_, fftIn, fftOut);
+    // Compute real FFT
+    kiss_fftr(fftCfg_, fftIn, fftOut);
 
-        // Compute power spectrum (real^2 + imag^2)
-        for (int i = 0; i < numBins; ++i) {
-            power[i] = fftOut[i].r * fftOut[i].r + fftOut[i].i * fftOut[i].i;
-        }
+    // Compute power spectrum (real^2 + imag^2)
+    for (int i = 0; i < numBins; ++i) {
+        power[i] = fftOut[i].r * fftOut[i].r + fftOut[i].i * fftOut[i].i;
+    }
+    return power;
+}
 
-        // Apply sparse mel filterbank
-        float* melRow = result.data.data() + frameIdx * config_.nMels;
-        for (int melIdx = 0; melIdx < config_.nMels; ++melIdx) {
-            const MelFilter& filter = melFilters_[melIdx];
-            const int count = static_cast<int>(filter.weights.size());
-            float sum = 0.0f;
-            const float* w = filter.weights.data();
-            const float* p = power + filter.startBin;
-            for (int k = 0; k < count; ++k) {
-                sum += p[k] * w[k];
-            }
-            melRow[melIdx] = sum;
+void MelSpectrogramProcessor::applyFilterbank(const float* power, float* melOutput) const {
+    for (int melIdx = 0; melIdx < config_.nMels; ++melIdx) {
+        const MelFilter& filter = melFilters_[melIdx];
+        const int count = static_cast<int>(filter.weights.size());
+        float sum = 0.0f;
+        const float* w = filter.weights.data();
+        const float* p = power + filter.startBin;
+        for (int k = 0; k < count; ++k) {
+            sum += p[k] * w[k];
         }
+        melOutput[melIdx] = sum;
     }
+}
+
+void MelSpectrogramProcessor::postProcess(MelSpectrogramResult& result) const {
+    const int total = result.timeSteps * result.nMels;
+    float* d = result.data.data();
 
     // Post-processing: log scaling
     if (config_.logScale) {
-        const int total = numFrames * config_.nMels;
-        float* d = result.data.data();
         for (int i = 0; i < total; ++i) {
             d[i] = std::log(std::max(1e-10f, d[i]));
         }
     }
 
     // Post-processing: normalize
-    if (config_.normalize) {
-        const int total = numFrames * config_.nMels;
-        float* d = result.data.data();
+    if (config_.normalize && total > 0) {
         float minVal = std::numeric_limits<float>::max();
         float maxVal = std::numeric_limits<float>::lowest();
         for (int i = 0; i < total; ++i) {
@@ -187,41 +237,68 @@ MelSpectrogramResult MelSpectrogramProcessor::compute(const float* samples, int
             }
         }
     }
+}
 
-    return result;
+void MelSpectrogramProcessor::encodeOutput(MelSpectrogramResult& result) const {
+    if (result.outputFormat != 0 || config_.outputFormat == 0) {
+        return;
+    }
+    const size_t count = result.data.size();
+    if (config_.outputFormat == 1) {
+        result.dataF16.resize(count);
+        floatToHalfArray(result.data.data(), result.dataF16.data(), count);
+    } else {
+        result.dataU8.resize(count);
+        quantizeToU8Array(result.data.data(), result.dataU8.data(), count,
+                          result.quantScale, result.quantOffset);
+    }
+    result.outputFormat = config_.outputFormat;
+    std::vector<float>().swap(result.data);  // release the float32 copy
 }
 
-void MelSpectrogramProcessor::computeFrame(const float* frame, int frameSize, float* melOutput) {
-    const int numBins = config_.fftLength / 2 + 1;
+void MelSpectrogramProcessor::decodeOutput(MelSpectrogramResult& result) {
+    if (result.outputFormat == 1) {
+        result.data.resize(result.dataF16.size());
+        halfToFloatArray(result.dataF16.data(), result.data.data(), result.dataF16.size());
+        std::vector<uint16_t>().swap(result.dataF16);
+    } else if (result.outputFormat == 2) {
+        result.data.resize(result.dataU8.size());
+        dequantizeU8Array(result.dataU8.data(), result.data.data(), result.dataU8.size(),
+                          result.quantScale, result.quantOffset);
+        std::vector<uint8_t>().swap(result.dataU8);
+    }
+    result.outputFormat = 0;
+}
 
-    // Use pre-allocated buffers
-    float* fftIn = fftInput_.data();
-    kiss_fft_cpx* fftOut = fftOutput_.data();
-    float* power = powerSpectrum_.data();
+MelSpectrogramResult MelSpectrogramProcessor::compute(const float* samples, int numSamples) {
+    const int frames = numFrames(numSamples);
 
-    // Zero and apply window
-    std::memset(fftIn, 0, config_.fftLength * sizeof(float));
-    int len = std::min(frameSize, config_.windowSizeSamples);
-    for (int i = 0; i < len; ++i) {
-        fftIn[i] = frame[i] * window_[i];
+    if (frames <= 0) {
+        MelSpectrogramResult empty{{}, 0, config_.nMels};
+        empty.outputFormat = config_.outputFormat;
+        return empty;
     }
 
-    kiss_fftr(fftCfg_, fftIn, fftOut);
+    // Flat contiguous result buffer
+    MelSpectrogramResult result;
+    result.timeSteps = frames;
+    result.nMels = config_.nMels;
+    result.data.resize(frames * config_.nMels);
 
-    // Power spectrum -> sparse mel filterbank
-    for (int i = 0; i < numBins; ++i) {
-        power[i] = fftOut[i].r * fftOut[i].r + fftOut[i].i * fftOut[i].i;
+    for (int frameIdx = 0; frameIdx < frames; ++frameIdx) {
+        int frameLen = 0;
+        const float* frame = frameAt(samples, numSamples, frameIdx, frameLen);
+        const float* power = computePowerSpectrum(frame, frameLen);
+        applyFilterbank(power, result.data.data() + frameIdx * config_.nMels);
     }
 
-    for (int melIdx = 0; melIdx < config_.nMels; ++melIdx) {
-        const MelFilter& filter = melFilters_[melIdx];
-        const int count = static_cast<int>(filter.weights.size());
-        float sum = 0.0f;
-        const float* w = filter.weights.data();
-        const float* p = power + filter.startBin;
-        for (int k = 0; k < count; ++k) {
-            sum += p[k] * w[k];
-        }
-        melOutput[melIdx] = sum;
-    }
+    postProcess(result);
+    encodeOutput(result);
+    return result;
+}
+
+void MelSpectrogramProcessor::computeFrame(const float* frame, int frameSize, float* melOutput) {
+    // Power spectrum -> sparse mel filterbank
+    const float* power = computePowerSpectrum(frame, frameSize);
+    applyFilterbank(power, melOutput);
 }
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <cmath>
+#include <cstdint>
 #include "kiss_fft/kiss_fft.h"
 #include "kiss_fft/kiss_fftr.h"
 
@@ -16,6 +17,11 @@ struct MelSpectrogramConfig {
     int windowType = 0; // 0=hann, 1=hamming
     bool logScale = true;
     bool normalize = false;
+    // Center padding (librosa/Whisper center=True): windowSizeSamples/2 virtual
+    // samples on each side, read through mirrored/clamped indices, never copied.
+    int paddingMode = 0; // 0=none, 1=zero, 2=reflect, 3=edge
+    // Storage of the result, converted as the last stage of compute()
+    int outputFormat = 0; // 0=float32, 1=float16, 2=uint8 (per-result scale/offset)
 
     bool operator==(const MelSpectrogramConfig& other) const {
         return sampleRate == other.sampleRate &&
@@ -27,7 +33,9 @@ struct MelSpectrogramConfig {
                fMax == other.fMax &&
                windowType == other.windowType &&
                logScale == other.logScale &&
-               normalize == other.normalize;
+               normalize == other.normalize &&
+               paddingMode == other.paddingMode &&
+               outputFormat == other.outputFormat;
     }
 };
 
@@ -36,7 +44,15 @@ struct MelSpectrogramResult {
     int timeSteps;
     int nMels;
 
-    // Access element at [frame][mel]
+    // Set when outputFormat != 0: `data` is released and the values live in one
+    // of the buffers below, same layout. uint8 decodes as quantOffset + q * quantScale.
+    int outputFormat = 0;
+    std::vector<uint16_t> dataF16{};
+    std::vector<uint8_t> dataU8{};
+    float quantScale = 1.0f;
+    float quantOffset = 0.0f;
+
+    // Access element at [frame][mel] (float32 output only)
     float& at(int frame, int mel) { return data[frame * nMels + mel]; }
     float at(int frame, int mel) const { return data[frame * nMels + mel]; }
 };
@@ -50,9 +66,27 @@ public:
     MelSpectrogramProcessor(const MelSpectrogramProcessor&) = delete;
     MelSpectrogramProcessor& operator=(const MelSpectrogramProcessor&) = delete;
 
+    // config with invalid values replaced by the defaults the processor runs with
+    static MelSpectrogramConfig normalizedConfig(const MelSpectrogramConfig& config);
+
     MelSpectrogramResult compute(const float* samples, int numSamples);
     void computeFrame(const float* frame, int frameSize, float* melOutput);
 
+    // Building blocks of compute(), exposed so several processors can share one FFT.
+    // computePowerSpectrum windows + transforms a frame into the internal power buffer
+    // (valid until the next call); applyFilterbank maps any power spectrum of
+    // fftLength/2+1 bins through this processor's sparse mel filterbank.
+    const float* computePowerSpectrum(const float* frame, int frameLen);
+    void applyFilterbank(const float* power, float* melOutput) const;
+    void postProcess(MelSpectrogramResult& result) const;
+    // Converts `data` to config.outputFormat; decodeOutput turns any result back into float32.
+    void encodeOutput(MelSpectrogramResult& result) const;
+    static void decodeOutput(MelSpectrogramResult& result);
+    int numFrames(int numSamples) const;
+    // Samples of frame frameIdx: a pointer into `samples` for interior frames, or the
+    // internal edge buffer (valid until the next call) for frames overlapping the padding.
+    const float* frameAt(const float* samples, int numSamples, int frameIdx, int& frameLen);
+
     const MelSpectrogramConfig& config() const { return config_; }
 
 private:
@@ -72,6 +106,7 @@ private:
     std::vector<float> fftInput_;
     std::vector<kiss_fft_cpx> fftOutput_;
     std::vector<float> powerSpectrum_;
+    std::vector<float> edgeFrame_;  // one window, only for frames touching the padding
 
     void buildMelFilterbank();
     void buildWindow();
@@ -12,13 +12,9 @@
 static std::unique_ptr<MelSpectrogramProcessor> cachedProcessor;
 static std::mutex cachedMutex;
 
-extern "C" {
-
-CMelSpectrogramResult* mel_spectrogram_compute(
-    const float* samples, int numSamples, int sampleRate,
-    int fftLength, int windowSizeSamples, int hopLengthSamples,
-    int nMels, float fMin, float fMax,
-    int windowType, int logScale, int normalize)
+static MelSpectrogramConfig makeConfig(int sampleRate, int fftLength, int windowSizeSamples,
+    int hopLengthSamples, int nMels, float fMin, float fMax, int windowType,
+    int logScale, int normalize, int paddingMode, int outputFormat)
 {
     MelSpectrogramConfig config;
     config.sampleRate = sampleRate;
@@ -31,14 +27,44 @@ CMelSpectrogramResult* mel_spectrogram_compute(
     config.windowType = windowType;
     config.logScale = (logScale != 0);
     config.normalize = (normalize != 0);
+    config.paddingMode = paddingMode;
+    config.outputFormat = outputFormat;
+    return config;
+}
 
+static MelSpectrogramResult computeCached(const MelSpectrogramConfig& config,
+    const float* samples, int numSamples)
+{
     // Reuse processor if config matches
     std::lock_guard<std::mutex> lock(cachedMutex);
     if (!cachedProcessor || !(cachedProcessor->config() == config)) {
         cachedProcessor = std::make_unique<MelSpectrogramProcessor>(config);
     }
+    return cachedProcessor->compute(samples, numSamples);
+}
+
+extern "C" {
 
-    MelSpectrogramResult result = cachedProcessor->compute(samples, numSamples);
+CMelSpectrogramResult* mel_spectrogram_compute(
+    const float* samples, int numSamples, int sampleRate,
+    int fftLength, int windowSizeSamples, int hopLengthSamples,
+    int nMels, float fMin, float fMax,
+    int windowType, int logScale, int normalize)
+{
+    return mel_spectrogram_compute_padded(samples, numSamples, sampleRate,
+        fftLength, windowSizeSamples, hopLengthSamples, nMels, fMin, fMax,
+        windowType, logScale, normalize, 0);
+}
+
+CMelSpectrogramResult* mel_spectrogram_compute_padded(
+    const float* samples, int numSamples, int sampleRate,
+    int fftLength, int windowSizeSamples, int hopLengthSamples,
+    int nMels, float fMin, float fMax,
+    int windowType, int logScale, int normalize, int paddingMode)
+{
+    MelSpectrogramResult result = computeCached(makeConfig(sampleRate, fftLength,
+        windowSizeSamples, hopLengthSamples, nMels, fMin, fMax, windowType,
+        logScale, normalize, paddingMode, 0), samples, numSamples);
 
     if (result.timeSteps <= 0) {
         return nullptr;
@@ -57,6 +83,52 @@ CMelSpectrogramResult* mel_spectrogram_compute(
     return cResult;
 }
 
+CMelSpectrogramEncodedResult* mel_spectrogram_compute_encoded(
+    const float* samples, int numSamples, int sampleRate,
+    int fftLength, int windowSizeSamples, int hopLengthSamples,
+    int nMels, float fMin, float fMax,
+    int windowType, int logScale, int normalize, int paddingMode, int outputFormat)
+{
+    MelSpectrogramResult result = computeCached(makeConfig(sampleRate, fftLength,
+        windowSizeSamples, hopLengthSamples, nMels, fMin, fMax, windowType,
+        logScale, normalize, paddingMode, outputFormat), samples, numSamples);
+
+    if (result.timeSteps <= 0) {
+        return nullptr;
+    }
+
+    const void* src = result.data.data();
+    size_t dataSize = result.data.size() * sizeof(float);
+    if (result.outputFormat == 1) {
+        src = result.dataF16.data();
+        dataSize = result.dataF16.size() * sizeof(uint16_t);
+    } else if (result.outputFormat == 2) {
+        src = result.dataU8.data();
+        dataSize = result.dataU8.size();
+    }
+
+    CMelSpectrogramEncodedResult* cResult =
+        (CMelSpectrogramEncodedResult*)malloc(sizeof(CMelSpectrogramEncodedResult));
+    if (!cResult) return nullptr;
+    cResult->timeSteps = result.timeSteps;
+    cResult->nMels = result.nMels;
+    cResult->outputFormat = result.outputFormat;
+    cResult->scale = result.quantScale;
+    cResult->offset = result.quantOffset;
+    cResult->data = malloc(dataSize);
+    if (!cResult->data) { free(cResult); return nullptr; }
+    std::memcpy(cResult->data, src, dataSize);
+
+    return cResult;
+}
+
+void mel_spectrogram_free_encoded(CMelSpectrogramEncodedResult* result) {
+    if (result) {
+        free(result->data);
+        free(result);
+    }
+}
+
 void mel_spectrogram_free(CMelSpectrogramResult* result) {
     if (result) {
         if (result->data) {
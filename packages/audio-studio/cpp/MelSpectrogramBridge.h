@@ -11,14 +11,41 @@ typedef struct {
     int nMels;
 } CMelSpectrogramResult;
 
+typedef struct {
+    void* data;        // Flat array: timeSteps * nMels values of outputFormat
+    int timeSteps;
+    int nMels;
+    int outputFormat;  // 0=float32, 1=float16 (IEEE half bits), 2=uint8
+    float scale;       // uint8 only: value = offset + q * scale
+    float offset;
+} CMelSpectrogramEncodedResult;
+
 CMelSpectrogramResult* mel_spectrogram_compute(
     const float* samples, int numSamples, int sampleRate,
     int fftLength, int windowSizeSamples, int hopLengthSamples,
     int nMels, float fMin, float fMax,
     int windowType, int logScale, int normalize);
 
+// Same as mel_spectrogram_compute with center padding of windowSizeSamples/2 on
+// each side (paddingMode: 0=none, 1=zero, 2=reflect, 3=edge), e.g. 2 for Whisper.
+CMelSpectrogramResult* mel_spectrogram_compute_padded(
+    const float* samples, int numSamples, int sampleRate,
+    int fftLength, int windowSizeSamples, int hopLengthSamples,
+    int nMels, float fMin, float fMax,
+    int windowType, int logScale, int normalize, int paddingMode);
+
 void mel_spectrogram_free(CMelSpectrogramResult* result);
 
+// Padded compute with a compact output format, 2x (float16) or 4x (uint8) smaller
+// to hold and to copy across the bridge.
+CMelSpectrogramEncodedResult* mel_spectrogram_compute_encoded(
+    const float* samples, int numSamples, int sampleRate,
+    int fftLength, int windowSizeSamples, int hopLengthSamples,
+    int nMels, float fMin, float fMax,
+    int windowType, int logScale, int normalize, int paddingMode, int outputFormat);
+
+void mel_spectrogram_free_encoded(CMelSpectrogramEncodedResult* result);
+
 // Single-frame API for live/per-segment mel computation
 void mel_spectrogram_init(int sampleRate, int fftLength, int windowSizeSamples,
     int hopLengthSamples, int nMels, float fMin, float fMax, int windowType);
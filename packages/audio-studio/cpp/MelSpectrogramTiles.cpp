@@ -0,0 +1,155 @@
+#include "MelSpectrogramTiles.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+MelSpectrogramTiles::MelSpectrogramTiles(const MelSpectrogramConfig& config,
+                                         const float* samples, int numSamples,
+                                         int tileFrames, size_t maxTiles)
+    : processor_(config),
+      samples_(samples),
+      numSamples_(samples ? std::max(0, numSamples) : 0),
+      tileFrames_(tileFrames > 0 ? tileFrames : 256),
+      maxTiles_(maxTiles > 0 ? maxTiles : 64) {
+    baseFrames_ = std::max(0, processor_.numFrames(numSamples_));
+}
+
+int MelSpectrogramTiles::rowCount(int level) const {
+    if (level <= 0) return baseFrames_;
+    const int64_t span = int64_t{1} << std::min(level, 30);
+    return static_cast<int>((baseFrames_ + span - 1) / span);
+}
+
+int MelSpectrogramTiles::maxLevel() const {
+    // Highest level at which the whole signal fits in a single tile
+    int level = 0;
+    while (rowCount(level) > tileFrames_) {
+        ++level;
+    }
+    return level;
+}
+
+void MelSpectrogramTiles::clear() {
+    lru_.clear();
+    index_.clear();
+}
+
+MelSpectrogramResult MelSpectrogramTiles::getTimeRange(float startSec, float endSec, int level) {
+    const float framesPerSec = static_cast<float>(config().sampleRate) / config().hopLengthSamples;
+    const float rowsPerSec = framesPerSec / static_cast<float>(int64_t{1} << std::max(0, std::min(level, 30)));
+    const int startRow = static_cast<int>(std::floor(startSec * rowsPerSec));
+    const int endRow = static_cast<int>(std::ceil(endSec * rowsPerSec));
+    return getRange(startRow, endRow, level);
+}
+
+MelSpectrogramResult MelSpectrogramTiles::getRange(int startRow, int endRow, int level) {
+    const int nMels = config().nMels;
+    level = std::max(0, level);
+    startRow = std::max(0, startRow);
+    endRow = std::min(endRow, rowCount(level));
+
+    MelSpectrogramResult result{{}, 0, nMels};
+    if (endRow <= startRow) {
+        return result;
+    }
+
+    result.timeSteps = endRow - startRow;
+    result.data.resize(static_cast<size_t>(result.timeSteps) * nMels);
+
+    const int firstTile = startRow / tileFrames_;
+    const int lastTile = (endRow - 1) / tileFrames_;
+    for (int t = firstTile; t <= lastTile; ++t) {
+        TilePtr tile = getTile(level, t);
+        const int tileStart = t * tileFrames_;
+        const int from = std::max(startRow, tileStart);
+        const int to = std::min(endRow, tileStart + tile->rows);
+        if (to <= from) continue;
+        std::memcpy(result.data.data() + static_cast<size_t>(from - startRow) * nMels,
+                    tile->data.data() + static_cast<size_t>(from - tileStart) * nMels,
+                    static_cast<size_t>(to - from) * nMels * sizeof(float));
+    }
+    return result;
+}
+
+MelSpectrogramTiles::TilePtr MelSpectrogramTiles::getTile(int level, int tileIndex) {
+    const uint64_t key = tileKey(level, tileIndex);
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+        // Move to front (most recently used)
+        lru_.splice(lru_.begin(), lru_, found->second);
+        return found->second->second;
+    }
+
+    TilePtr tile = (level == 0) ? computeBaseTile(tileIndex) : poolTile(level, tileIndex);
+
+    lru_.emplace_front(key, tile);
+    index_[key] = lru_.begin();
+    while (lru_.size() > maxTiles_) {
+        index_.erase(lru_.back().first);
+        lru_.pop_back();
+    }
+    return tile;
+}
+
+MelSpectrogramTiles::TilePtr MelSpectrogramTiles::computeBaseTile(int tileIndex) {
+    const MelSpectrogramConfig& cfg = config();
+    const int firstFrame = tileIndex * tileFrames_;
+    const int rows = std::max(0, std::min(tileFrames_, baseFrames_ - firstFrame));
+
+    auto tile = std::make_shared<Tile>();
+    tile->rows = rows;
+    tile->data.resize(static_cast<size_t>(rows) * cfg.nMels);
+
+    for (int r = 0; r < rows; ++r) {
+        int frameLen = 0;
+        const float* frame = processor_.frameAt(samples_, numSamples_, firstFrame + r, frameLen);
+        float* melRow = tile->data.data() + static_cast<size_t>(r) * cfg.nMels;
+        processor_.applyFilterbank(processor_.computePowerSpectrum(frame, frameLen), melRow);
+        if (cfg.logScale) {
+            for (int m = 0; m < cfg.nMels; ++m) {
+                melRow[m] = std::log(std::max(1e-10f, melRow[m]));
+            }
+        }
+    }
+    return tile;
+}
+
+MelSpectrogramTiles::TilePtr MelSpectrogramTiles::poolTile(int level, int tileIndex) {
+    const int nMels = config().nMels;
+    const int firstRow = tileIndex * tileFrames_;
+    const int rows = std::max(0, std::min(tileFrames_, rowCount(level) - firstRow));
+
+    auto tile = std::make_shared<Tile>();
+    tile->rows = rows;
+    tile->data.resize(static_cast<size_t>(rows) * nMels);
+
+    // Rows [firstRow, firstRow + rows) at this level come from child rows
+    // [2 * firstRow, 2 * (firstRow + rows)), i.e. child tiles 2i and 2i+1.
+    // log() is monotonic, so pooling log-scaled rows equals log of pooled power.
+    const int childRows = rowCount(level - 1);
+    TilePtr children[2] = {nullptr, nullptr};
+    for (int r = 0; r < rows; ++r) {
+        float* out = tile->data.data() + static_cast<size_t>(r) * nMels;
+        const int childRow = 2 * (firstRow + r);
+        for (int k = 0; k < 2; ++k) {
+            const int row = childRow + k;
+            if (row >= childRows) break;
+            const int childTile = row / tileFrames_;
+            const int slot = childTile - 2 * tileIndex;
+            if (!children[slot]) {
+                children[slot] = getTile(level - 1, childTile);
+            }
+            const float* in = children[slot]->data.data() +
+                              static_cast<size_t>(row - childTile * tileFrames_) * nMels;
+            if (k == 0) {
+                std::memcpy(out, in, nMels * sizeof(float));
+            } else {
+                for (int m = 0; m < nMels; ++m) {
+                    out[m] = std::max(out[m], in[m]);
+                }
+            }
+        }
+    }
+    return tile;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "MelSpectrogram.h"
+
+// Lazily computed, tiled mel spectrogram for zoomable views of long recordings.
+//
+// Level 0 holds one row per hop (same framing as MelSpectrogramProcessor::compute).
+// Each level above halves the time resolution: a row at level L is the element-wise
+// max of two rows at level L-1. Only the tiles that intersect a requested range are
+// computed; zoomed-out tiles are max-pooled from their two children, so the cost of
+// the first paint is proportional to the visible window, not the recording length.
+//
+// The sample buffer is NOT copied; it must outlive the engine (e.g. a decoded buffer
+// owned by the recording or a memory-mapped WAV). config.normalize is ignored because
+// a global min/max is not known until every frame has been computed.
+//
+// Not part of the app targets yet (Android CMake, iOS MelSpectrogramWrapper.mm):
+// add MelSpectrogramTiles.cpp there together with the bridge entry points that use it.
+class MelSpectrogramTiles {
+public:
+    MelSpectrogramTiles(const MelSpectrogramConfig& config,
+                        const float* samples, int numSamples,
+                        int tileFrames = 256, size_t maxTiles = 64);
+
+    // Non-copyable (owns FFT plan through its processor)
+    MelSpectrogramTiles(const MelSpectrogramTiles&) = delete;
+    MelSpectrogramTiles& operator=(const MelSpectrogramTiles&) = delete;
+
+    // Rows [startRow, endRow) at the given zoom level, clamped to the signal.
+    MelSpectrogramResult getRange(int startRow, int endRow, int level);
+    // Same, addressed in seconds; the level is chosen by the caller from its zoom.
+    MelSpectrogramResult getTimeRange(float startSec, float endSec, int level);
+
+    int rowCount(int level) const;
+    int maxLevel() const;
+    size_t cachedTileCount() const { return lru_.size(); }
+    void clear();
+
+    const MelSpectrogramConfig& config() const { return processor_.config(); }
+
+private:
+    struct Tile {
+        int rows;
+        std::vector<float> data;  // [rows * nMels], row-major
+    };
+    using TilePtr = std::shared_ptr<const Tile>;
+    using LruList = std::list<std::pair<uint64_t, TilePtr>>;
+
+    MelSpectrogramProcessor processor_;
+    const float* samples_;
+    int numSamples_;
+    int tileFrames_;
+    size_t maxTiles_;
+    int baseFrames_;
+
+    // Most recently used tile at the front
+    LruList lru_;
+    std::unordered_map<uint64_t, LruList::iterator> index_;
+
+    TilePtr getTile(int level, int tileIndex);
+    TilePtr computeBaseTile(int tileIndex);
+    TilePtr poolTile(int level, int tileIndex);
+
+    static uint64_t tileKey(int level, int tileIndex) {
+        return (static_cast<uint64_t>(level) << 32) | static_cast<uint32_t>(tileIndex);
+    }
+};
@@ -0,0 +1,83 @@
+#include "MultiMelSpectrogram.h"
+
+#include <algorithm>
+#include <limits>
+
+MultiMelProcessor::MultiMelProcessor(const std::vector<MelSpectrogramConfig>& configs) {
+    processors_.reserve(configs.size());
+    for (size_t i = 0; i < configs.size(); ++i) {
+        processors_.push_back(std::make_unique<MelSpectrogramProcessor>(configs[i]));
+
+        // Group on the clamped config so defaults resolve to the same key
+        const MelSpectrogramConfig& c = processors_.back()->config();
+        auto it = std::find_if(groups_.begin(), groups_.end(), [&c](const FftGroup& g) {
+            return g.fftLength == c.fftLength &&
+                   g.windowSizeSamples == c.windowSizeSamples &&
+                   g.hopLengthSamples == c.hopLengthSamples &&
+                   g.windowType == c.windowType &&
+                   g.paddingMode == c.paddingMode;
+        });
+        if (it == groups_.end()) {
+            groups_.push_back(FftGroup{c.fftLength, c.windowSizeSamples,
+                                       c.hopLengthSamples, c.windowType,
+                                       c.paddingMode, {i}});
+        } else {
+            it->members.push_back(i);
+        }
+    }
+}
+
+std::vector<MelSpectrogramResult> MultiMelProcessor::compute(const float* samples, int numSamples) {
+    std::vector<MelSpectrogramResult> results(processors_.size());
+    std::vector<int> groupFrames(groups_.size(), 0);
+    std::vector<int> nextFrame(groups_.size(), 0);
+
+    for (size_t g = 0; g < groups_.size(); ++g) {
+        MelSpectrogramProcessor& fft = *processors_[groups_[g].members[0]];
+        // Input shorter than the window leaves the frame formula negative (10 samples,
+        // window 400, hop 100 -> -2); such groups get an empty result instead.
+        const int frames = (samples && numSamples >= 0)
+            ? std::max(0, fft.numFrames(numSamples)) : 0;
+        groupFrames[g] = frames;
+        for (size_t idx : groups_[g].members) {
+            const int nMels = processors_[idx]->config().nMels;
+            results[idx].timeSteps = frames;
+            results[idx].nMels = nMels;
+            results[idx].data.resize(static_cast<size_t>(frames) * nMels);
+        }
+    }
+
+    // Walk the signal once: always advance the group whose next frame starts earliest,
+    // so all groups read the same region of the input while it is still in cache.
+    while (true) {
+        size_t group = groups_.size();
+        int earliestStart = std::numeric_limits<int>::max();
+        for (size_t g = 0; g < groups_.size(); ++g) {
+            if (nextFrame[g] >= groupFrames[g]) continue;
+            const int start = nextFrame[g] * groups_[g].hopLengthSamples;
+            if (start < earliestStart) {
+                earliestStart = start;
+                group = g;
+            }
+        }
+        if (group == groups_.size()) break;
+
+        const FftGroup& g = groups_[group];
+        const int frameIdx = nextFrame[group]++;
+        MelSpectrogramProcessor& fft = *processors_[g.members[0]];
+
+        int frameLen = 0;
+        const float* frame = fft.frameAt(samples, numSamples, frameIdx, frameLen);
+        const float* power = fft.computePowerSpectrum(frame, frameLen);
+        for (size_t idx : g.members) {
+            MelSpectrogramResult& r = results[idx];
+            processors_[idx]->applyFilterbank(power, r.data.data() + frameIdx * r.nMels);
+        }
+    }
+
+    for (size_t i = 0; i < processors_.size(); ++i) {
+        processors_[i]->postProcess(results[i]);
+        processors_[i]->encodeOutput(results[i]);
+    }
+    return results;
+}
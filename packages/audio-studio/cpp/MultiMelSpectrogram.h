@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "MelSpectrogram.h"
+
+// Computes several mel spectrograms over the same samples in a single pass.
+//
+// Configs that frame the signal identically (fftLength, windowSizeSamples,
+// hopLengthSamples, windowType, paddingMode) share one FFT per frame; every filterbank in
+// the group is applied to that shared power spectrum. Groups with different
+// hops are interleaved in sample order so the input is traversed once.
+// All configs are expected to describe the same signal, i.e. share sampleRate.
+class MultiMelProcessor {
+public:
+    explicit MultiMelProcessor(const std::vector<MelSpectrogramConfig>& configs);
+
+    // Non-copyable (owns FFT plans through its processors)
+    MultiMelProcessor(const MultiMelProcessor&) = delete;
+    MultiMelProcessor& operator=(const MultiMelProcessor&) = delete;
+
+    // One result per config, in the order the configs were given.
+    std::vector<MelSpectrogramResult> compute(const float* samples, int numSamples);
+
+    size_t size() const { return processors_.size(); }
+    size_t fftGroupCount() const { return groups_.size(); }
+    const MelSpectrogramConfig& config(size_t index) const { return processors_[index]->config(); }
+
+private:
+    struct FftGroup {
+        int fftLength;
+        int windowSizeSamples;
+        int hopLengthSamples;
+        int windowType;
+        int paddingMode;
+        std::vector<size_t> members;  // indices into processors_; members[0] runs the FFT
+    };
+
+    std::vector<std::unique_ptr<MelSpectrogramProcessor>> processors_;
+    std::vector<FftGroup> groups_;
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Linear 8-bit quantization with one scale/offset per array:
+//   value ~= offset + q * scale, q in [0, 255]
+// offset is the array minimum and scale spans [min, max] over 255 steps, so the
+// round-trip error is at most scale / 2.
+
+inline void minMaxArray(const float* in, size_t count, float& minOut, float& maxOut) {
+    if (count == 0) {
+        minOut = maxOut = 0.0f;
+        return;
+    }
+    size_t i = 0;
+    float lo = in[0];
+    float hi = in[0];
+#if defined(__aarch64__)
+    if (count >= 4) {
+        float32x4_t vlo = vld1q_f32(in);
+        float32x4_t vhi = vlo;
+        for (i = 4; i + 4 <= count; i += 4) {
+            const float32x4_t v = vld1q_f32(in + i);
+            vlo = vminq_f32(vlo, v);
+            vhi = vmaxq_f32(vhi, v);
+        }
+        lo = vminvq_f32(vlo);
+        hi = vmaxvq_f32(vhi);
+    }
+#elif defined(__SSE2__)
+    if (count >= 4) {
+        __m128 vlo = _mm_loadu_ps(in);
+        __m128 vhi = vlo;
+        for (i = 4; i + 4 <= count; i += 4) {
+            const __m128 v = _mm_loadu_ps(in + i);
+            vlo = _mm_min_ps(vlo, v);
+            vhi = _mm_max_ps(vhi, v);
+        }
+        float l[4], h[4];
+        _mm_storeu_ps(l, vlo);
+        _mm_storeu_ps(h, vhi);
+        lo = std::min(std::min(l[0], l[1]), std::min(l[2], l[3]));
+        hi = std::max(std::max(h[0], h[1]), std::max(h[2], h[3]));
+    }
+#endif
+    for (; i < count; ++i) {
+        lo = std::min(lo, in[i]);
+        hi = std::max(hi, in[i]);
+    }
+    minOut = lo;
+    maxOut = hi;
+}
+
+// Computes scale/offset from the data and writes one byte per value.
+inline void quantizeToU8Array(const float* in, uint8_t* out, size_t count, float& scale, float& offset) {
+    float lo, hi;
+    minMaxArray(in, count, lo, hi);
+    offset = lo;
+    scale = (hi > lo) ? (hi - lo) / 255.0f : 1.0f;
+    const float inv = 1.0f / scale;
+
+    // q = trunc(clamp((x - offset) * inv, 0, 255) + 0.5), identical on every path
+    size_t i = 0;
+#if defined(__aarch64__)
+    const float32x4_t vOff = vdupq_n_f32(offset);
+    const float32x4_t vInv = vdupq_n_f32(inv);
+    const float32x4_t vZero = vdupq_n_f32(0.0f);
+    const float32x4_t vMax = vdupq_n_f32(255.0f);
+    const float32x4_t vHalf = vdupq_n_f32(0.5f);
+    for (; i + 8 <= count; i += 8) {
+        float32x4_t a = vmulq_f32(vsubq_f32(vld1q_f32(in + i), vOff), vInv);
+        float32x4_t b = vmulq_f32(vsubq_f32(vld1q_f32(in + i + 4), vOff), vInv);
+        a = vaddq_f32(vminq_f32(vmaxq_f32(a, vZero), vMax), vHalf);
+        b = vaddq_f32(vminq_f32(vmaxq_f32(b, vZero), vMax), vHalf);
+        const uint16x8_t w = vcombine_u16(vmovn_u32(vcvtq_u32_f32(a)), vmovn_u32(vcvtq_u32_f32(b)));
+        vst1_u8(out + i, vmovn_u16(w));
+    }
+#elif defined(__SSE2__)
+    const __m128 vOff = _mm_set1_ps(offset);
+    const __m128 vInv = _mm_set1_ps(inv);
+    const __m128 vZero = _mm_setzero_ps();
+    const __m128 vMax = _mm_set1_ps(255.0f);
+    const __m128 vHalf = _mm_set1_ps(0.5f);
+    for (; i + 16 <= count; i += 16) {
+        __m128i q[4];
+        for (int k = 0; k < 4; ++k) {
+            __m128 v = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(in + i + 4 * k), vOff), vInv);
+            v = _mm_add_ps(_mm_min_ps(_mm_max_ps(v, vZero), vMax), vHalf);
+            q[k] = _mm_cvttps_epi32(v);
+        }
+        const __m128i lo16 = _mm_packs_epi32(q[0], q[1]);
+        const __m128i hi16 = _mm_packs_epi32(q[2], q[3]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(lo16, hi16));
+    }
+#endif
+    for (; i < count; ++i) {
+        const float v = std::min(std::max((in[i] - offset) * inv, 0.0f), 255.0f);
+        out[i] = static_cast<uint8_t>(v + 0.5f);
+    }
+}
+
+inline void dequantizeU8Array(const uint8_t* in, float* out, size_t count, float scale, float offset) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = offset + static_cast<float>(in[i]) * scale;
+    }
+}
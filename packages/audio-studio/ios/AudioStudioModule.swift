@@ -729,6 +729,7 @@ public class AudioStudioModule: Module, AudioStreamManagerDelegate, AudioDeviceM
                 let windowType = options["windowType"] as? String ?? "hann"
                 let logScale = options["logScale"] as? Bool ?? true
                 let normalize = options["normalize"] as? Bool ?? false
+                let outputFormat = options["outputFormat"] as? String ?? "float32"
                 let startTimeMs = options["startTimeMs"] as? Double
                 let endTimeMs = options["endTimeMs"] as? Double
 
@@ -759,6 +760,43 @@ public class AudioStudioModule: Module, AudioStreamManagerDelegate, AudioDeviceM
 
                 let windowTypeInt: Int32 = windowType.lowercased() == "hamming" ? 1 : 0
 
+                // Compact formats cross the bridge as one base64 payload instead of nested arrays
+                let outputFormatCode: Int32 = outputFormat == "float16" ? 1 : outputFormat == "uint8" ? 2 : 0
+                if outputFormatCode != 0 {
+                    guard let encoded = samples.withUnsafeBufferPointer({ bufferPtr -> [AnyHashable: Any]? in
+                        guard let baseAddress = bufferPtr.baseAddress else { return nil }
+                        return MelSpectrogramWrapper.computeEncoded(
+                            withSamples: baseAddress,
+                            numSamples: Int32(samples.count),
+                            sampleRate: Int32(sampleRate),
+                            fftLength: 2048,
+                            windowSizeSamples: Int32(windowSizeSamples),
+                            hopLengthSamples: Int32(hopLengthSamples),
+                            nMels: Int32(nMels),
+                            fMin: fMin,
+                            fMax: fMax,
+                            windowType: windowTypeInt,
+                            logScale: logScale,
+                            normalize: normalize,
+                            outputFormat: outputFormatCode
+                        )
+                    }) else {
+                        throw NSError(domain: "AudioStudio", code: -1, userInfo: [NSLocalizedDescriptionKey: "Audio data is too short for spectrogram analysis"])
+                    }
+
+                    promise.resolve([
+                        "encodedSpectrogram": (encoded["data"] as! Data).base64EncodedString(),
+                        "outputFormat": outputFormat,
+                        "quantScale": encoded["quantScale"]!,
+                        "quantOffset": encoded["quantOffset"]!,
+                        "sampleRate": sampleRate,
+                        "nMels": nMels,
+                        "timeSteps": encoded["timeSteps"] as! Int,
+                        "durationMs": Double(samples.count) / Double(sampleRate) * 1000.0
+                    ])
+                    return
+                }
+
                 // Call shared C++ implementation via ObjC++ wrapper
                 guard let result = samples.withUnsafeBufferPointer({ bufferPtr -> [AnyHashable: Any]? in
                     guard let baseAddress = bufferPtr.baseAddress else { return nil }
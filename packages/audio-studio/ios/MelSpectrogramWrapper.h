@@ -15,6 +15,23 @@
                                      logScale:(BOOL)logScale
                                     normalize:(BOOL)normalize;
 
+// Compact variant for the bridge (outputFormat: 1=float16, 2=uint8): "data" holds
+// timeSteps * nMels little-endian values, row-major; uint8 decodes as
+// quantOffset + q * quantScale.
++ (nullable NSDictionary *)computeEncodedWithSamples:(const float *)samples
+                                          numSamples:(int)numSamples
+                                          sampleRate:(int)sampleRate
+                                           fftLength:(int)fftLength
+                                   windowSizeSamples:(int)windowSizeSamples
+                                    hopLengthSamples:(int)hopLengthSamples
+                                               nMels:(int)nMels
+                                                fMin:(float)fMin
+                                                fMax:(float)fMax
+                                          windowType:(int)windowType
+                                            logScale:(BOOL)logScale
+                                           normalize:(BOOL)normalize
+                                        outputFormat:(int)outputFormat;
+
 + (void)initWithSampleRate:(int)sampleRate
                  fftLength:(int)fftLength
          windowSizeSamples:(int)windowSizeSamples
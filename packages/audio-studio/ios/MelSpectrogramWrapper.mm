@@ -6,6 +6,7 @@
 #include "kiss_fft/kiss_fftr.c"
 #include "MelSpectrogram.cpp"
 #include "MelSpectrogramBridge.cpp"
+#include "MultiMelSpectrogram.cpp"
 
 @implementation MelSpectrogramWrapper
 
@@ -53,6 +54,50 @@
     return dict;
 }
 
++ (nullable NSDictionary *)computeEncodedWithSamples:(const float *)samples
+                                          numSamples:(int)numSamples
+                                          sampleRate:(int)sampleRate
+                                           fftLength:(int)fftLength
+                                   windowSizeSamples:(int)windowSizeSamples
+                                    hopLengthSamples:(int)hopLengthSamples
+                                               nMels:(int)nMels
+                                                fMin:(float)fMin
+                                                fMax:(float)fMax
+                                          windowType:(int)windowType
+                                            logScale:(BOOL)logScale
+                                           normalize:(BOOL)normalize
+                                        outputFormat:(int)outputFormat
+{
+    CMelSpectrogramEncodedResult* result = mel_spectrogram_compute_encoded(
+        samples, numSamples, sampleRate,
+        fftLength, windowSizeSamples, hopLengthSamples,
+        nMels, fMin, fMax,
+        windowType, logScale ? 1 : 0, normalize ? 1 : 0,
+        0, outputFormat);
+
+    if (!result) {
+        return nil;
+    }
+
+    size_t bytesPerValue = result->outputFormat == 1 ? sizeof(uint16_t)
+                         : result->outputFormat == 2 ? sizeof(uint8_t)
+                         : sizeof(float);
+    size_t byteLength = (size_t)result->timeSteps * result->nMels * bytesPerValue;
+
+    NSDictionary *dict = @{
+        @"data": [NSData dataWithBytes:result->data length:byteLength],
+        @"outputFormat": @(result->outputFormat),
+        @"timeSteps": @(result->timeSteps),
+        @"nMels": @(result->nMels),
+        @"quantScale": @(result->scale),
+        @"quantOffset": @(result->offset)
+    };
+
+    mel_spectrogram_free_encoded(result);
+
+    return dict;
+}
+
 + (void)initWithSampleRate:(int)sampleRate
                  fftLength:(int)fftLength
          windowSizeSamples:(int)windowSizeSamples
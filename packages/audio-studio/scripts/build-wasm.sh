@@ -32,7 +32,7 @@ emcc \
   -O2 \
   -s MODULARIZE=1 \
   -s EXPORT_NAME="createMelSpectrogramModule" \
-  -s EXPORTED_FUNCTIONS='["_mel_spectrogram_compute","_mel_spectrogram_free","_mel_spectrogram_init","_mel_spectrogram_compute_frame","_mel_spectrogram_get_n_mels","_audio_features_compute","_audio_features_free","_audio_features_init","_audio_features_compute_frame","_audio_features_free_arrays","_audio_features_get_n_mfcc","_malloc","_free"]' \
+  -s EXPORTED_FUNCTIONS='["_mel_spectrogram_compute","_mel_spectrogram_compute_padded","_mel_spectrogram_free","_mel_spectrogram_compute_encoded","_mel_spectrogram_free_encoded","_mel_spectrogram_init","_mel_spectrogram_compute_frame","_mel_spectrogram_get_n_mels","_audio_features_compute","_audio_features_free","_audio_features_init","_audio_features_compute_frame","_audio_features_free_arrays","_audio_features_get_n_mfcc","_malloc","_free"]' \
   -s EXPORTED_RUNTIME_METHODS='["ccall","cwrap","getValue"]' \
   -s SINGLE_FILE=1 \
   -s ALLOW_MEMORY_GROWTH=1 \
@@ -186,6 +186,13 @@ export interface PreviewOptions extends AudioRangeOptions {
     decodingOptions?: DecodingConfig
 }
 
+/**
+ * Storage of mel-spectrogram values while they cross the native bridge:
+ * float16 halves and uint8 (256 levels over each result's range) quarters the
+ * payload of float32. Results are always returned decoded as numbers.
+ */
+export type MelSpectrogramOutputFormat = 'float32' | 'float16' | 'uint8'
+
 /**
  * Options for mel-spectrogram extraction
  *
@@ -203,6 +210,7 @@ export interface ExtractMelSpectrogramOptions {
     windowType?: 'hann' | 'hamming' // Window function (default: 'hann')
     normalize?: boolean // Mean normalization (default: false)
     logScale?: boolean // Log scaling of mel energies (default: true)
+    outputFormat?: MelSpectrogramOutputFormat // Bridge payload format (default: 'float32')
     decodingOptions?: DecodingConfig // Audio decoding settings
     /** Optional start time in ms. If neither startTimeMs nor endTimeMs is set, defaults to 0. */
     startTimeMs?: number
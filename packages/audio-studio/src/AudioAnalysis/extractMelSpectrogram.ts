@@ -9,6 +9,10 @@ import {
     ExtractMelSpectrogramOptions,
     MelSpectrogram,
 } from './AudioAnalysis.types'
+import {
+    base64ToBytes,
+    decodeMelSpectrogram,
+} from './melSpectrogramEncoding'
 import { computeMelSpectrogramWasm } from './melSpectrogramWasm'
 import {
     processAudioBuffer,
@@ -44,6 +48,7 @@ export async function extractMelSpectrogram(
         windowType = 'hann',
         normalize = false,
         logScale = true,
+        outputFormat = 'float32',
         decodingOptions,
         startTimeMs,
         endTimeMs,
@@ -107,7 +112,8 @@ export async function extractMelSpectrogram(
                 maxFreq,
                 windowType,
                 normalize,
-                logScale
+                logScale,
+                outputFormat
             )
 
             const timeSteps = spectrogram.length
@@ -134,7 +140,36 @@ export async function extractMelSpectrogram(
         arrayBuffer: _arrayBuffer,
         ...nativeOptions
     } = options
-    return AudioStudioModule.extractMelSpectrogram(
+    const result = await AudioStudioModule.extractMelSpectrogram(
         cleanNativeOptions(nativeOptions)
     )
+    return decodeNativeMelSpectrogram(result)
+}
+
+/**
+ * With a compact outputFormat the native modules send the values as base64
+ * (`encodedSpectrogram`) instead of nested number arrays; expand them here.
+ */
+function decodeNativeMelSpectrogram(result: any): MelSpectrogram {
+    if (typeof result?.encodedSpectrogram !== 'string') {
+        return result
+    }
+    const {
+        encodedSpectrogram,
+        outputFormat,
+        quantScale,
+        quantOffset,
+        ...rest
+    } = result
+    return {
+        ...rest,
+        spectrogram: decodeMelSpectrogram({
+            data: base64ToBytes(encodedSpectrogram),
+            outputFormat,
+            timeSteps: rest.timeSteps,
+            nMels: rest.nMels,
+            quantScale: quantScale ?? 1,
+            quantOffset: quantOffset ?? 0,
+        }),
+    }
 }
@@ -18,6 +18,26 @@ export interface MelSpectrogramWasmModule {
 
     _mel_spectrogram_free(resultPtr: number): void
 
+    /** Absent from binaries built before the compact output formats */
+    _mel_spectrogram_compute_encoded?(
+        samples: number,
+        numSamples: number,
+        sampleRate: number,
+        fftLength: number,
+        windowSizeSamples: number,
+        hopLengthSamples: number,
+        nMels: number,
+        fMin: number,
+        fMax: number,
+        windowType: number,
+        logScale: number,
+        normalize: number,
+        paddingMode: number,
+        outputFormat: number
+    ): number
+
+    _mel_spectrogram_free_encoded?(resultPtr: number): void
+
     _mel_spectrogram_init(
         sampleRate: number,
         fftLength: number,
@@ -0,0 +1,92 @@
+import type { MelSpectrogramOutputFormat } from './AudioAnalysis.types'
+
+/**
+ * Numeric codes of the C++ MelSpectrogramConfig::outputFormat.
+ */
+export const MEL_OUTPUT_FORMAT_CODES: Record<MelSpectrogramOutputFormat, number> =
+    {
+        float32: 0,
+        float16: 1,
+        uint8: 2,
+    }
+
+/**
+ * Spectrogram values as the native modules return them for a compact outputFormat:
+ * timeSteps * nMels values, row-major, little-endian.
+ */
+export interface EncodedMelSpectrogram {
+    data: Uint8Array
+    outputFormat: MelSpectrogramOutputFormat
+    timeSteps: number
+    nMels: number
+    /** uint8 only: value = quantOffset + q * quantScale */
+    quantScale: number
+    quantOffset: number
+}
+
+const BASE64_ALPHABET =
+    'ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/'
+const BASE64_LOOKUP = (() => {
+    const lookup = new Uint8Array(128)
+    for (let i = 0; i < BASE64_ALPHABET.length; i++) {
+        lookup[BASE64_ALPHABET.charCodeAt(i)] = i
+    }
+    return lookup
+})()
+
+/**
+ * Decodes the base64 strings the native modules use for binary payloads.
+ */
+export function base64ToBytes(base64: string): Uint8Array {
+    let length = base64.length
+    while (length > 0 && base64[length - 1] === '=') length--
+    const bytes = new Uint8Array(Math.floor((length * 3) / 4))
+    let byteIndex = 0
+    for (let i = 0; i < length; i += 4) {
+        const a = BASE64_LOOKUP[base64.charCodeAt(i)]
+        const b = BASE64_LOOKUP[base64.charCodeAt(i + 1)]
+        const c = i + 2 < length ? BASE64_LOOKUP[base64.charCodeAt(i + 2)] : 0
+        const d = i + 3 < length ? BASE64_LOOKUP[base64.charCodeAt(i + 3)] : 0
+        bytes[byteIndex++] = (a << 2) | (b >> 4)
+        if (i + 2 < length) bytes[byteIndex++] = ((b & 15) << 4) | (c >> 2)
+        if (i + 3 < length) bytes[byteIndex++] = ((c & 3) << 6) | d
+    }
+    return bytes
+}
+
+// IEEE 754 half (as produced by cpp/HalfFloat.h) to number
+function halfToNumber(bits: number): number {
+    const sign = bits & 0x8000 ? -1 : 1
+    const exponent = (bits >> 10) & 0x1f
+    const mantissa = bits & 0x3ff
+    if (exponent === 0) return sign * mantissa * 2 ** -24
+    if (exponent === 0x1f) return mantissa ? NaN : sign * Infinity
+    return sign * (1 + mantissa / 1024) * 2 ** (exponent - 15)
+}
+
+/**
+ * Expands a compact spectrogram back to [time][mel] numbers. float16 values are
+ * exact halves; uint8 values are the 256-level quantization of each result's range.
+ */
+export function decodeMelSpectrogram(encoded: EncodedMelSpectrogram): number[][] {
+    const { data, outputFormat, timeSteps, nMels, quantScale, quantOffset } =
+        encoded
+    const view = new DataView(data.buffer, data.byteOffset, data.byteLength)
+    const spectrogram: number[][] = new Array(timeSteps)
+    for (let t = 0; t < timeSteps; t++) {
+        const row = new Array(nMels)
+        const base = t * nMels
+        for (let m = 0; m < nMels; m++) {
+            const index = base + m
+            if (outputFormat === 'float16') {
+                row[m] = halfToNumber(view.getUint16(index * 2, true))
+            } else if (outputFormat === 'uint8') {
+                row[m] = quantOffset + data[index] * quantScale
+            } else {
+                row[m] = view.getFloat32(index * 4, true)
+            }
+        }
+        spectrogram[t] = row
+    }
+    return spectrogram
+}
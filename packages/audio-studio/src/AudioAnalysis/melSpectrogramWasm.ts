@@ -1,3 +1,5 @@
+import type { MelSpectrogramOutputFormat } from './AudioAnalysis.types'
+
 // Native stub — WASM mel spectrogram is web-only.
 // These functions are only called in web contexts; on native, the C++ TurboModule handles mel spectrograms.
 
@@ -27,7 +29,8 @@ export async function computeMelSpectrogramWasm(
     _fMax: number,
     _windowType: 'hann' | 'hamming',
     _normalize: boolean,
-    _logScale: boolean
+    _logScale: boolean,
+    _outputFormat?: MelSpectrogramOutputFormat
 ): Promise<number[][]> {
     throw new Error('WASM mel spectrogram is not available on native')
 }
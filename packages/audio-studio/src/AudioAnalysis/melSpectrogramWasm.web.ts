@@ -1,4 +1,9 @@
+import type { MelSpectrogramOutputFormat } from './AudioAnalysis.types'
 import type { MelSpectrogramWasmModule } from './mel-spectrogram-wasm'
+import {
+    decodeMelSpectrogram,
+    MEL_OUTPUT_FORMAT_CODES,
+} from './melSpectrogramEncoding'
 import { getWasmModule } from './wasmLoader.web'
 
 // --- Streaming (per-frame) API for live mel spectrogram ---
@@ -87,9 +92,57 @@ export function computeMelFrameWasm(samples: Float32Array): number[] | null {
     return result
 }
 
+const ENCODED_BYTES_PER_VALUE: Record<MelSpectrogramOutputFormat, number> = {
+    float32: 4,
+    float16: 2,
+    uint8: 1,
+}
+
+/**
+ * Reads a compact result of mel_spectrogram_compute_encoded off the WASM heap
+ * (copying 2x/4x fewer bytes than float32) and frees it.
+ */
+function readEncodedResult(
+    Module: MelSpectrogramWasmModule,
+    resultPtr: number,
+    outputFormat: MelSpectrogramOutputFormat,
+    freeEncoded: (resultPtr: number) => void
+): number[][] {
+    // struct layout: { void* data (0), int timeSteps (4), int nMels (8),
+    //                  int outputFormat (12), float scale (16), float offset (20) }
+    const dataPtr = Module.getValue(resultPtr, 'i32')
+    const timeSteps = Module.getValue(resultPtr + 4, 'i32')
+    const nMels = Module.getValue(resultPtr + 8, 'i32')
+    const quantScale = Module.getValue(resultPtr + 16, 'float')
+    const quantOffset = Module.getValue(resultPtr + 20, 'float')
+
+    if (!dataPtr || timeSteps <= 0 || nMels <= 0) {
+        freeEncoded(resultPtr)
+        throw new Error(
+            'mel_spectrogram_compute_encoded returned invalid result struct'
+        )
+    }
+
+    const byteLength =
+        timeSteps * nMels * ENCODED_BYTES_PER_VALUE[outputFormat]
+    const data = Module.HEAPU8.slice(dataPtr, dataPtr + byteLength)
+    freeEncoded(resultPtr)
+
+    return decodeMelSpectrogram({
+        data,
+        outputFormat,
+        timeSteps,
+        nMels,
+        quantScale,
+        quantOffset,
+    })
+}
+
 /**
  * Computes a mel spectrogram via the WASM-compiled C++ implementation.
- * Lazy-loads the WASM module on first call.
+ * Lazy-loads the WASM module on first call. A compact outputFormat is used when
+ * the loaded binary exports mel_spectrogram_compute_encoded (builds from
+ * scripts/build-wasm.sh); older binaries fall back to float32.
  */
 export async function computeMelSpectrogramWasm(
     audioData: Float32Array,
@@ -101,7 +154,8 @@ export async function computeMelSpectrogramWasm(
     fMax: number,
     windowType: 'hann' | 'hamming',
     normalize: boolean,
-    logScale: boolean
+    logScale: boolean,
+    outputFormat: MelSpectrogramOutputFormat = 'float32'
 ): Promise<number[][]> {
     const Module = (await getWasmModule()) as MelSpectrogramWasmModule
 
@@ -113,6 +167,39 @@ export async function computeMelSpectrogramWasm(
     const inputPtr = Module._malloc(numSamples * 4) // 4 bytes per float
     Module.HEAPF32.set(audioData, inputPtr >> 2)
 
+    const computeEncoded = Module._mel_spectrogram_compute_encoded
+    const freeEncoded = Module._mel_spectrogram_free_encoded
+    if (outputFormat !== 'float32' && computeEncoded && freeEncoded) {
+        const encodedPtr = computeEncoded(
+            inputPtr,
+            numSamples,
+            sampleRate,
+            fftLength,
+            windowSizeSamples,
+            hopLengthSamples,
+            nMels,
+            fMin,
+            fMax,
+            windowTypeInt,
+            logScale ? 1 : 0,
+            normalize ? 1 : 0,
+            0 /* no padding, as mel_spectrogram_compute */,
+            MEL_OUTPUT_FORMAT_CODES[outputFormat]
+        )
+        Module._free(inputPtr)
+        if (encodedPtr === 0) {
+            throw new Error(
+                'mel_spectrogram_compute_encoded returned null (too few samples?)'
+            )
+        }
+        return readEncodedResult(
+            Module,
+            encodedPtr,
+            outputFormat,
+            freeEncoded
+        )
+    }
+
     // Call the C bridge
     const resultPtr = Module._mel_spectrogram_compute(
         inputPtr,
@@ -11,20 +11,32 @@ import com.facebook.react.bridge.Arguments
 import com.facebook.react.bridge.WritableArray
 import java.util.concurrent.Executors
 import java.util.concurrent.ExecutorService
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.atomic.AtomicInteger
+import android.util.Base64
 import android.util.Log
 import org.json.JSONObject
 import org.json.JSONArray
 import org.json.JSONException
 import com.facebook.react.bridge.ReadableType
+import java.nio.ByteBuffer
 
 class EssentiaModule(reactContext: ReactApplicationContext) :
   ReactContextBaseJavaModule(reactContext) {
 
   private var threadCount: Int = 4 // Default thread count
+  private var profilingEnabled = false
   private var executor: ExecutorService = Executors.newFixedThreadPool(threadCount)
   private var nativeHandle: Long = 0
   private val lock = Object()
 
+  // Independent analysis sessions (createSession). Each one owns a native wrapper with
+  // its own audio and caches; calls on a session are serialized by synchronizing on
+  // it, while different sessions run in parallel on the executor.
+  private class Session(var handle: Long)
+  private val sessions = ConcurrentHashMap<Int, Session>()
+  private val nextSessionId = AtomicInteger(1)
+
   // Add caches for algorithm information
   private val algorithmInfoCache = mutableMapOf<String, WritableMap>()
   private var allAlgorithmsCache: WritableMap? = null
@@ -53,6 +65,7 @@ class EssentiaModule(reactContext: ReactApplicationContext) :
   private external fun nativeDestroyEssentiaWrapper(handle: Long)
   private external fun nativeInitializeEssentia(handle: Long): Boolean
   private external fun nativeSetAudioData(handle: Long, pcmData: FloatArray, sampleRate: Double): Boolean
+  private external fun nativeSetAudioDataDirect(handle: Long, pcmData: ByteBuffer, sampleRate: Double): Boolean
   private external fun nativeExecuteAlgorithm(handle: Long, algorithm: String, paramsJson: String): String
   private external fun testJniConnection(): String
   private external fun nativeGetAlgorithmInfo(handle: Long, algorithm: String): String
@@ -68,11 +81,41 @@ class EssentiaModule(reactContext: ReactApplicationContext) :
     fMax: Float,
     windowType: String,
     normalize: Boolean,
-    logScale: Boolean
+    logScale: Boolean,
+    startSample: Long,
+    endSample: Long
+  ): String
+  private external fun nativeComputeMelSpectrogramToFile(
+    handle: Long,
+    frameSize: Int,
+    hopSize: Int,
+    nMels: Int,
+    fMin: Float,
+    fMax: Float,
+    windowType: String,
+    normalize: Boolean,
+    logScale: Boolean,
+    startSample: Long,
+    endSample: Long,
+    path: String,
+    chunkFrames: Int
   ): String
   private external fun nativeExecutePipeline(handle: Long, pipelineJson: String): String
   private external fun nativeComputeSpectrum(handle: Long, frameSize: Int, hopSize: Int): Boolean
   private external fun nativeComputeTonnetz(handle: Long, hpcpJson: String): String
+  private external fun nativeSetFrameThreadCount(handle: Long, count: Int)
+  private external fun nativeSetProfilingEnabled(handle: Long, enabled: Boolean)
+  private external fun nativeExecuteAlgorithmBinary(handle: Long, algorithm: String, paramsJson: String): ByteBuffer
+  private external fun nativeReleaseBuffer(buffer: ByteBuffer)
+  private external fun nativePreparePipeline(handle: Long, pipelineJson: String): String
+  private external fun nativeRunPipeline(handle: Long, pipelineId: Int, pcmData: FloatArray?): String
+  private external fun nativeReleasePipeline(handle: Long, pipelineId: Int): String
+  private external fun nativeStartPipelineStream(handle: Long, pipelineId: Int): String
+  private external fun nativeAppendAudio(handle: Long, pipelineId: Int, pcmData: FloatArray): String
+  private external fun nativeFinishPipelineStream(handle: Long, pipelineId: Int): String
+  private external fun nativeConfigureResultCache(maxBytes: Long, directory: String)
+  private external fun nativeClearResultCache()
+  private external fun nativeSetLazyRegistration(lazy: Boolean)
 
   /**
    * Helper method to ensure Essentia is initialized
@@ -102,6 +145,8 @@ class EssentiaModule(reactContext: ReactApplicationContext) :
                 return@execute
               }
 
+              nativeSetFrameThreadCount(nativeHandle, threadCount)
+              nativeSetProfilingEnabled(nativeHandle, profilingEnabled)
               Log.d("EssentiaModule", "Lazy initialization successful")
             }
 
@@ -160,6 +205,8 @@ class EssentiaModule(reactContext: ReactApplicationContext) :
               return@execute
             }
 
+            nativeSetFrameThreadCount(nativeHandle, threadCount)
+            nativeSetProfilingEnabled(nativeHandle, profilingEnabled)
             promise.resolve(result)
           }
         } catch (e: Exception) {
@@ -256,6 +303,25 @@ class EssentiaModule(reactContext: ReactApplicationContext) :
     }
   }
 
+  /**
+   * Loads audio for native Android callers from a direct ByteBuffer of native-order
+   * floats (its whole capacity is used), e.g. FileChannel.map over the samples of a
+   * float WAV file. The samples are copied once, straight into the native buffer,
+   * instead of going through a ReadableArray and a FloatArray. Returns false if
+   * Essentia has not been initialized yet.
+   */
+  fun setAudioData(pcmData: ByteBuffer, sampleRate: Double): Boolean {
+    require(pcmData.isDirect) { "pcmData must be a direct ByteBuffer" }
+    require(sampleRate > 0) { "Sample rate must be positive" }
+    synchronized(lock) {
+      if (nativeHandle == 0L) {
+        Log.e("EssentiaModule", "setAudioData(ByteBuffer) called before Essentia was initialized")
+        return false
+      }
+      return nativeSetAudioDataDirect(nativeHandle, pcmData, sampleRate)
+    }
+  }
+
   /**
    * Converts a JSON string to a WritableMap that can be sent to JavaScript
    */
@@ -426,6 +492,53 @@ class EssentiaModule(reactContext: ReactApplicationContext) :
     }
   }
 
+  /**
+   * Executes an algorithm and resolves with its result pool in the binary encoding
+   * (cpp/PoolCodec.h), base64-encoded for the bridge. Decoded in JS by decodeBinaryPool.
+   * @param algorithm Name of the Essentia algorithm
+   * @param params Algorithm parameters
+   * @param promise Promise that resolves to the base64 string
+   */
+  @Suppress("unused")
+  @ReactMethod
+  fun executeAlgorithmBinary(algorithm: String, params: ReadableMap, promise: Promise) {
+    Log.d("EssentiaModule", "Entering executeAlgorithmBinary with algorithm: $algorithm")
+    ensureInitialized(promise) {
+      if (algorithm.isEmpty()) {
+        promise.reject("ESSENTIA_INVALID_INPUT", "Algorithm name cannot be empty")
+        return@ensureInitialized
+      }
+
+      val paramsJson = convertReadableMapToJsonObject(params).toString()
+
+      val buffer: ByteBuffer
+      try {
+        synchronized(lock) {
+          if (nativeHandle == 0L) {
+            promise.reject("ESSENTIA_NOT_INITIALIZED", "Essentia was destroyed during processing")
+            return@ensureInitialized
+          }
+          buffer = nativeExecuteAlgorithmBinary(nativeHandle, algorithm, paramsJson)
+        }
+      } catch (e: RuntimeException) {
+        // The native layer throws with the usual error response JSON as message
+        val resultMap = convertJsonToWritableMap(e.message)
+        if (!handleErrorInResultMap(resultMap, promise)) {
+          promise.reject("ESSENTIA_ALGORITHM_ERROR", "Failed to execute $algorithm: ${e.message}")
+        }
+        return@ensureInitialized
+      }
+
+      try {
+        val bytes = ByteArray(buffer.remaining())
+        buffer.get(bytes)
+        promise.resolve(Base64.encodeToString(bytes, Base64.NO_WRAP))
+      } finally {
+        nativeReleaseBuffer(buffer)
+      }
+    }
+  }
+
   /**
    * Simple test method to verify JNI connection is working
    * @param promise Promise that resolves to a string message
@@ -770,6 +883,16 @@ class EssentiaModule(reactContext: ReactApplicationContext) :
           // Shutdown old executor after creating the new one
           oldExecutor.shutdown()
         }
+
+        // Frame-parallel native processing uses the same count
+        if (nativeHandle != 0L) {
+          nativeSetFrameThreadCount(nativeHandle, threadCount)
+        }
+        for (session in sessions.values) {
+          synchronized(session) {
+            if (session.handle != 0L) nativeSetFrameThreadCount(session.handle, threadCount)
+          }
+        }
       }
 
       promise.resolve(true)
@@ -795,6 +918,95 @@ class EssentiaModule(reactContext: ReactApplicationContext) :
     }
   }
 
+  /**
+   * Enables or disables native profiling. While enabled, results carry a "profile"
+   * section with per-stage timings, frame counts and buffer sizes.
+   * @param enabled True to enable profiling, false to disable
+   * @param promise Promise that resolves to a boolean indicating success
+   */
+  @Suppress("unused")
+  @ReactMethod
+  fun setProfilingEnabled(enabled: Boolean, promise: Promise) {
+    Log.d("EssentiaModule", "Entering setProfilingEnabled with enabled: $enabled")
+    synchronized(lock) {
+      profilingEnabled = enabled
+      if (nativeHandle != 0L) {
+        nativeSetProfilingEnabled(nativeHandle, enabled)
+      }
+      for (session in sessions.values) {
+        synchronized(session) {
+          if (session.handle != 0L) nativeSetProfilingEnabled(session.handle, enabled)
+        }
+      }
+    }
+    promise.resolve(true)
+  }
+
+  /**
+   * Sizes the memo cache of extractFeatures / executePipeline results, shared by
+   * all sessions. Repeating a config on the same audio is then answered from the
+   * cache without recomputing anything.
+   * @param maxBytes Byte budget of the cache; 0 disables it
+   * @param persist True to also keep the entries in the app's cache directory
+   * @param promise Promise that resolves to a boolean indicating success
+   */
+  @Suppress("unused")
+  @ReactMethod
+  fun setResultCache(maxBytes: Double, persist: Boolean, promise: Promise) {
+    Log.d("EssentiaModule", "Entering setResultCache with maxBytes: $maxBytes, persist: $persist")
+    if (maxBytes < 0) {
+      promise.reject("ESSENTIA_INVALID_INPUT", "maxBytes must not be negative")
+      return
+    }
+    try {
+      executor.execute {
+        try {
+          val directory = if (persist) java.io.File(reactApplicationContext.cacheDir, "essentia-results").absolutePath else ""
+          nativeConfigureResultCache(maxBytes.toLong(), directory)
+          promise.resolve(true)
+        } catch (e: Exception) {
+          Log.e("EssentiaModule", "Failed to configure result cache: ${e.message}", e)
+          promise.reject("ESSENTIA_CACHE_ERROR", "Failed to configure result cache: ${e.message}")
+        }
+      }
+    } catch (e: Exception) {
+      promise.reject("ESSENTIA_CACHE_ERROR", "Failed to configure result cache: ${e.message}")
+    }
+  }
+
+  /**
+   * Drops every memoized result, including the persisted ones
+   * @param promise Promise that resolves to a boolean indicating success
+   */
+  @Suppress("unused")
+  @ReactMethod
+  fun clearResultCache(promise: Promise) {
+    Log.d("EssentiaModule", "Entering clearResultCache")
+    try {
+      executor.execute {
+        nativeClearResultCache()
+        promise.resolve(true)
+      }
+    } catch (e: Exception) {
+      promise.reject("ESSENTIA_CACHE_ERROR", "Failed to clear result cache: ${e.message}")
+    }
+  }
+
+  /**
+   * Chooses when Essentia registers its algorithms: on the first algorithm call
+   * (lazy, the default, so initialize() returns quickly) or during initialize().
+   * Takes effect for the next initialization.
+   * @param enabled True to register lazily, false to register during initialize()
+   * @param promise Promise that resolves to a boolean indicating success
+   */
+  @Suppress("unused")
+  @ReactMethod
+  fun setLazyRegistration(enabled: Boolean, promise: Promise) {
+    Log.d("EssentiaModule", "Entering setLazyRegistration with enabled: $enabled")
+    nativeSetLazyRegistration(enabled)
+    promise.resolve(true)
+  }
+
   /**
    * Enables or disables the algorithm information cache
    * @param enabled True to enable caching, false to disable
@@ -886,6 +1098,8 @@ class EssentiaModule(reactContext: ReactApplicationContext) :
     windowType: String,
     normalize: Boolean,
     logScale: Boolean,
+    startSample: Double,
+    endSample: Double,
     promise: Promise
   ) {
     Log.d("EssentiaModule", "Entering computeMelSpectrogram with frameSize: $frameSize, hopSize: $hopSize, nMels: $nMels")
@@ -911,7 +1125,8 @@ class EssentiaModule(reactContext: ReactApplicationContext) :
           return@ensureInitialized
         }
         resultJsonString = nativeComputeMelSpectrogram(
-          nativeHandle, frameSize, hopSize, nMels, fMin, fMax, windowType, normalize, logScale
+          nativeHandle, frameSize, hopSize, nMels, fMin, fMax, windowType, normalize, logScale,
+          startSample.toLong(), endSample.toLong()
         )
       }
 
@@ -930,6 +1145,58 @@ class EssentiaModule(reactContext: ReactApplicationContext) :
     }
   }
 
+  /**
+   * Computes a mel spectrogram like computeMelSpectrogram, but writes the bands to a file
+   * (little-endian float32, timeSteps x nMels, row-major) chunkFrames frames at a time, so
+   * memory stays bounded however long the audio is
+   * @param path File to create or overwrite
+   * @param chunkFrames Frames computed and written at a time
+   * @param promise Promise that resolves to the shape of the result and the path
+   */
+  @Suppress("unused")
+  @ReactMethod
+  fun computeMelSpectrogramToFile(
+    frameSize: Int,
+    hopSize: Int,
+    nMels: Int,
+    fMin: Float,
+    fMax: Float,
+    windowType: String,
+    normalize: Boolean,
+    logScale: Boolean,
+    startSample: Double,
+    endSample: Double,
+    path: String,
+    chunkFrames: Int,
+    promise: Promise
+  ) {
+    Log.d("EssentiaModule", "Entering computeMelSpectrogramToFile with path: $path, chunkFrames: $chunkFrames")
+    ensureInitialized(promise) {
+      if (frameSize <= 0 || hopSize <= 0 || nMels <= 0 || chunkFrames <= 0) {
+        promise.reject("ESSENTIA_INVALID_INPUT", "Frame size, hop size, nMels and chunkFrames must be positive")
+        return@ensureInitialized
+      }
+
+      if (fMin < 0 || fMax <= fMin) {
+        promise.reject("ESSENTIA_INVALID_INPUT", "fMin must be non-negative and fMax must be greater than fMin")
+        return@ensureInitialized
+      }
+
+      val resultJsonString: String
+      synchronized(lock) {
+        if (nativeHandle == 0L) {
+          promise.reject("ESSENTIA_NOT_INITIALIZED", "Essentia was destroyed during processing")
+          return@ensureInitialized
+        }
+        resultJsonString = nativeComputeMelSpectrogramToFile(
+          nativeHandle, frameSize, hopSize, nMels, fMin, fMax, windowType, normalize, logScale,
+          startSample.toLong(), endSample.toLong(), path, chunkFrames
+        )
+      }
+      resolveNativeResult(resultJsonString, promise)
+    }
+  }
+
   /**
    * Executes an audio processing pipeline with configurable preprocessing, feature extraction,
    * and post-processing steps.
@@ -976,6 +1243,200 @@ class EssentiaModule(reactContext: ReactApplicationContext) :
     }
   }
 
+  /**
+   * Validates and compiles a pipeline configuration once so it can be run repeatedly.
+   * @param pipelineJson JSON string with the pipeline configuration
+   * @param promise Promise that resolves to a map with the pipelineId
+   */
+  @Suppress("unused")
+  @ReactMethod
+  fun preparePipeline(pipelineJson: String, promise: Promise) {
+    Log.d("EssentiaModule", "Entering preparePipeline with pipelineJson length: ${pipelineJson.length}")
+    ensureInitialized(promise) {
+      if (pipelineJson.isEmpty()) {
+        promise.reject("ESSENTIA_INVALID_INPUT", "Pipeline configuration cannot be empty")
+        return@ensureInitialized
+      }
+
+      val resultJsonString: String
+      synchronized(lock) {
+        if (nativeHandle == 0L) {
+          promise.reject("ESSENTIA_NOT_INITIALIZED", "Essentia was destroyed during processing")
+          return@ensureInitialized
+        }
+        resultJsonString = nativePreparePipeline(nativeHandle, pipelineJson)
+      }
+
+      val resultMap = convertJsonToWritableMap(resultJsonString)
+      if (handleErrorInResultMap(resultMap, promise)) {
+        return@ensureInitialized
+      }
+      promise.resolve(resultMap)
+    }
+  }
+
+  /**
+   * Runs a prepared pipeline on the current audio data, or on pcmArray when given
+   * (the current audio data is left unchanged).
+   * @param pipelineId Id returned by preparePipeline
+   * @param pcmArray Optional PCM samples to run on instead of the current audio
+   * @param promise Promise that resolves to the pipeline results
+   */
+  @Suppress("unused")
+  @ReactMethod
+  fun runPipeline(pipelineId: Int, pcmArray: ReadableArray?, promise: Promise) {
+    Log.d("EssentiaModule", "Entering runPipeline with pipelineId: $pipelineId")
+    ensureInitialized(promise) {
+      var pcmFloatArray: FloatArray? = null
+      if (pcmArray != null) {
+        pcmFloatArray = FloatArray(pcmArray.size())
+        for (j in 0 until pcmArray.size()) {
+          if (pcmArray.getType(j) != ReadableType.Number) {
+            promise.reject("ESSENTIA_TYPE_ERROR",
+              "Invalid data type at index $j. Expected number, got ${pcmArray.getType(j)}")
+            return@ensureInitialized
+          }
+          pcmFloatArray[j] = pcmArray.getDouble(j).toFloat()
+        }
+      }
+
+      val resultJsonString: String
+      synchronized(lock) {
+        if (nativeHandle == 0L) {
+          promise.reject("ESSENTIA_NOT_INITIALIZED", "Essentia was destroyed during processing")
+          return@ensureInitialized
+        }
+        resultJsonString = nativeRunPipeline(nativeHandle, pipelineId, pcmFloatArray)
+      }
+
+      val resultMap = convertJsonToWritableMap(resultJsonString)
+      if (handleErrorInResultMap(resultMap, promise)) {
+        return@ensureInitialized
+      }
+      promise.resolve(resultMap)
+    }
+  }
+
+  /**
+   * Releases a prepared pipeline and the algorithms it holds.
+   * @param pipelineId Id returned by preparePipeline
+   * @param promise Promise that resolves to a result map
+   */
+  @Suppress("unused")
+  @ReactMethod
+  fun releasePipeline(pipelineId: Int, promise: Promise) {
+    Log.d("EssentiaModule", "Entering releasePipeline with pipelineId: $pipelineId")
+    ensureInitialized(promise) {
+      val resultJsonString: String
+      synchronized(lock) {
+        if (nativeHandle == 0L) {
+          promise.reject("ESSENTIA_NOT_INITIALIZED", "Essentia was destroyed during processing")
+          return@ensureInitialized
+        }
+        resultJsonString = nativeReleasePipeline(nativeHandle, pipelineId)
+      }
+
+      val resultMap = convertJsonToWritableMap(resultJsonString)
+      if (handleErrorInResultMap(resultMap, promise)) {
+        return@ensureInitialized
+      }
+      promise.resolve(resultMap)
+    }
+  }
+
+  /**
+   * Starts a streaming run of a prepared (frame-based) pipeline.
+   * @param pipelineId Id returned by preparePipeline
+   * @param promise Promise that resolves to a result map
+   */
+  @Suppress("unused")
+  @ReactMethod
+  fun startPipelineStream(pipelineId: Int, promise: Promise) {
+    Log.d("EssentiaModule", "Entering startPipelineStream with pipelineId: $pipelineId")
+    ensureInitialized(promise) {
+      val resultJsonString: String
+      synchronized(lock) {
+        if (nativeHandle == 0L) {
+          promise.reject("ESSENTIA_NOT_INITIALIZED", "Essentia was destroyed during processing")
+          return@ensureInitialized
+        }
+        resultJsonString = nativeStartPipelineStream(nativeHandle, pipelineId)
+      }
+
+      val resultMap = convertJsonToWritableMap(resultJsonString)
+      if (handleErrorInResultMap(resultMap, promise)) {
+        return@ensureInitialized
+      }
+      promise.resolve(resultMap)
+    }
+  }
+
+  /**
+   * Feeds the next chunk of live audio to a pipeline stream. Only the frames the
+   * chunk completes are processed.
+   * @param pipelineId Id returned by preparePipeline
+   * @param pcmArray PCM samples following the previous chunk
+   * @param promise Promise that resolves to the rows of the new frames
+   */
+  @Suppress("unused")
+  @ReactMethod
+  fun appendAudio(pipelineId: Int, pcmArray: ReadableArray, promise: Promise) {
+    ensureInitialized(promise) {
+      val pcmFloatArray = FloatArray(pcmArray.size())
+      for (j in 0 until pcmArray.size()) {
+        if (pcmArray.getType(j) != ReadableType.Number) {
+          promise.reject("ESSENTIA_TYPE_ERROR",
+            "Invalid data type at index $j. Expected number, got ${pcmArray.getType(j)}")
+          return@ensureInitialized
+        }
+        pcmFloatArray[j] = pcmArray.getDouble(j).toFloat()
+      }
+
+      val resultJsonString: String
+      synchronized(lock) {
+        if (nativeHandle == 0L) {
+          promise.reject("ESSENTIA_NOT_INITIALIZED", "Essentia was destroyed during processing")
+          return@ensureInitialized
+        }
+        resultJsonString = nativeAppendAudio(nativeHandle, pipelineId, pcmFloatArray)
+      }
+
+      val resultMap = convertJsonToWritableMap(resultJsonString)
+      if (handleErrorInResultMap(resultMap, promise)) {
+        return@ensureInitialized
+      }
+      promise.resolve(resultMap)
+    }
+  }
+
+  /**
+   * Ends a pipeline stream: processes the remaining (zero-padded) frames and
+   * resolves with their rows plus the mean/variance summary.
+   * @param pipelineId Id returned by preparePipeline
+   * @param promise Promise that resolves to the final rows and summary
+   */
+  @Suppress("unused")
+  @ReactMethod
+  fun finishPipelineStream(pipelineId: Int, promise: Promise) {
+    Log.d("EssentiaModule", "Entering finishPipelineStream with pipelineId: $pipelineId")
+    ensureInitialized(promise) {
+      val resultJsonString: String
+      synchronized(lock) {
+        if (nativeHandle == 0L) {
+          promise.reject("ESSENTIA_NOT_INITIALIZED", "Essentia was destroyed during processing")
+          return@ensureInitialized
+        }
+        resultJsonString = nativeFinishPipelineStream(nativeHandle, pipelineId)
+      }
+
+      val resultMap = convertJsonToWritableMap(resultJsonString)
+      if (handleErrorInResultMap(resultMap, promise)) {
+        return@ensureInitialized
+      }
+      promise.resolve(resultMap)
+    }
+  }
+
   /**
    * Computes the spectrum with specified frame size and hop size.
    * This ensures spectrum has appropriate size for subsequent algorithms.
@@ -1063,6 +1524,210 @@ class EssentiaModule(reactContext: ReactApplicationContext) :
     }
   }
 
+  /**
+   * Runs block with the native handle of a session on the executor, holding the
+   * session so that its calls run one at a time
+   */
+  private fun withSession(sessionId: Int, promise: Promise, block: (handle: Long) -> Unit) {
+    val session = sessions[sessionId] ?: run {
+      promise.reject("ESSENTIA_INVALID_SESSION", "No session with id $sessionId")
+      return
+    }
+    try {
+      executor.execute {
+        try {
+          synchronized(session) {
+            if (session.handle == 0L) {
+              promise.reject("ESSENTIA_INVALID_SESSION", "Session $sessionId was destroyed")
+              return@execute
+            }
+            block(session.handle)
+          }
+        } catch (e: Exception) {
+          Log.e("EssentiaModule", "Error in session $sessionId: ${e.message}", e)
+          promise.reject("ESSENTIA_SESSION_ERROR", "Session $sessionId failed: ${e.message}")
+        }
+      }
+    } catch (e: Exception) {
+      Log.e("EssentiaModule", "Failed to schedule session $sessionId: ${e.message}", e)
+      promise.reject("ESSENTIA_SESSION_ERROR", "Failed to schedule session $sessionId: ${e.message}")
+    }
+  }
+
+  /**
+   * Resolves the promise with a native result, or rejects it with the native error
+   */
+  private fun resolveNativeResult(resultJsonString: String, promise: Promise) {
+    val resultMap = convertJsonToWritableMap(resultJsonString)
+    if (!handleErrorInResultMap(resultMap, promise)) {
+      promise.resolve(resultMap)
+    }
+  }
+
+  /**
+   * Creates an independent analysis session with its own audio and caches. Work on
+   * different sessions runs concurrently (up to the thread count); Essentia itself
+   * is initialized once and shared.
+   * @param promise Promise that resolves to the session id
+   */
+  @Suppress("unused")
+  @ReactMethod
+  fun createSession(promise: Promise) {
+    Log.d("EssentiaModule", "Entering createSession")
+    try {
+      executor.execute {
+        try {
+          val handle = nativeCreateEssentiaWrapper()
+          if (handle == 0L) {
+            promise.reject("ESSENTIA_INIT_ERROR", "Failed to create Essentia wrapper")
+            return@execute
+          }
+          if (!nativeInitializeEssentia(handle)) {
+            nativeDestroyEssentiaWrapper(handle)
+            promise.reject("ESSENTIA_INIT_ERROR", "Failed to initialize Essentia")
+            return@execute
+          }
+          synchronized(lock) {
+            nativeSetFrameThreadCount(handle, threadCount)
+            nativeSetProfilingEnabled(handle, profilingEnabled)
+          }
+
+          val sessionId = nextSessionId.getAndIncrement()
+          sessions[sessionId] = Session(handle)
+          promise.resolve(sessionId)
+        } catch (e: Exception) {
+          Log.e("EssentiaModule", "Exception creating session: ${e.message}", e)
+          promise.reject("ESSENTIA_INIT_ERROR", "Failed to create session: ${e.message}")
+        }
+      }
+    } catch (e: Exception) {
+      Log.e("EssentiaModule", "Failed to create session: ${e.message}", e)
+      promise.reject("ESSENTIA_INIT_ERROR", "Failed to create session: ${e.message}")
+    }
+  }
+
+  /**
+   * Destroys a session and frees its native resources, after any call on it finished
+   * @param sessionId Id returned by createSession
+   * @param promise Promise that resolves to false if there was no such session
+   */
+  @Suppress("unused")
+  @ReactMethod
+  fun destroySession(sessionId: Int, promise: Promise) {
+    Log.d("EssentiaModule", "Entering destroySession with sessionId: $sessionId")
+    val session = sessions.remove(sessionId) ?: run {
+      promise.resolve(false)
+      return
+    }
+    try {
+      executor.execute {
+        synchronized(session) {
+          if (session.handle != 0L) {
+            nativeDestroyEssentiaWrapper(session.handle)
+            session.handle = 0L
+          }
+        }
+        promise.resolve(true)
+      }
+    } catch (e: Exception) {
+      Log.e("EssentiaModule", "Failed to destroy session: ${e.message}", e)
+      promise.reject("ESSENTIA_SESSION_ERROR", "Failed to destroy session: ${e.message}")
+    }
+  }
+
+  /**
+   * Sets the audio of a session
+   * @param sessionId Id returned by createSession
+   * @param pcmArray Array of audio samples
+   * @param sampleRate Sampling rate in Hz
+   * @param promise Promise that resolves to a boolean indicating success
+   */
+  @Suppress("unused")
+  @ReactMethod
+  fun sessionSetAudioData(sessionId: Int, pcmArray: ReadableArray, sampleRate: Double, promise: Promise) {
+    Log.d("EssentiaModule", "Entering sessionSetAudioData with sessionId: $sessionId, size: ${pcmArray.size()}")
+    if (pcmArray.size() == 0) {
+      promise.reject("ESSENTIA_INVALID_INPUT", "PCM data array is empty")
+      return
+    }
+    if (sampleRate <= 0) {
+      promise.reject("ESSENTIA_INVALID_INPUT", "Sample rate must be positive")
+      return
+    }
+    withSession(sessionId, promise) { handle ->
+      val pcmFloatArray = FloatArray(pcmArray.size())
+      for (j in 0 until pcmArray.size()) {
+        if (pcmArray.getType(j) != ReadableType.Number) {
+          promise.reject("ESSENTIA_TYPE_ERROR",
+            "Invalid data type at index $j. Expected number, got ${pcmArray.getType(j)}")
+          return@withSession
+        }
+        pcmFloatArray[j] = pcmArray.getDouble(j).toFloat()
+      }
+      promise.resolve(nativeSetAudioData(handle, pcmFloatArray, sampleRate))
+    }
+  }
+
+  /**
+   * Executes an algorithm on the audio of a session
+   * @param sessionId Id returned by createSession
+   * @param algorithm Name of the Essentia algorithm
+   * @param params Algorithm parameters
+   * @param promise Promise that resolves to the algorithm's output
+   */
+  @Suppress("unused")
+  @ReactMethod
+  fun sessionExecuteAlgorithm(sessionId: Int, algorithm: String, params: ReadableMap, promise: Promise) {
+    Log.d("EssentiaModule", "Entering sessionExecuteAlgorithm with sessionId: $sessionId, algorithm: $algorithm")
+    if (algorithm.isEmpty()) {
+      promise.reject("ESSENTIA_INVALID_INPUT", "Algorithm name cannot be empty")
+      return
+    }
+    val paramsJson = convertReadableMapToJsonObject(params).toString()
+    withSession(sessionId, promise) { handle ->
+      resolveNativeResult(nativeExecuteAlgorithm(handle, algorithm, paramsJson), promise)
+    }
+  }
+
+  /**
+   * Extracts several features from the audio of a session in one pass
+   * @param sessionId Id returned by createSession
+   * @param featureList Array of {name, params} feature configurations
+   * @param promise Promise that resolves to the extracted features
+   */
+  @Suppress("unused")
+  @ReactMethod
+  fun sessionExtractFeatures(sessionId: Int, featureList: ReadableArray, promise: Promise) {
+    Log.d("EssentiaModule", "Entering sessionExtractFeatures with sessionId: $sessionId, features: ${featureList.size()}")
+    if (featureList.size() == 0) {
+      promise.reject("ESSENTIA_INVALID_INPUT", "Feature list cannot be empty")
+      return
+    }
+    val featuresJson = convertReadableArrayToJson(featureList)
+    withSession(sessionId, promise) { handle ->
+      resolveNativeResult(nativeExtractFeatures(handle, featuresJson), promise)
+    }
+  }
+
+  /**
+   * Executes a pipeline on the audio of a session
+   * @param sessionId Id returned by createSession
+   * @param pipelineJson JSON string with the pipeline configuration
+   * @param promise Promise that resolves to the pipeline results
+   */
+  @Suppress("unused")
+  @ReactMethod
+  fun sessionExecutePipeline(sessionId: Int, pipelineJson: String, promise: Promise) {
+    Log.d("EssentiaModule", "Entering sessionExecutePipeline with sessionId: $sessionId")
+    if (pipelineJson.isEmpty()) {
+      promise.reject("ESSENTIA_INVALID_INPUT", "Pipeline configuration cannot be empty")
+      return
+    }
+    withSession(sessionId, promise) { handle ->
+      resolveNativeResult(nativeExecutePipeline(handle, pipelineJson), promise)
+    }
+  }
+
   override fun invalidate() {
     // Clear caches when module is invalidated
     clearCache()
@@ -1079,6 +1744,16 @@ class EssentiaModule(reactContext: ReactApplicationContext) :
       }
     }
 
+    for (session in sessions.values) {
+      synchronized(session) {
+        if (session.handle != 0L) {
+          nativeDestroyEssentiaWrapper(session.handle)
+          session.handle = 0L
+        }
+      }
+    }
+    sessions.clear()
+
     try {
       executor.shutdown()
     } catch (e: Exception) {
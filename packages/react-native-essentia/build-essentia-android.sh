@@ -15,6 +15,9 @@ function show_usage {
   echo "  --force          Force rebuild even if library exists"
   echo "  --help           Show this help message"
   echo ""
+  echo "Set ESSENTIA_INCLUDE_ALGOS to a comma-separated list of algorithms to build only"
+  echo "those (and list their dependencies too, e.g. MFCC needs MelBands and DCT)."
+  echo ""
   echo "Example: $0 --arch=arm64-v8a"
   echo "Example: $0 --all"
 }
@@ -53,6 +56,13 @@ for arg in "$@"; do
   esac
 done
 
+# Optional allow-list: fewer algorithms to link and to register in essentia::init
+ALGOS_OPTION=""
+if [ -n "$ESSENTIA_INCLUDE_ALGOS" ]; then
+  ALGOS_OPTION="--include-algos=${ESSENTIA_INCLUDE_ALGOS}"
+  echo "Building only these algorithms: ${ESSENTIA_INCLUDE_ALGOS}"
+fi
+
 # Validate architecture if specified
 if [ -n "$SELECTED_ARCH" ] && [[ ! " ${SUPPORTED_ARCHS[*]} " =~ " ${SELECTED_ARCH} " ]]; then
   echo "Error: Unsupported architecture '$SELECTED_ARCH'"
@@ -121,7 +131,7 @@ for ARCH in "${ARCHS_TO_BUILD[@]}"; do
   cd third_party/essentia
 
   echo "Configuring Essentia for Android (${ARCH})..."
-  python3 waf configure --cross-compile-android --lightweight= --fft=KISS --build-static
+  python3 waf configure --cross-compile-android --lightweight= --fft=KISS --build-static ${ALGOS_OPTION}
 
   echo "Building Essentia..."
   python3 waf
@@ -17,6 +17,13 @@ if [ -f "ios/Frameworks/device/Essentia_iOS.a" ] && [ -f "ios/Frameworks/simulat
   exit 0
 fi
 
+# Optional allow-list (comma-separated, dependencies included): fewer algorithms to
+# link and to register in essentia::init
+ALGOS_OPTION=""
+if [ -n "$ESSENTIA_INCLUDE_ALGOS" ]; then
+  ALGOS_OPTION="--include-algos=${ESSENTIA_INCLUDE_ALGOS}"
+fi
+
 cd third_party/essentia
 
 # Clean any previous builds
@@ -42,7 +49,7 @@ export LDFLAGS="-arch x86_64 -isysroot $SIMULATOR_SDK_PATH -mios-simulator-versi
 export SDKROOT="$SIMULATOR_SDK_PATH"
 
 # Configure for x86_64 simulator
-python3 waf configure --cross-compile-ios-sim-x86_64 --lightweight= --fft=ACCELERATE --build-static
+python3 waf configure --cross-compile-ios-sim-x86_64 --lightweight= --fft=ACCELERATE --build-static ${ALGOS_OPTION}
 if [ $? -ne 0 ]; then
   echo "Error: Configuration for iOS simulator x86_64 failed. Check waf logs."
   exit 1
@@ -88,7 +95,7 @@ export SDKROOT="$SIMULATOR_SDK_PATH"
 export CC="clang -arch arm64 -isysroot $SIMULATOR_SDK_PATH -target arm64-apple-ios15.0-simulator"
 export CXX="clang++ -arch arm64 -isysroot $SIMULATOR_SDK_PATH -target arm64-apple-ios15.0-simulator"
 
-python3 waf configure --cross-compile-ios-sim-arm64 --lightweight= --fft=ACCELERATE --build-static
+python3 waf configure --cross-compile-ios-sim-arm64 --lightweight= --fft=ACCELERATE --build-static ${ALGOS_OPTION}
 if [ $? -ne 0 ]; then
   echo "Error: Configuration for iOS simulator arm64 failed. Check waf logs."
   exit 1
@@ -126,7 +133,7 @@ export CXXFLAGS="-arch arm64 -isysroot $DEVICE_SDK_PATH -miphoneos-version-min=1
 export LDFLAGS="-arch arm64 -isysroot $DEVICE_SDK_PATH -miphoneos-version-min=15.0"
 export SDKROOT="$DEVICE_SDK_PATH"
 
-python3 waf configure --cross-compile-ios --lightweight= --fft=ACCELERATE --build-static
+python3 waf configure --cross-compile-ios --lightweight= --fft=ACCELERATE --build-static ${ALGOS_OPTION}
 if [ $? -ne 0 ]; then
   echo "Error: Configuration for iOS devices failed. Check waf logs."
   exit 1
@@ -0,0 +1,126 @@
+// packages/react-native-essentia/cpp/AlgorithmPool.cpp
+#include "AlgorithmPool.h"
+#include "EssentiaRuntime.h"
+#include "Utils.h"
+
+#include <sstream>
+
+std::mutex AlgorithmPool::sLifecycleMutex;
+
+AlgorithmPool::Lease& AlgorithmPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        if (mPool && mAlgo) {
+            mPool->giveBack(mKey, mAlgo);
+        }
+        mPool = other.mPool;
+        mKey = std::move(other.mKey);
+        mAlgo = other.mAlgo;
+        other.mPool = nullptr;
+        other.mAlgo = nullptr;
+    }
+    return *this;
+}
+
+AlgorithmPool::Lease::~Lease() {
+    if (mPool && mAlgo) {
+        mPool->giveBack(mKey, mAlgo);
+    }
+}
+
+void AlgorithmPool::Lease::discard() {
+    destroy(mAlgo);
+    mAlgo = nullptr;
+    mPool = nullptr;
+}
+
+AlgorithmPool::~AlgorithmPool() {
+    clear();
+}
+
+std::string AlgorithmPool::canonicalKey(const std::string& name,
+                                        const std::map<std::string, essentia::Parameter>& params) {
+    // std::map is already ordered by parameter name; tag values with their type so
+    // e.g. 1 and 1.0 stay distinct, and print reals with enough digits to round-trip.
+    std::ostringstream key;
+    key.precision(9);
+    key << name;
+    for (const auto& param : params) {
+        key << '|' << param.first << '=' << static_cast<int>(param.second.type()) << ':' << param.second;
+    }
+    return key.str();
+}
+
+AlgorithmPool::Lease AlgorithmPool::checkout(const std::string& name,
+                                             const std::map<std::string, essentia::Parameter>& params) {
+    std::string key = canonicalKey(name, params);
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (auto it = mIdle.begin(); it != mIdle.end(); ++it) {
+            if (it->first == key) {
+                essentia::standard::Algorithm* algo = it->second;
+                mIdle.erase(it);
+                return Lease(this, std::move(key), algo);
+            }
+        }
+    }
+
+    // Create outside the idle-list lock; configuring can be slow
+    std::lock_guard<std::mutex> createLock(sLifecycleMutex);
+    EssentiaRuntime::ensureRegistered();
+    essentia::standard::Algorithm* algo = essentia::standard::AlgorithmFactory::create(name);
+    if (!params.empty()) {
+        try {
+            algo->configure(convertToParameterMap(params));
+        } catch (...) {
+            delete algo;  // sLifecycleMutex is held
+            throw;
+        }
+    }
+    return Lease(this, std::move(key), algo);
+}
+
+void AlgorithmPool::giveBack(const std::string& key, essentia::standard::Algorithm* algo) {
+    try {
+        // Stateful algorithms (FrameCutter, ...) start over for the next user
+        algo->reset();
+    } catch (const std::exception& e) {
+        LOGW("Dropping %s after failed reset: %s", key.c_str(), e.what());
+        destroy(algo);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mIdle.emplace_front(key, algo);
+    trimLocked();
+}
+
+void AlgorithmPool::trimLocked() {
+    while (mIdle.size() > mMaxIdle) {
+        destroy(mIdle.back().second);
+        mIdle.pop_back();
+    }
+}
+
+void AlgorithmPool::clear() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (auto& entry : mIdle) {
+        destroy(entry.second);
+    }
+    mIdle.clear();
+}
+
+size_t AlgorithmPool::idleCount() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mIdle.size();
+}
+
+void AlgorithmPool::destroy(essentia::standard::Algorithm* algo) {
+    std::lock_guard<std::mutex> lock(sLifecycleMutex);
+    delete algo;
+}
+
+void AlgorithmPool::setMaxIdle(size_t maxIdle) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mMaxIdle = maxIdle;
+    trimLocked();
+}
@@ -0,0 +1,87 @@
+// packages/react-native-essentia/cpp/AlgorithmPool.h
+#ifndef ALGORITHM_POOL_H
+#define ALGORITHM_POOL_H
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "essentia/essentia.h"
+#include "essentia/algorithmfactory.h"
+
+// Reuses configured Essentia algorithms across calls.
+//
+// Instances are keyed by algorithm name plus the canonicalized parameter map, so a
+// checkout with the same configuration skips create() + configure() (expensive for
+// ConstantQ, HPCP, MelBands, ...). Returned instances are reset() and kept idle up
+// to maxIdle; beyond that the least recently returned one is deleted.
+//
+// Each EssentiaWrapper session owns its pool; pools can be used from different
+// threads at the same time.
+class AlgorithmPool {
+public:
+    // Checked-out instance; goes back to the pool when the lease is destroyed.
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease&& other) noexcept { *this = std::move(other); }
+        Lease& operator=(Lease&& other) noexcept;
+        ~Lease();
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        essentia::standard::Algorithm* get() const { return mAlgo; }
+        essentia::standard::Algorithm* operator->() const { return mAlgo; }
+        explicit operator bool() const { return mAlgo != nullptr; }
+
+        // Delete instead of returning, e.g. when ports were left bound to locals
+        // that a later user might not rebind.
+        void discard();
+
+    private:
+        friend class AlgorithmPool;
+        Lease(AlgorithmPool* pool, std::string key, essentia::standard::Algorithm* algo)
+            : mPool(pool), mKey(std::move(key)), mAlgo(algo) {}
+
+        AlgorithmPool* mPool = nullptr;
+        std::string mKey;
+        essentia::standard::Algorithm* mAlgo = nullptr;
+    };
+
+    explicit AlgorithmPool(size_t maxIdle = 32) : mMaxIdle(maxIdle) {}
+    ~AlgorithmPool();
+
+    AlgorithmPool(const AlgorithmPool&) = delete;
+    AlgorithmPool& operator=(const AlgorithmPool&) = delete;
+
+    // Throws like AlgorithmFactory::create / configure for unknown names or bad params.
+    Lease checkout(const std::string& name,
+                   const std::map<std::string, essentia::Parameter>& params = {});
+
+    // Deletes all idle instances (must run before essentia::shutdown()).
+    void clear();
+    size_t idleCount() const;
+    void setMaxIdle(size_t maxIdle);
+
+    static std::string canonicalKey(const std::string& name,
+                                    const std::map<std::string, essentia::Parameter>& params);
+
+private:
+    void giveBack(const std::string& key, essentia::standard::Algorithm* algo);
+    void trimLocked();
+    static void destroy(essentia::standard::Algorithm* algo);
+
+    mutable std::mutex mMutex;
+    // Serializes create() + configure() and deletion across every pool (so across
+    // sessions too); some algorithms set up or tear down shared state (FFT plans)
+    // there, which is not safe to do from several threads at once
+    static std::mutex sLifecycleMutex;
+    size_t mMaxIdle;
+    // Most recently returned first
+    std::list<std::pair<std::string, essentia::standard::Algorithm*>> mIdle;
+};
+
+#endif
@@ -0,0 +1,60 @@
+// packages/react-native-essentia/cpp/ChromaKernel.cpp
+#include "ChromaKernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+ChromaKernel::ChromaKernel(const ChromaKernelKey& key) : mKey(key) {
+    const int bins = inputSize();
+    const double binHz = mKey.sampleRate / mKey.frameSize;
+    // Half a pitch bin either side of the numberBins range
+    const double lowest = mKey.minFrequency * std::pow(2.0, -0.5 / mKey.binsPerOctave);
+    const double highest = std::min(mKey.minFrequency * std::pow(2.0, (mKey.numberBins - 0.5) / mKey.binsPerOctave),
+                                    mKey.sampleRate / 2);
+
+    // Bin 0 (DC) has no pitch
+    mFirstBin = std::max(1, static_cast<int>(std::ceil(lowest / binHz)));
+    const int lastBin = std::min(bins - 1, static_cast<int>(std::floor(highest / binHz)));
+    if (lastBin < mFirstBin) return;
+
+    mLower.reserve(lastBin - mFirstBin + 1);
+    mUpperWeight.reserve(lastBin - mFirstBin + 1);
+    for (int bin = mFirstBin; bin <= lastBin; ++bin) {
+        const double pitch = mKey.binsPerOctave * std::log2(bin * binHz / mKey.minFrequency);
+        const double below = std::floor(pitch);
+        int lower = static_cast<int>(below) % mKey.binsPerOctave;
+        if (lower < 0) lower += mKey.binsPerOctave;
+        mLower.push_back(lower);
+        mUpperWeight.push_back(static_cast<essentia::Real>(pitch - below));
+    }
+}
+
+void ChromaKernel::apply(const essentia::Real* spectrum, int numBins, std::vector<essentia::Real>& chroma) const {
+    chroma.assign(size(), 0);
+    const int count = std::min(static_cast<int>(mLower.size()), numBins - mFirstBin);
+    const essentia::Real* magnitudes = spectrum + mFirstBin;
+    const int wrap = size();
+    for (int i = 0; i < count; ++i) {
+        const essentia::Real upper = magnitudes[i] * mUpperWeight[i];
+        const int lower = mLower[i];
+        chroma[lower] += magnitudes[i] - upper;
+        chroma[lower + 1 == wrap ? 0 : lower + 1] += upper;
+    }
+}
+
+bool ChromaKernel::normalize(std::vector<essentia::Real>& chroma, const std::string& type) {
+    if (type == "none") return true;
+
+    essentia::Real scale = 0;
+    if (type == "unit_max") {
+        for (essentia::Real value : chroma) scale = std::max(scale, value);
+    } else if (type == "unit_sum") {
+        for (essentia::Real value : chroma) scale += value;
+    } else {
+        return false;
+    }
+    if (scale > 0) {
+        for (essentia::Real& value : chroma) value /= scale;
+    }
+    return true;
+}
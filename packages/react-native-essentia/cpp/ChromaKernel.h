@@ -0,0 +1,56 @@
+// packages/react-native-essentia/cpp/ChromaKernel.h
+#ifndef CHROMA_KERNEL_H
+#define CHROMA_KERNEL_H
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "essentia/essentia.h"
+
+// What a chroma kernel depends on
+struct ChromaKernelKey {
+    double sampleRate = 44100.0;
+    int binsPerOctave = 12;
+    essentia::Real minFrequency = 32.7f;
+    int frameSize = 2048;
+    int numberBins = 84;  // pitch bins above minFrequency folded into the chroma
+
+    bool operator<(const ChromaKernelKey& other) const {
+        return std::tie(sampleRate, binsPerOctave, minFrequency, frameSize, numberBins) <
+               std::tie(other.sampleRate, other.binsPerOctave, other.minFrequency, other.frameSize,
+                        other.numberBins);
+    }
+};
+
+// Sparse map from the bins of a frameSize-point magnitude spectrum to binsPerOctave
+// chroma bins, for chroma computed from the (cached) STFT instead of a constant-Q
+// transform. Each spectrum bin between minFrequency and the top of the numberBins
+// pitch range is split linearly between the two pitch bins around its log-frequency,
+// so applying the kernel is two multiply-adds per bin.
+//
+// Building it costs one log2 per bin; the wrapper keeps kernels by key.
+class ChromaKernel {
+public:
+    explicit ChromaKernel(const ChromaKernelKey& key);
+
+    const ChromaKernelKey& key() const { return mKey; }
+    int size() const { return mKey.binsPerOctave; }
+    int inputSize() const { return mKey.frameSize / 2 + 1; }
+
+    // chroma = kernel * spectrum (unnormalized); spectrum holds numBins magnitudes
+    void apply(const essentia::Real* spectrum, int numBins, std::vector<essentia::Real>& chroma) const;
+
+    // In place; type is Chromagram's normalizeType ("unit_max", "unit_sum" or "none").
+    // Returns false for an unknown type.
+    static bool normalize(std::vector<essentia::Real>& chroma, const std::string& type);
+
+private:
+    ChromaKernelKey mKey;
+    // One entry per spectrum bin in [mFirstBin, mFirstBin + mLower.size())
+    int mFirstBin = 0;
+    std::vector<int> mLower;                // chroma bin below the bin's pitch
+    std::vector<essentia::Real> mUpperWeight;  // share of the next chroma bin
+};
+
+#endif
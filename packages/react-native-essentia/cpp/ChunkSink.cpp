@@ -0,0 +1,42 @@
+// packages/react-native-essentia/cpp/ChunkSink.cpp
+#include "ChunkSink.h"
+#include "Utils.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+static_assert(sizeof(essentia::Real) == 4, "Chunk sinks write essentia::Real as float32");
+
+FileChunkSink::FileChunkSink(const std::string& path) : mPath(path) {
+    mFile = std::fopen(path.c_str(), "wb");
+    if (!mFile) {
+        throw std::runtime_error("Cannot create " + path + ": " + std::strerror(errno));
+    }
+}
+
+FileChunkSink::~FileChunkSink() {
+    if (mFile) {
+        // finish() was not reached: do not leave a truncated result behind
+        std::fclose(mFile);
+        std::remove(mPath.c_str());
+    }
+}
+
+void FileChunkSink::write(const essentia::Real* rows, int numFrames, int numColumns) {
+    const size_t count = static_cast<size_t>(numFrames) * numColumns;
+    if (std::fwrite(rows, sizeof(essentia::Real), count, mFile) != count) {
+        throw std::runtime_error("Cannot write to " + mPath + ": " + std::strerror(errno));
+    }
+    mBytesWritten += count * sizeof(essentia::Real);
+}
+
+void FileChunkSink::finish() {
+    const bool ok = std::fclose(mFile) == 0;
+    mFile = nullptr;
+    if (!ok) {
+        std::remove(mPath.c_str());
+        throw std::runtime_error("Cannot write to " + mPath + ": " + std::strerror(errno));
+    }
+    LOGI("Wrote %llu bytes to %s", static_cast<unsigned long long>(mBytesWritten), mPath.c_str());
+}
@@ -0,0 +1,56 @@
+// packages/react-native-essentia/cpp/ChunkSink.h
+#ifndef CHUNK_SINK_H
+#define CHUNK_SINK_H
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+#include "essentia/types.h"
+
+// Destination of a frame matrix produced a chunk at a time (chunked mode of
+// FeatureExtractor). Each write hands over numFrames rows of numColumns values,
+// row-major, and the producer reuses that memory for the next chunk, so it only
+// ever holds one chunk whatever the length of the audio.
+class ChunkSink {
+public:
+    virtual ~ChunkSink() = default;
+    // May throw to abort the computation
+    virtual void write(const essentia::Real* rows, int numFrames, int numColumns) = 0;
+    // After the last chunk (not called when the computation fails)
+    virtual void finish() {}
+};
+
+class CallbackChunkSink : public ChunkSink {
+public:
+    using Callback = std::function<void(const essentia::Real* rows, int numFrames, int numColumns)>;
+    explicit CallbackChunkSink(Callback callback) : mCallback(std::move(callback)) {}
+    void write(const essentia::Real* rows, int numFrames, int numColumns) override { mCallback(rows, numFrames, numColumns); }
+
+private:
+    Callback mCallback;
+};
+
+// Streams the rows to a file as little-endian float32 values, row-major. The file
+// is created (or truncated) on construction and removed again if the computation
+// fails before finish().
+class FileChunkSink : public ChunkSink {
+public:
+    // Throws if the file cannot be created
+    explicit FileChunkSink(const std::string& path);
+    ~FileChunkSink() override;
+    void write(const essentia::Real* rows, int numFrames, int numColumns) override;
+    void finish() override;
+    uint64_t bytesWritten() const { return mBytesWritten; }
+
+    FileChunkSink(const FileChunkSink&) = delete;
+    FileChunkSink& operator=(const FileChunkSink&) = delete;
+
+private:
+    std::string mPath;
+    FILE* mFile = nullptr;
+    uint64_t mBytesWritten = 0;
+};
+
+#endif
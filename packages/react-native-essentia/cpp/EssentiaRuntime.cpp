@@ -0,0 +1,105 @@
+// packages/react-native-essentia/cpp/EssentiaRuntime.cpp
+#include "EssentiaRuntime.h"
+#include "Utils.h"
+#include "nlohmann/json.hpp"
+
+#include "essentia/algorithmfactory.h"
+#include "essentia/essentia.h"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+std::mutex gRuntimeMutex;
+int gUsers = 0;
+bool gRegistered = false;
+std::atomic<bool> gLazy{true};
+
+std::mutex gCatalogMutex;
+std::string gAlgorithmList;
+std::map<std::string, std::string> gAlgorithmInfo;
+
+// An acquire() for the duration of a catalog read
+struct TemporaryUse {
+    TemporaryUse() { EssentiaRuntime::acquire(); }
+    ~TemporaryUse() { EssentiaRuntime::release(); }
+    TemporaryUse(const TemporaryUse&) = delete;
+    TemporaryUse& operator=(const TemporaryUse&) = delete;
+};
+
+// gRuntimeMutex is held
+void registerLocked() {
+    if (gRegistered) return;
+    auto start = std::chrono::steady_clock::now();
+    essentia::init();
+    gRegistered = true;
+    LOGI("Essentia algorithms registered in %.1f ms",
+         std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+}
+}
+
+void EssentiaRuntime::setLazyRegistration(bool lazy) {
+    gLazy = lazy;
+}
+
+bool EssentiaRuntime::lazyRegistration() {
+    return gLazy;
+}
+
+void EssentiaRuntime::acquire() {
+    std::lock_guard<std::mutex> lock(gRuntimeMutex);
+    if (!gLazy) {
+        registerLocked();
+    }
+    ++gUsers;
+}
+
+void EssentiaRuntime::release() {
+    std::lock_guard<std::mutex> lock(gRuntimeMutex);
+    if (gUsers > 0 && --gUsers == 0 && gRegistered) {
+        essentia::shutdown();
+        gRegistered = false;
+    }
+}
+
+void EssentiaRuntime::ensureRegistered() {
+    std::lock_guard<std::mutex> lock(gRuntimeMutex);
+    if (gUsers == 0) {
+        // Registering now would leave essentia::init without a matching shutdown
+        throw std::logic_error("Essentia runtime used without being acquired (initialize the session first)");
+    }
+    registerLocked();
+}
+
+std::string EssentiaRuntime::algorithmList() {
+    {
+        std::lock_guard<std::mutex> lock(gCatalogMutex);
+        if (!gAlgorithmList.empty()) return gAlgorithmList;
+    }
+    std::string list;
+    {
+        TemporaryUse use;
+        ensureRegistered();
+        list = nlohmann::json(essentia::standard::AlgorithmFactory::instance().keys()).dump();
+    }
+    std::lock_guard<std::mutex> lock(gCatalogMutex);
+    gAlgorithmList = list;
+    return gAlgorithmList;
+}
+
+std::string EssentiaRuntime::algorithmInfo(const std::string& algorithm, const std::function<std::string()>& build) {
+    {
+        std::lock_guard<std::mutex> lock(gCatalogMutex);
+        auto found = gAlgorithmInfo.find(algorithm);
+        if (found != gAlgorithmInfo.end()) return found->second;
+    }
+    std::string info = build();
+    if (info.compare(0, 15, "{\"success\":true") == 0) {
+        std::lock_guard<std::mutex> lock(gCatalogMutex);
+        gAlgorithmInfo.emplace(algorithm, info);
+    }
+    return info;
+}
@@ -0,0 +1,44 @@
+// packages/react-native-essentia/cpp/EssentiaRuntime.h
+#ifndef ESSENTIA_RUNTIME_H
+#define ESSENTIA_RUNTIME_H
+
+#include <functional>
+#include <string>
+
+// Process-wide Essentia state shared by every EssentiaWrapper session.
+//
+// essentia::init registers every algorithm of the library with the factory, which is
+// a visible part of module start-up. Sessions acquire() the runtime when they are
+// initialized and release() it when destroyed; with lazy registration (the default)
+// essentia::init only runs when the first algorithm is created, from
+// ensureRegistered(), so initialize() itself is cheap. essentia::shutdown runs
+// once the last session is released.
+//
+// Which algorithms the library contains at all is decided when it is built: set
+// ESSENTIA_INCLUDE_ALGOS for build-essentia-android.sh / build-essentia-ios.sh.
+//
+// Algorithm metadata (getAllAlgorithms, getAlgorithmInfo) never changes once the
+// factory is filled, so it is built once per process and then served from memory.
+class EssentiaRuntime {
+public:
+    // Lazy by default; switching to eager registers at the next acquire()
+    static void setLazyRegistration(bool lazy);
+    static bool lazyRegistration();
+
+    // Throws if essentia::init fails (eager mode only)
+    static void acquire();
+    static void release();
+    // Must be called before using the algorithm factory, by a caller that holds an
+    // acquire() (so a release() pairs every essentia::init with a shutdown); throws
+    // std::logic_error otherwise, or if essentia::init fails
+    static void ensureRegistered();
+
+    // JSON array of the registered algorithm names; acquires the runtime for as long as
+    // it reads the factory, so it can be called without a session
+    static std::string algorithmList();
+    // Response built by build() the first time an algorithm is asked for; only
+    // success responses are kept
+    static std::string algorithmInfo(const std::string& algorithm, const std::function<std::string()>& build);
+};
+
+#endif
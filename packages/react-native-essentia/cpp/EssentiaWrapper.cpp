@@ -1,22 +1,20 @@
 // packages/react-native-essentia/cpp/EssentiaWrapper.cpp
 #include "EssentiaWrapper.h"
+#include "EssentiaRuntime.h"
+#include "PipelinePlan.h"
+#include "ResultCache.h"
+#include "TonnetzKernel.h"
 #include "Utils.h"
+#include "WorkerPool.h"
 #include "nlohmann/json.hpp"
 
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+
 // Use the json library with a namespace alias for convenience
 using json = nlohmann::json;
 
-// Define the Tonnetz transformation matrix as a constant (add near the top with other constants)
-const std::array<std::array<float, 12>, 6> EssentiaWrapper::TONNETZ_MATRIX = {{
-    {1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0},
-    {0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0},
-    {0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0},
-    {0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1},
-    {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0},
-    {0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}
-}};
-
-
 // Map of primary output names for common Essentia algorithms
 const std::map<std::string, std::string> EssentiaWrapper::primaryOutputs = {
     {"MFCC", "mfcc"},
@@ -60,8 +58,12 @@ EssentiaWrapper::EssentiaWrapper() : mIsInitialized(false), sampleRate(44100.0),
 
 
 EssentiaWrapper::~EssentiaWrapper() {
+    // Pooled algorithms must be deleted while Essentia is still initialized
+    pipelinePlans.clear();
+    chromagramAlgorithms.clear();
+    algorithmPool.clear();
     if (mIsInitialized) {
-        essentia::shutdown();
+        EssentiaRuntime::release();
         mIsInitialized = false;
     }
 }
@@ -75,8 +77,9 @@ bool EssentiaWrapper::initialize() {
             return true;
         }
 
-        // Initialize Essentia
-        essentia::init();
+        // Algorithms are registered here only when lazy registration is off,
+        // otherwise on the first algorithm this process creates
+        EssentiaRuntime::acquire();
         mIsInitialized = true;
 
         LOGI("Essentia initialized successfully");
@@ -88,35 +91,217 @@ bool EssentiaWrapper::initialize() {
 }
 
 bool EssentiaWrapper::setAudioData(const std::vector<essentia::Real>& data, double rate) {
+    // One copy, with room for the padding sample
+    std::vector<essentia::Real> buffer;
+    buffer.reserve(data.size() + data.size() % 2);
+    buffer.assign(data.begin(), data.end());
+    return setAudioData(std::move(buffer), rate);
+}
+
+bool EssentiaWrapper::setAudioData(std::vector<essentia::Real>&& data, double rate) {
     if (data.empty()) {
         return false;
     }
 
     try {
-        audioBuffer.clear();
-        spectrumComputed = false;
-        cachedSpectrum.clear();
-        allSpectra.clear();
+        clearSpectrumCache();
 
-        audioBuffer = data;
+        audioBuffer = std::move(data);
+        rangeSignal.clear();
+        audioHashValid = false;
 
+        // Algorithms bind the buffer as a std::vector, so the padding is a real sample;
+        // it only reallocates when the caller did not leave room for it
         if (audioBuffer.size() % 2 != 0) {
             audioBuffer.push_back(0.0);
         }
 
         sampleRate = rate;
 
-        std::cout << "Audio data set successfully: " << audioBuffer.size()
-                  << " samples at " << sampleRate << " Hz" << std::endl;
+        LOGI("Audio data set: %zu samples at %g Hz", audioBuffer.size(), sampleRate);
 
         return true;
     } catch (const std::exception& e) {
-        std::cerr << "Error setting audio data: " << e.what() << std::endl;
+        LOGE("Error setting audio data: %s", e.what());
         return false;
     }
 }
 
+uint64_t EssentiaWrapper::getAudioHash() {
+    if (!audioHashValid) {
+        audioHash = ResultCache::hash(audioBuffer.data(), audioBuffer.size() * sizeof(essentia::Real));
+        audioHashValid = true;
+    }
+    return audioHash;
+}
+
+namespace {
+const char* const kSampleRangeKeys[] = {"startSample", "endSample", "startTime", "endTime"};
+
+// Resets a cached algorithm when the computation using it ends, also when it
+// throws, so the next caller does not inherit its state
+struct ResetOnExit {
+    explicit ResetOnExit(essentia::standard::Algorithm* algo) : mAlgo(algo) {}
+    ~ResetOnExit() {
+        try {
+            mAlgo->reset();
+        } catch (const std::exception& e) {
+            LOGE("Error resetting %s: %s", mAlgo->name().c_str(), e.what());
+        }
+    }
+    ResetOnExit(const ResetOnExit&) = delete;
+    ResetOnExit& operator=(const ResetOnExit&) = delete;
+
+private:
+    essentia::standard::Algorithm* mAlgo;
+};
+}
+
+std::string EssentiaWrapper::takeSampleRange(std::map<std::string, essentia::Parameter>& params, SampleRange& range) const {
+    nlohmann::json spec = nlohmann::json::object();
+    for (const char* key : kSampleRangeKeys) {
+        auto it = params.find(key);
+        if (it == params.end()) continue;
+        if (it->second.type() == essentia::Parameter::INT) {
+            spec[key] = it->second.toInt();
+        } else if (it->second.type() == essentia::Parameter::REAL) {
+            spec[key] = it->second.toReal();
+        } else {
+            return createErrorResponse(std::string(key) + " must be a number", "INVALID_PARAM");
+        }
+        params.erase(it);
+    }
+    return resolveSampleRange(spec, range);
+}
+
+std::string EssentiaWrapper::resolveSampleRange(const nlohmann::json& spec, SampleRange& range) const {
+    int64_t bounds[2] = {0, -1};  // start, end (-1: to the end of the audio)
+    for (int i = 0; i < 2; ++i) {
+        const char* sampleKey = kSampleRangeKeys[i];
+        const char* timeKey = kSampleRangeKeys[i + 2];
+        for (const char* key : {timeKey, sampleKey}) {
+            if (!spec.is_object() || !spec.contains(key)) continue;
+            if (!spec[key].is_number()) {
+                return createErrorResponse(std::string(key) + " must be a number", "INVALID_PARAM");
+            }
+            double value = spec[key].get<double>();
+            bounds[i] = static_cast<int64_t>(std::llround(key == timeKey ? value * sampleRate : value));
+        }
+    }
+    return resolveSampleRange(bounds[0], bounds[1], range);
+}
+
+std::string EssentiaWrapper::resolveSampleRange(int64_t startSample, int64_t endSample, SampleRange& range) const {
+    const int64_t total = static_cast<int64_t>(audioBuffer.size());
+    if (startSample < 0) {
+        return createErrorResponse("startSample must not be negative", "INVALID_PARAM");
+    }
+    if (endSample < 0 || endSample > total) {
+        endSample = total;
+    }
+    if (startSample >= endSample) {
+        return createErrorResponse("Sample range [" + std::to_string(startSample) + ", " + std::to_string(endSample) +
+                                   ") is empty for " + std::to_string(total) + " samples of audio", "INVALID_PARAM");
+    }
+    range = SampleRange{static_cast<size_t>(startSample), static_cast<size_t>(endSample)};
+    return "";
+}
+
+const std::vector<essentia::Real>& EssentiaWrapper::analysisSignal() {
+    if (!hasAnalysisRange()) {
+        return audioBuffer;
+    }
+    if (rangeSignal.empty()) {
+        Profiler::Scope stage(profiler, "range");
+        // Padded to even length like setAudioData
+        rangeSignal.reserve(analysisRange.size() + analysisRange.size() % 2);
+        rangeSignal.assign(audioBuffer.begin() + analysisRange.begin, audioBuffer.begin() + analysisRange.end);
+        if (rangeSignal.size() % 2 != 0) {
+            rangeSignal.push_back(0.0);
+        }
+        stage.addBytes(static_cast<int64_t>(rangeSignal.capacity() * sizeof(essentia::Real)));
+    }
+    return rangeSignal;
+}
+
+EssentiaWrapper::RangeScope::RangeScope(EssentiaWrapper& wrapper, const SampleRange& range)
+    : mWrapper(wrapper), mPrevious(wrapper.analysisRange) {
+    if (!(range == mWrapper.analysisRange)) {
+        mWrapper.analysisRange = range;
+        mWrapper.rangeSignal.clear();
+    }
+}
+
+EssentiaWrapper::RangeScope::~RangeScope() {
+    if (!(mPrevious == mWrapper.analysisRange)) {
+        mWrapper.analysisRange = mPrevious;
+        mWrapper.rangeSignal.clear();
+    }
+}
+
+std::pair<int, int> EssentiaWrapper::rangeFrames(const SampleRange& range, int hopSize) {
+    // Frame i of the FrameCutter framing is centred on sample i * hopSize. Every frame
+    // centred before the end of the audio is one of the whole-audio frames.
+    const int first = static_cast<int>((range.begin + hopSize - 1) / hopSize);
+    const int end = static_cast<int>((range.end + hopSize - 1) / hopSize);
+    return {first, std::max(first, end)};
+}
+
+const SpectrumMatrix& EssentiaWrapper::framesInRange(const SpectrumMatrix& spectra, int hopSize, SpectrumMatrix& storage) const {
+    if (!hasAnalysisRange() || hopSize <= 0) {
+        return spectra;
+    }
+
+    const auto frames = rangeFrames(analysisRange, hopSize);
+    const int first = std::min(frames.first, spectra.numFrames);
+    const int end = std::min(frames.second, spectra.numFrames);
+    storage.numBins = spectra.numBins;
+    storage.numFrames = end - first;
+    storage.data.assign(spectra.row(first), spectra.row(end));
+    LOGI("Using spectrum frames [%d, %d) for samples [%zu, %zu)", first, end, analysisRange.begin, analysisRange.end);
+    return storage;
+}
+
+const SpectrumMatrix& EssentiaWrapper::analysisSpectrum(int frameSize, int hopSize, const std::string& windowType,
+                                                        SpectrumMatrix& storage) {
+    if (!hasAnalysisRange() || hopSize <= 0) {
+        return getSpectrum(frameSize, hopSize, windowType);
+    }
+
+    auto cached = spectrumCache.find(SpectrumKey{frameSize, hopSize, windowType});
+    if (cached == spectrumCache.end()) {
+        computeSpectrumFrames(frameSize, hopSize, windowType, analysisRange, storage);
+        return storage;
+    }
+
+    cached->second.lastUse = ++spectrumUseCounter;
+    return framesInRange(cached->second.matrix, hopSize, storage);
+}
+
+std::string EssentiaWrapper::successResponse(const std::string& dataJson) const {
+    std::string response = "{\"success\":true,\"data\":" + dataJson;
+    if (profiler.enabled() && !profiler.empty()) {
+        response += ",\"profile\":" + profiler.toJson().dump();
+    }
+    return response + "}";
+}
+
 std::string EssentiaWrapper::executeAlgorithm(const std::string& algorithm, const std::string& paramsJson) {
+    Profiler::Scope call(profiler, "executeAlgorithm");
+    essentia::Pool pool;
+    std::string error = executeAlgorithm(algorithm, paramsJson, pool);
+    if (!error.empty()) {
+        return error;
+    }
+    std::string dataJson;
+    {
+        Profiler::Scope serialize(profiler, "serialize");
+        dataJson = poolToJson(pool);
+    }
+    return successResponse(dataJson);
+}
+
+std::string EssentiaWrapper::executeAlgorithm(const std::string& algorithm, const std::string& paramsJson, essentia::Pool& pool) {
     if (!mIsInitialized) {
         return createErrorResponse("Essentia is not initialized", "NOT_INITIALIZED");
     }
@@ -143,7 +328,7 @@ std::string EssentiaWrapper::executeAlgorithm(const std::string& algorithm, cons
         }
 
         // Execute the algorithm
-        return executeSpecificAlgorithm(algorithm, params);
+        return executeSpecificAlgorithm(algorithm, params, pool);
     } catch (const std::exception& e) {
         return createErrorResponse(e.what(), "ALGORITHM_EXECUTION_ERROR");
     }
@@ -151,6 +336,180 @@ std::string EssentiaWrapper::executeAlgorithm(const std::string& algorithm, cons
 
 // Execute specific optimized algorithms
 std::string EssentiaWrapper::executeSpecificAlgorithm(const std::string& algorithm, const std::map<std::string, essentia::Parameter>& params) {
+  Profiler::Scope call(profiler, "executeSpecificAlgorithm");
+  essentia::Pool pool;
+  std::string error = executeSpecificAlgorithm(algorithm, params, pool);
+  if (!error.empty()) {
+      return error;
+  }
+  std::string dataJson;
+  {
+      Profiler::Scope serialize(profiler, "serialize");
+      dataJson = poolToJson(pool);
+  }
+  return successResponse(dataJson);
+}
+
+std::string EssentiaWrapper::executeSpecificAlgorithm(const std::string& algorithm, const std::map<std::string, essentia::Parameter>& params,
+                                                      essentia::Pool& pool) {
+  std::string error = validateSpectralParams(algorithm, params);
+  if (!error.empty()) {
+      return error;
+  }
+
+  if (params.count("startSample") || params.count("endSample") || params.count("startTime") || params.count("endTime")) {
+      auto rangeParams = params;
+      SampleRange range;
+      error = takeSampleRange(rangeParams, range);
+      if (!error.empty()) {
+          return error;
+      }
+      RangeScope scope(*this, range);
+      return executeSpecificAlgorithm(algorithm, rangeParams, pool);
+  }
+
+  Profiler::Scope stage(profiler, algorithm);
+  try {
+      if (isSpectralAlgorithm(algorithm)) {
+          LOGI("Processing %s algorithm", algorithm.c_str());
+          SpectralTask task = makeSpectralTask(algorithm, params);
+          LOGI("Using frameSize=%d, hopSize=%d", task.frameSize, task.hopSize);
+          SpectrumMatrix rangeStorage;
+          const SpectrumMatrix& spectra = analysisSpectrum(task.frameSize, task.hopSize, "hann", rangeStorage);
+          if (spectra.empty()) {
+              LOGE("No spectrum frames computed for %s", algorithm.c_str());
+              return createErrorResponse("No valid spectrum frames computed", "NO_DATA");
+          }
+
+          // The cached spectrogram is one block
+          stage.addFrames(spectra.numFrames);
+          processSpectralBlock(task, spectra, pool);
+          finishSpectralTask(task, pool);
+      }
+      else if (algorithm == "Chromagram") {
+          // method "cqt" (default): Essentia's constant-Q Chromagram on long frames.
+          // method "stft": chroma folded from the cached STFT spectrum, much cheaper
+          // but with the STFT's low-frequency resolution.
+          auto chromagramParams = params;
+          std::string method = "cqt";
+          if (chromagramParams.count("method")) {
+              method = chromagramParams.at("method").toString();
+              chromagramParams.erase("method");
+          }
+          LOGI("Processing Chromagram algorithm (%s)", method.c_str());
+
+          if (method == "stft") {
+              return computeStftChroma(chromagramParams, pool);
+          }
+          if (method != "cqt") {
+              return createErrorResponse("Unknown Chromagram method: " + method + " (expected cqt or stft)",
+                                         "INVALID_PARAM");
+          }
+
+          // ConstantQ requires 16384 frame size for the given parameters
+          int frameSize = 16384; // Hard-code to required size for ConstantQ
+          int hopSize = frameSize / 4; // Use 1/4 overlap for better analysis
+
+          LOGI("Using fixed frameSize=%d, hopSize=%d for Chromagram (required by ConstantQ)", frameSize, hopSize);
+
+          // Create FrameCutter to split audio into frames
+          auto frameCutter = algorithmPool.checkout("FrameCutter", {
+              {"frameSize", essentia::Parameter(frameSize)},
+              {"hopSize", essentia::Parameter(hopSize)}});
+
+          // Remove frameSize and hopSize from params as they're used for framing
+          chromagramParams.erase("frameSize");
+          chromagramParams.erase("hopSize");
+          AlgorithmPool::Lease& chromagramAlgo = getChromagramAlgorithm(chromagramParams);
+          ResetOnExit resetChromagram(chromagramAlgo.get());
+
+          // Connect inputs and outputs
+          std::vector<essentia::Real> frame;
+          std::vector<essentia::Real> chromagram;
+          frameCutter->input("signal").set(analysisSignal());
+          frameCutter->output("frame").set(frame);
+          chromagramAlgo->input("frame").set(frame);
+          chromagramAlgo->output("chromagram").set(chromagram);
+
+          // Process each frame; results go to the pool with key "chroma" to match JS expectations
+          while (true) {
+              frameCutter->compute();
+              if (frame.empty()) {
+                  break; // No more frames
+              }
+              chromagramAlgo->compute();
+              pool.add("chroma", chromagram);
+              stage.addFrames(1);
+          }
+      }
+      else if (algorithm == "FrameCutter") {
+          LOGI("Processing FrameCutter algorithm");
+
+          // Remove 'framewise' and 'computeMean' if present (not used by FrameCutter)
+          auto frameCutterParams = params;
+          frameCutterParams.erase("framewise");
+          frameCutterParams.erase("computeMean");
+
+          // Create and configure FrameCutter algorithm
+          auto frameCutter = algorithmPool.checkout("FrameCutter", frameCutterParams);
+
+          // Set input and prepare output
+          frameCutter->input("signal").set(analysisSignal());
+          std::vector<essentia::Real> frame;
+          frameCutter->output("frame").set(frame);
+
+          // Process all frames in a loop
+          std::vector<std::vector<essentia::Real>> frames;
+          int frameCount = 0;
+
+          while (true) {
+              // Clear frame for next iteration
+              frame.clear();
+
+              // Compute next frame
+              frameCutter->compute();
+
+              // Check if we've reached the end of the signal
+              if (frame.empty()) {
+                  LOGD("No more frames to process, total frames: %d", frameCount);
+                  break;
+              }
+
+              // Store the frame and continue
+              frames.push_back(frame);
+              frameCount++;
+
+              if (frameCount % 100 == 0) {
+                  LOGD("Processed %d frames so far", frameCount);
+              }
+          }
+
+          if (frames.empty()) {
+              LOGE("No frames extracted by FrameCutter");
+              return createErrorResponse("No frames could be extracted from audio data", "NO_DATA");
+          }
+
+          // Add each frame individually to the pool
+          for (const auto& frame : frames) {
+              pool.add("frame", frame);
+          }
+          LOGI("Successfully processed %zu frames with FrameCutter", frames.size());
+          stage.addFrames(static_cast<int64_t>(frames.size()));
+      }
+      else {
+          // Fall back to dynamic algorithm handling for any other algorithm
+          LOGI("Falling back to dynamic algorithm for %s", algorithm.c_str());
+          return executeDynamicAlgorithm(algorithm, params, pool);
+      }
+
+      return "";
+  } catch (const std::exception& e) {
+      return createErrorResponse(e.what(), "ALGORITHM_ERROR");
+  }
+}
+
+std::string EssentiaWrapper::validateSpectralParams(const std::string& algorithm,
+                                                    const std::map<std::string, essentia::Parameter>& params) {
   // Add parameter validation for Tonnetz algorithm
   if (algorithm == "Tonnetz") {
       // Validate frameSize
@@ -203,669 +562,517 @@ std::string EssentiaWrapper::executeSpecificAlgorithm(const std::string& algorit
           }
       }
   }
+  return "";
+}
 
-  essentia::Pool pool;
-  try {
-      int frameSize = 2048;
-      if (params.count("frameSize")) frameSize = params.at("frameSize").toInt();
-      int hopSize = frameSize / 2;
-      if (params.count("hopSize")) hopSize = params.at("hopSize").toInt();
-
-      LOGI("Using frameSize=%d, hopSize=%d", frameSize, hopSize);
-      // Filter out framewise parameter since it's not supported by all algorithms
-      auto algoParams = params;
-      algoParams.erase("framewise"); // Remove framewise if present
-
-      if (algorithm == "MFCC") {
-          LOGI("Processing MFCC algorithm");
-          if (!spectrumComputed || allSpectra.empty()) {
-              computeSpectrum(frameSize, hopSize);
-          }
-          if (allSpectra.empty()) {
-              LOGE("No spectrum frames computed for MFCC");
-              return createErrorResponse("No valid spectrum frames computed", "NO_DATA");
-          }
+bool EssentiaWrapper::isSpectralAlgorithm(const std::string& algorithm) {
+  return algorithm == "MFCC" || algorithm == "MelBands" || algorithm == "SpectralContrast" ||
+         algorithm == "HPCP" || algorithm == "Key" || algorithm == "Tonnetz" || algorithm == "Spectrum";
+}
 
-          auto mfccAlgo = essentia::standard::AlgorithmFactory::create("MFCC");
-          // Filter out "framewise" from params
-          auto mfccParams = params;
-          mfccParams.erase("framewise");
-          mfccAlgo->configure(convertToParameterMap(mfccParams));
-
-          LOGI("Processing %zu spectrum frames through MFCC", allSpectra.size());
-          std::vector<std::vector<essentia::Real>> mfccFrames;
-          std::vector<std::vector<essentia::Real>> bandsFrames;
-          for (const auto& spectrumFrame : allSpectra) {
-              std::vector<essentia::Real> mfcc, bands;
+SpectralTask EssentiaWrapper::makeSpectralTask(const std::string& algorithm,
+                                               const std::map<std::string, essentia::Parameter>& params) const {
+  SpectralTask task;
+  task.algorithm = algorithm;
+  task.params = params;
+  if (params.count("frameSize")) task.frameSize = params.at("frameSize").toInt();
+  task.hopSize = task.frameSize / 2;
+  if (params.count("hopSize")) task.hopSize = params.at("hopSize").toInt();
+  task.framewise = params.count("framewise") && params.at("framewise").toBool();
+  task.range = fullRange();
+  return task;
+}
+
+void EssentiaWrapper::processSpectralBlock(SpectralTask& task, const SpectrumMatrix& spectra, essentia::Pool& pool) {
+  const std::string& algorithm = task.algorithm;
+  const auto& params = task.params;
+
+  if (algorithm == "MFCC") {
+      // Filter out "framewise" from params
+      auto mfccParams = params;
+      mfccParams.erase("framewise");
+
+      LOGI("Processing %d spectrum frames through MFCC", spectra.numFrames);
+      std::vector<std::vector<essentia::Real>> mfccFrames(spectra.numFrames);
+      std::vector<std::vector<essentia::Real>> bandsFrames(spectra.numFrames);
+      forEachFrameChunk(spectra.numFrames, [&](int begin, int end) {
+          auto mfccAlgo = algorithmPool.checkout("MFCC", mfccParams);
+          std::vector<essentia::Real> spectrumFrame;  // row staging buffer, reused across frames
+          for (int frameIdx = begin; frameIdx < end; ++frameIdx) {
+              spectra.copyRow(frameIdx, spectrumFrame);
               mfccAlgo->input("spectrum").set(spectrumFrame);
-              mfccAlgo->output("mfcc").set(mfcc);
-              mfccAlgo->output("bands").set(bands);
+              mfccAlgo->output("mfcc").set(mfccFrames[frameIdx]);
+              mfccAlgo->output("bands").set(bandsFrames[frameIdx]);
               mfccAlgo->compute();
-              pool.add("mfcc", mfcc);
-              pool.add("mfcc_bands", bands);
-              LOGI("Added MFCC frame of size %zu", mfcc.size());
           }
+      });
 
-          delete mfccAlgo;
+      for (int frameIdx = 0; frameIdx < spectra.numFrames; ++frameIdx) {
+          pool.add("mfcc", mfccFrames[frameIdx]);
+          pool.add("mfcc_bands", bandsFrames[frameIdx]);
       }
-      else if (algorithm == "Chromagram") {
-          LOGI("Processing Chromagram algorithm");
-
-          // ConstantQ requires 16384 frame size for the given parameters
-          int frameSize = 16384; // Hard-code to required size for ConstantQ
-          int hopSize = frameSize / 4; // Use 1/4 overlap for better analysis
-
-          LOGI("Using fixed frameSize=%d, hopSize=%d for Chromagram (required by ConstantQ)", frameSize, hopSize);
-
-          // Create FrameCutter to split audio into frames
-          auto frameCutter = essentia::standard::AlgorithmFactory::create("FrameCutter",
-              "frameSize", frameSize,
-              "hopSize", hopSize);
-
-          // Create Chromagram algorithm
-          auto chromagramAlgo = essentia::standard::AlgorithmFactory::create("Chromagram");
-          // Remove frameSize and hopSize from params as they're used for framing
-          auto chromagramParams = params;
-          chromagramParams.erase("frameSize");
-          chromagramParams.erase("hopSize");
-          chromagramAlgo->configure(convertToParameterMap(chromagramParams));
-
-          // Connect inputs and outputs
-          std::vector<essentia::Real> frame;
-          frameCutter->input("signal").set(audioBuffer);
-          frameCutter->output("frame").set(frame);
-
-          std::vector<std::vector<essentia::Real>> chromagramFrames;
+      LOGI("Added %d MFCC frames", spectra.numFrames);
+  }
+  else if (algorithm == "Key") {
+      const std::map<std::string, essentia::Parameter> peaksParams = {
+          {"sampleRate", essentia::Parameter(static_cast<float>(sampleRate))},
+          {"maxPeaks", essentia::Parameter(100)},
+          {"magnitudeThreshold", essentia::Parameter(0.0f)}};
+      const std::map<std::string, essentia::Parameter> hpcpParams = {
+          {"size", essentia::Parameter(12)},
+          {"referenceFrequency", essentia::Parameter(440.0f)}};
+
+      const bool doFrameWise = task.framewise;
+      LOGI("Key algorithm: framewise processing = %s", doFrameWise ? "true" : "false");
+
+      // Spectral peaks -> HPCP (-> Key when framewise), each worker with its own instances
+      std::vector<std::vector<essentia::Real>> hpcpFrames(spectra.numFrames);
+      std::vector<std::string> keyFrames(doFrameWise ? spectra.numFrames : 0);
+      std::vector<std::string> scaleFrames(keyFrames.size());
+      std::vector<essentia::Real> strengthFrames(keyFrames.size());
+      std::vector<essentia::Real> firstToSecondRelativeStrengthFrames(keyFrames.size());
+
+      forEachFrameChunk(spectra.numFrames, [&](int begin, int end) {
+          auto spectralPeaksAlgo = algorithmPool.checkout("SpectralPeaks", peaksParams);
+          auto hpcpAlgo = algorithmPool.checkout("HPCP", hpcpParams);
+          AlgorithmPool::Lease keyAlgo;
+          if (doFrameWise) keyAlgo = algorithmPool.checkout("Key", params);
+
+          std::vector<essentia::Real> spectrumFrame;  // row staging buffer, reused across frames
+          std::vector<essentia::Real> frequencies, magnitudes;
+          for (int frameIdx = begin; frameIdx < end; ++frameIdx) {
+              spectra.copyRow(frameIdx, spectrumFrame);
 
-          // Process each frame
-          while (true) {
-              frameCutter->compute();
-              if (frame.empty()) {
-                  break; // No more frames
-              }
+              // Compute spectral peaks
+              spectralPeaksAlgo->input("spectrum").set(spectrumFrame);
+              spectralPeaksAlgo->output("frequencies").set(frequencies);
+              spectralPeaksAlgo->output("magnitudes").set(magnitudes);
+              spectralPeaksAlgo->compute();
 
-              std::vector<essentia::Real> chromagram;
-              chromagramAlgo->input("frame").set(frame);
-              chromagramAlgo->output("chromagram").set(chromagram);
-              chromagramAlgo->compute();
-              chromagramFrames.push_back(chromagram);
-          }
+              // Compute HPCP from peaks
+              std::vector<essentia::Real>& hpcp = hpcpFrames[frameIdx];
+              hpcpAlgo->input("frequencies").set(frequencies);
+              hpcpAlgo->input("magnitudes").set(magnitudes);
+              hpcpAlgo->output("hpcp").set(hpcp);
+              hpcpAlgo->compute();
 
-          // Store results in pool with key "chroma" to match JS expectations
-          for (const auto& frame : chromagramFrames) {
-              pool.add("chroma", frame);
-          }
+              if (!doFrameWise) continue;
 
-          // Clean up
-          delete frameCutter;
-          delete chromagramAlgo;
-      }
-      else if (algorithm == "Key") {
-          LOGI("Processing Key algorithm");
-          if (!spectrumComputed || allSpectra.empty()) {
-              computeSpectrum(frameSize, hopSize);
-          }
-          if (allSpectra.empty()) {
-              LOGE("No spectrum frames computed for Key");
-              return createErrorResponse("No valid spectrum frames computed", "NO_DATA");
+              // Compute Key from HPCP
+              keyAlgo->input("pcp").set(hpcp);
+              keyAlgo->output("key").set(keyFrames[frameIdx]);
+              keyAlgo->output("scale").set(scaleFrames[frameIdx]);
+              keyAlgo->output("strength").set(strengthFrames[frameIdx]);
+              keyAlgo->output("firstToSecondRelativeStrength").set(firstToSecondRelativeStrengthFrames[frameIdx]);
+              keyAlgo->compute();
           }
-
-          // Create SpectralPeaks algorithm
-          auto spectralPeaksAlgo = essentia::standard::AlgorithmFactory::create("SpectralPeaks");
-          spectralPeaksAlgo->configure(
-              "sampleRate", static_cast<float>(sampleRate),
-              "maxPeaks", 100,
-              "magnitudeThreshold", 0.0f
-          );
-
-          // Create HPCP algorithm
-          auto hpcpAlgo = essentia::standard::AlgorithmFactory::create("HPCP");
-          essentia::ParameterMap hpcpParams;
-          hpcpParams.add("size", 12);
-          hpcpParams.add("referenceFrequency", 440.0f);
-          hpcpAlgo->configure(hpcpParams);
-
-          // Create Key algorithm
-          auto keyAlgo = essentia::standard::AlgorithmFactory::create("Key");
-          keyAlgo->configure(convertToParameterMap(params));
-
-          // Check if we should do frame-wise processing
-          bool doFrameWise = params.count("framewise") && params.at("framewise").toBool();
-          LOGI("Key algorithm: framewise processing = %s", doFrameWise ? "true" : "false");
-
-          if (doFrameWise) {
-              LOGI("Starting framewise Key processing");
-              // Process each frame individually and store results as sequences
-              std::vector<std::string> keyFrames;
-              std::vector<std::string> scaleFrames;
-              std::vector<essentia::Real> strengthFrames;
-              std::vector<essentia::Real> firstToSecondRelativeStrengthFrames;
-
-              int frameCount = 0;
-              for (const auto& spectrumFrame : allSpectra) {
-                  frameCount++;
-                  LOGI("Processing Key frame %d of %zu, frame size: %zu",
-                        frameCount, allSpectra.size(), spectrumFrame.size());
-
-                  // Compute spectral peaks
-                  std::vector<essentia::Real> frequencies, magnitudes;
-                  spectralPeaksAlgo->input("spectrum").set(spectrumFrame);
-                  spectralPeaksAlgo->output("frequencies").set(frequencies);
-                  spectralPeaksAlgo->output("magnitudes").set(magnitudes);
-                  spectralPeaksAlgo->compute();
-                  LOGI("Computed spectral peaks for frame %d: %zu peaks", frameCount, frequencies.size());
-
-                  // Compute HPCP from peaks
-                  std::vector<essentia::Real> hpcp;
-                  hpcpAlgo->input("frequencies").set(frequencies);
-                  hpcpAlgo->input("magnitudes").set(magnitudes);
-                  hpcpAlgo->output("hpcp").set(hpcp);
-                  hpcpAlgo->compute();
-                  LOGI("Computed HPCP for frame %d, hpcp size: %zu", frameCount, hpcp.size());
-
-                  // Compute Key from HPCP
-                  std::string key, scale;
-                  essentia::Real strength, firstToSecondRelativeStrength;
-                  keyAlgo->input("pcp").set(hpcp);
-                  keyAlgo->output("key").set(key);
-                  keyAlgo->output("scale").set(scale);
-                  keyAlgo->output("strength").set(strength);
-                  keyAlgo->output("firstToSecondRelativeStrength").set(firstToSecondRelativeStrength);
-                  keyAlgo->compute();
-                  LOGI("Computed Key for frame %d: key=%s, scale=%s, strength=%.4f, firstToSecondRelativeStrength=%.4f",
-                        frameCount, key.c_str(), scale.c_str(), strength, firstToSecondRelativeStrength);
-
-                  keyFrames.push_back(key);
-                  scaleFrames.push_back(scale);
-                  strengthFrames.push_back(strength);
-                  firstToSecondRelativeStrengthFrames.push_back(firstToSecondRelativeStrength);
-              }
-
-              pool.add("key_values", keyFrames);
-              pool.add("scale_values", scaleFrames);
-              pool.add("strength_values", strengthFrames);
-              pool.add("first_to_second_relative_strength_values", firstToSecondRelativeStrengthFrames);
-              LOGI("Added %zu key frames", keyFrames.size());
-          } else {
-              // Process the average HPCP for a single result
-              std::vector<essentia::Real> averageHpcp(12, 0.0);
-              int frameCount = 0;
-
-              // Calculate average HPCP across frames
-              for (const auto& spectrumFrame : allSpectra) {
-                  // Compute spectral peaks
-                  std::vector<essentia::Real> frequencies, magnitudes;
-                  spectralPeaksAlgo->input("spectrum").set(spectrumFrame);
-                  spectralPeaksAlgo->output("frequencies").set(frequencies);
-                  spectralPeaksAlgo->output("magnitudes").set(magnitudes);
-                  spectralPeaksAlgo->compute();
-
-                  // Compute HPCP from peaks
-                  std::vector<essentia::Real> hpcp;
-                  hpcpAlgo->input("frequencies").set(frequencies);
-                  hpcpAlgo->input("magnitudes").set(magnitudes);
-                  hpcpAlgo->output("hpcp").set(hpcp);
-                  hpcpAlgo->compute();
-
-                  if (hpcp.size() >= 12) {
-                      for (size_t i = 0; i < 12; ++i) {
-                          averageHpcp[i] += hpcp[i];
-                      }
-                      frameCount++;
-                  }
-              }
-
-              // Normalize the average
-              if (frameCount > 0) {
+      });
+
+      if (doFrameWise) {
+          // Added as whole lists once all blocks are in (finishSpectralTask)
+          task.keyFrames.insert(task.keyFrames.end(), keyFrames.begin(), keyFrames.end());
+          task.scaleFrames.insert(task.scaleFrames.end(), scaleFrames.begin(), scaleFrames.end());
+          task.strengthFrames.insert(task.strengthFrames.end(), strengthFrames.begin(), strengthFrames.end());
+          task.firstToSecondRelativeStrengthFrames.insert(task.firstToSecondRelativeStrengthFrames.end(),
+                                                          firstToSecondRelativeStrengthFrames.begin(),
+                                                          firstToSecondRelativeStrengthFrames.end());
+      } else {
+          // Sum HPCP across frames, in frame order so the result does not depend on the
+          // thread count or the block size
+          task.hpcpSum.resize(12, 0.0);
+          for (const auto& hpcp : hpcpFrames) {
+              if (hpcp.size() >= 12) {
                   for (size_t i = 0; i < 12; ++i) {
-                      averageHpcp[i] /= frameCount;
+                      task.hpcpSum[i] += hpcp[i];
                   }
+                  task.hpcpCount++;
               }
-
-              // Compute key on the averaged HPCP
-              std::string key, scale;
-              essentia::Real strength, firstToSecondRelativeStrength;
-              keyAlgo->input("pcp").set(averageHpcp);
-              keyAlgo->output("key").set(key);
-              keyAlgo->output("scale").set(scale);
-              keyAlgo->output("strength").set(strength);
-              keyAlgo->output("firstToSecondRelativeStrength").set(firstToSecondRelativeStrength);
-              keyAlgo->compute();
-
-              pool.set("key", key);
-              pool.set("scale", scale);
-              pool.set("strength", strength);
-              pool.set("first_to_second_relative_strength", firstToSecondRelativeStrength);
-              LOGI("Computed key: %s %s (strength: %f, firstToSecondRelativeStrength: %f)",
-                    key.c_str(), scale.c_str(), strength, firstToSecondRelativeStrength);
           }
-
-          // Clean up algorithms
-          delete spectralPeaksAlgo;
-          delete hpcpAlgo;
-          delete keyAlgo;
       }
-      else if (algorithm == "Tonnetz") {
-          LOGI("Processing Tonnetz algorithm");
-
-          // Validate parameters
-          if (params.count("frameSize")) {
-              int frameSize = params.at("frameSize").toInt();
-              if (frameSize <= 0) {
-                  LOGE("Invalid frameSize parameter: %d", frameSize);
-                  return createErrorResponse("frameSize must be positive", "INVALID_PARAM");
-              }
-              // Check if power of 2 for FFT efficiency
-              if ((frameSize & (frameSize - 1)) != 0) {
-                  LOGW("frameSize should be a power of 2 for efficient FFT");
-              }
-          }
-
-          if (params.count("hopSize")) {
-              int hopSize = params.at("hopSize").toInt();
-              if (hopSize <= 0) {
-                  LOGE("Invalid hopSize parameter: %d", hopSize);
-                  return createErrorResponse("hopSize must be positive", "INVALID_PARAM");
-              }
-          }
-
-          // Check if spectrum is computed; if not, compute it
-          if (!spectrumComputed || allSpectra.empty()) {
-              computeSpectrum(frameSize, hopSize);
-              if (allSpectra.empty()) {
-                  LOGE("No spectrum frames computed for Tonnetz");
-                  return createErrorResponse("No valid spectrum frames computed from audio data", "NO_DATA");
-              }
-          }
-
-          // Create SpectralPeaks algorithm
-          auto spectralPeaksAlgo = essentia::standard::AlgorithmFactory::create("SpectralPeaks");
-          spectralPeaksAlgo->configure(
-              "sampleRate", static_cast<float>(sampleRate),
-              "maxPeaks", 100,              // Limit the number of peaks
-              "magnitudeThreshold", 0.0f    // Minimum magnitude threshold
-          );
-
-          // Create HPCP algorithm
-          auto hpcpAlgo = essentia::standard::AlgorithmFactory::create("HPCP");
-          essentia::ParameterMap hpcpParams;
-          hpcpParams.add("size", 12); // Fixed size for Tonnetz (12 pitch classes)
-          hpcpParams.add("referenceFrequency", params.count("referenceFrequency") ?
-                  params.at("referenceFrequency").toReal() : 440.0f);
-          hpcpAlgo->configure(hpcpParams);
-
-          LOGI("Processing %zu spectrum frames through Tonnetz", allSpectra.size());
-
-          // Process each spectrum frame
-          for (const auto& spectrumFrame : allSpectra) {
+  }
+  else if (algorithm == "Tonnetz") {
+      const std::map<std::string, essentia::Parameter> peaksParams = {
+          {"sampleRate", essentia::Parameter(static_cast<float>(sampleRate))},
+          {"maxPeaks", essentia::Parameter(100)},              // Limit the number of peaks
+          {"magnitudeThreshold", essentia::Parameter(0.0f)}};  // Minimum magnitude threshold
+      const std::map<std::string, essentia::Parameter> hpcpParams = {
+          {"size", essentia::Parameter(12)}, // Fixed size for Tonnetz (12 pitch classes)
+          {"referenceFrequency", essentia::Parameter(params.count("referenceFrequency") ?
+              params.at("referenceFrequency").toReal() : 440.0f)}};
+
+      LOGI("Processing %d spectrum frames through Tonnetz", spectra.numFrames);
+
+      // HPCP rows land in one contiguous matrix; each chunk then normalizes and
+      // projects its rows in a single pass
+      std::vector<essentia::Real> hpcpRows(static_cast<size_t>(spectra.numFrames) * kTonnetzHpcpSize, 0.0f);
+      std::vector<essentia::Real> tonnetzRows(static_cast<size_t>(spectra.numFrames) * kTonnetzSize);
+      forEachFrameChunk(spectra.numFrames, [&](int begin, int end) {
+          auto spectralPeaksAlgo = algorithmPool.checkout("SpectralPeaks", peaksParams);
+          auto hpcpAlgo = algorithmPool.checkout("HPCP", hpcpParams);
+
+          std::vector<essentia::Real> spectrumFrame;  // row staging buffer, reused across frames
+          std::vector<essentia::Real> frequencies, magnitudes, hpcp;
+          for (int frameIdx = begin; frameIdx < end; ++frameIdx) {
+              spectra.copyRow(frameIdx, spectrumFrame);
               // Compute spectral peaks
-              std::vector<essentia::Real> frequencies, magnitudes;
               spectralPeaksAlgo->input("spectrum").set(spectrumFrame);
               spectralPeaksAlgo->output("frequencies").set(frequencies);
               spectralPeaksAlgo->output("magnitudes").set(magnitudes);
               spectralPeaksAlgo->compute();
 
               // Compute HPCP from peaks
-              std::vector<essentia::Real> hpcp;
               hpcpAlgo->input("frequencies").set(frequencies);
               hpcpAlgo->input("magnitudes").set(magnitudes);
               hpcpAlgo->output("hpcp").set(hpcp);
               hpcpAlgo->compute();
 
-              // Normalize HPCP (optional but recommended)
-              essentia::normalize(hpcp);
-
-              // Apply Tonnetz transformation
-              std::vector<essentia::Real> tonnetz = applyTonnetzTransform(hpcp);
-              pool.add("tonnetz", tonnetz);
-              LOGI("Added Tonnetz frame of size %zu", tonnetz.size());
+              std::copy_n(hpcp.begin(), std::min<size_t>(hpcp.size(), kTonnetzHpcpSize),
+                          hpcpRows.begin() + static_cast<size_t>(frameIdx) * kTonnetzHpcpSize);
           }
 
-          // Compute mean if requested
-          bool computeMean = params.count("computeMean") && params.at("computeMean").toBool();
-          if (computeMean) {
-              try {
-                  const auto& tonnetzFrames = pool.value<std::vector<std::vector<essentia::Real>>>("tonnetz");
-                  if (!tonnetzFrames.empty()) {
-                      size_t frameSize = tonnetzFrames[0].size();
-                      std::vector<essentia::Real> meanTonnetz(frameSize, 0.0);
-
-                      for (const auto& frame : tonnetzFrames) {
-                          for (size_t i = 0; i < frameSize; ++i) {
-                              meanTonnetz[i] += frame[i];
-                          }
-                      }
-
-                      for (auto& val : meanTonnetz) {
-                          val /= tonnetzFrames.size();
-                      }
-
-                      pool.set("tonnetz_mean", meanTonnetz);
-                      LOGI("Computed mean Tonnetz values");
-                  } else {
-                      LOGW("No Tonnetz frames available to compute mean");
-                  }
-              } catch (const std::exception& e) {
-                  LOGW("Could not compute mean Tonnetz: %s", e.what());
-                  // Continue execution, this is not a fatal error
-              }
-          }
+          // Normalize HPCP (per frame, to its largest bin) and apply the Tonnetz transformation
+          projectTonnetz(hpcpRows.data() + static_cast<size_t>(begin) * kTonnetzHpcpSize, end - begin,
+                         tonnetzRows.data() + static_cast<size_t>(begin) * kTonnetzSize, true);
+      });
 
-          // Clean up
-          delete spectralPeaksAlgo;
-          delete hpcpAlgo;
+      std::vector<essentia::Real> tonnetz(kTonnetzSize);
+      for (int frameIdx = 0; frameIdx < spectra.numFrames; ++frameIdx) {
+          std::copy_n(tonnetzRows.begin() + static_cast<size_t>(frameIdx) * kTonnetzSize, kTonnetzSize, tonnetz.begin());
+          pool.add("tonnetz", tonnetz);
       }
-      else if (algorithm == "Spectrum") {
-          LOGI("Processing Spectrum algorithm");
-          if (!spectrumComputed || allSpectra.empty()) {
-              computeSpectrum(frameSize, hopSize);
-          }
-          if (allSpectra.empty()) {
-              LOGE("No spectrum frames computed for Spectrum");
-              return createErrorResponse("No valid spectrum frames computed", "NO_DATA");
-          }
-
-          for (const auto& spectrumFrame : allSpectra) {
-              pool.add("spectrum", spectrumFrame);
-              LOGI("Added spectrum frame of size %zu", spectrumFrame.size());
-          }
+      LOGI("Added %d Tonnetz frames", spectra.numFrames);
+  }
+  else if (algorithm == "Spectrum") {
+      std::vector<essentia::Real> spectrumFrame;  // row staging buffer, reused across frames
+      for (int frameIdx = 0; frameIdx < spectra.numFrames; ++frameIdx) {
+          spectra.copyRow(frameIdx, spectrumFrame);
+          pool.add("spectrum", spectrumFrame);
+          LOGD("Added spectrum frame of size %zu", spectrumFrame.size());
       }
-      else if (algorithm == "HPCP") {
-          LOGI("Processing HPCP algorithm");
-          if (!spectrumComputed || allSpectra.empty()) {
-              computeSpectrum(frameSize, hopSize);
-          }
-          if (allSpectra.empty()) {
-              LOGE("No spectrum frames computed for HPCP");
-              return createErrorResponse("No valid spectrum frames computed", "NO_DATA");
-          }
-
-          // Create SpectralPeaks algorithm for better HPCP computation
-          auto spectralPeaksAlgo = essentia::standard::AlgorithmFactory::create("SpectralPeaks");
-          spectralPeaksAlgo->configure(
-              "sampleRate", static_cast<float>(sampleRate),
-              "maxPeaks", params.count("maxPeaks") ? params.at("maxPeaks").toInt() : 100,
-              "magnitudeThreshold", params.count("magnitudeThreshold") ?
-                  params.at("magnitudeThreshold").toReal() : 0.0f
-          );
-
-          // Create HPCP algorithm
-          auto hpcpAlgo = essentia::standard::AlgorithmFactory::create("HPCP");
-          essentia::ParameterMap hpcpParams;
-          hpcpParams.add("size", params.count("size") ? params.at("size").toInt() : 12);
-          hpcpParams.add("referenceFrequency", params.count("referenceFrequency") ?
-              params.at("referenceFrequency").toReal() : 440.0f);
-          hpcpParams.add("harmonics", params.count("harmonics") ? params.at("harmonics").toInt() : 8);
-          hpcpAlgo->configure(hpcpParams);
-
-          LOGI("Processing %zu spectrum frames through HPCP", allSpectra.size());
-
-          // Process each spectrum frame
-          for (const auto& spectrumFrame : allSpectra) {
+  }
+  else if (algorithm == "HPCP") {
+      // SpectralPeaks for better HPCP computation
+      const std::map<std::string, essentia::Parameter> peaksParams = {
+          {"sampleRate", essentia::Parameter(static_cast<float>(sampleRate))},
+          {"maxPeaks", essentia::Parameter(params.count("maxPeaks") ? params.at("maxPeaks").toInt() : 100)},
+          {"magnitudeThreshold", essentia::Parameter(params.count("magnitudeThreshold") ?
+              params.at("magnitudeThreshold").toReal() : 0.0f)}};
+      const std::map<std::string, essentia::Parameter> hpcpParams = {
+          {"size", essentia::Parameter(params.count("size") ? params.at("size").toInt() : 12)},
+          {"referenceFrequency", essentia::Parameter(params.count("referenceFrequency") ?
+              params.at("referenceFrequency").toReal() : 440.0f)},
+          {"harmonics", essentia::Parameter(params.count("harmonics") ? params.at("harmonics").toInt() : 8)}};
+
+      LOGI("Processing %d spectrum frames through HPCP", spectra.numFrames);
+
+      // Process each spectrum frame
+      std::vector<std::vector<essentia::Real>> hpcpFrames(spectra.numFrames);
+      forEachFrameChunk(spectra.numFrames, [&](int begin, int end) {
+          auto spectralPeaksAlgo = algorithmPool.checkout("SpectralPeaks", peaksParams);
+          auto hpcpAlgo = algorithmPool.checkout("HPCP", hpcpParams);
+
+          std::vector<essentia::Real> spectrumFrame;  // row staging buffer, reused across frames
+          std::vector<essentia::Real> frequencies, magnitudes;
+          for (int frameIdx = begin; frameIdx < end; ++frameIdx) {
+              spectra.copyRow(frameIdx, spectrumFrame);
               // Compute spectral peaks
-              std::vector<essentia::Real> frequencies, magnitudes;
               spectralPeaksAlgo->input("spectrum").set(spectrumFrame);
               spectralPeaksAlgo->output("frequencies").set(frequencies);
               spectralPeaksAlgo->output("magnitudes").set(magnitudes);
               spectralPeaksAlgo->compute();
 
               // Compute HPCP from peaks
-              std::vector<essentia::Real> hpcp;
               hpcpAlgo->input("frequencies").set(frequencies);
               hpcpAlgo->input("magnitudes").set(magnitudes);
-              hpcpAlgo->output("hpcp").set(hpcp);
+              hpcpAlgo->output("hpcp").set(hpcpFrames[frameIdx]);
               hpcpAlgo->compute();
-
-              pool.add("hpcp", hpcp);
-              LOGI("Added HPCP frame of size %zu", hpcp.size());
           }
+      });
 
-          // Compute mean if requested
-          bool computeMean = params.count("computeMean") && params.at("computeMean").toBool();
-          if (computeMean) {
-              try {
-                  const auto& hpcpFrames = pool.value<std::vector<std::vector<essentia::Real>>>("hpcp");
-                  if (!hpcpFrames.empty()) {
-                      size_t frameSize = hpcpFrames[0].size();
-                      std::vector<essentia::Real> meanHpcp(frameSize, 0.0);
-
-                      for (const auto& frame : hpcpFrames) {
-                          for (size_t i = 0; i < frameSize; ++i) {
-                              meanHpcp[i] += frame[i];
-                          }
-                      }
-
-                      for (auto& val : meanHpcp) {
-                          val /= hpcpFrames.size();
-                      }
-
-                      pool.set("hpcp_mean", meanHpcp);
-                      LOGI("Computed mean HPCP values");
-                  } else {
-                      LOGW("No HPCP frames available to compute mean");
-                  }
-              } catch (const std::exception& e) {
-                  LOGW("Could not compute mean HPCP: %s", e.what());
-                  // Continue execution, this is not a fatal error
-              }
-          }
-
-          // Clean up
-          delete spectralPeaksAlgo;
-          delete hpcpAlgo;
+      for (const auto& hpcp : hpcpFrames) {
+          pool.add("hpcp", hpcp);
       }
-      else if (algorithm == "MelBands") {
-          LOGI("Processing MelBands algorithm");
-          if (!spectrumComputed || allSpectra.empty()) {
-              computeSpectrum(frameSize, hopSize);
-          }
-          if (allSpectra.empty()) {
-              LOGE("No spectrum frames computed for MelBands");
-              return createErrorResponse("No valid spectrum frames computed", "NO_DATA");
-          }
-
-          auto melBandsAlgo = essentia::standard::AlgorithmFactory::create("MelBands");
-          // Remove 'framewise' from params to avoid invalid configuration
-          auto melBandsParams = params;
-          melBandsParams.erase("framewise");
-          melBandsAlgo->configure(convertToParameterMap(melBandsParams));
-
-          LOGI("Processing %zu spectrum frames through MelBands", allSpectra.size());
-          for (const auto& spectrumFrame : allSpectra) {
-          std::vector<essentia::Real> bands;
+      LOGI("Added %d HPCP frames", spectra.numFrames);
+  }
+  else if (algorithm == "MelBands") {
+      // Remove 'framewise' from params to avoid invalid configuration
+      auto melBandsParams = params;
+      melBandsParams.erase("framewise");
+
+      LOGI("Processing %d spectrum frames through MelBands", spectra.numFrames);
+      std::vector<std::vector<essentia::Real>> bandsFrames(spectra.numFrames);
+      forEachFrameChunk(spectra.numFrames, [&](int begin, int end) {
+          auto melBandsAlgo = algorithmPool.checkout("MelBands", melBandsParams);
+          std::vector<essentia::Real> spectrumFrame;  // row staging buffer, reused across frames
+          for (int frameIdx = begin; frameIdx < end; ++frameIdx) {
+              spectra.copyRow(frameIdx, spectrumFrame);
               melBandsAlgo->input("spectrum").set(spectrumFrame);
-              melBandsAlgo->output("bands").set(bands);
+              melBandsAlgo->output("bands").set(bandsFrames[frameIdx]);
               melBandsAlgo->compute();
-              pool.add("melbands", bands);
-              LOGI("Added MelBands frame of size %zu", bands.size());
           }
+      });
 
-          // Compute mean if requested
-          bool computeMean = params.count("computeMean") && params.at("computeMean").toBool();
-          if (computeMean) {
-              try {
-                  const auto& melBandsFrames = pool.value<std::vector<std::vector<essentia::Real>>>("melbands");
-                  if (!melBandsFrames.empty()) {
-                      size_t frameSize = melBandsFrames[0].size();
-                      std::vector<essentia::Real> meanMelBands(frameSize, 0.0);
-
-                      for (const auto& frame : melBandsFrames) {
-                          for (size_t i = 0; i < frameSize; ++i) {
-                              meanMelBands[i] += frame[i];
-                          }
-                      }
-
-                      for (auto& val : meanMelBands) {
-                          val /= melBandsFrames.size();
-                      }
-
-                      pool.set("melbands_mean", meanMelBands);
-                      LOGI("Computed mean MelBands values");
-                  } else {
-                      LOGW("No MelBands frames available to compute mean");
-              }
-          } catch (const std::exception& e) {
-                  LOGW("Could not compute mean MelBands: %s", e.what());
-                  // Continue execution, this is not a fatal error
-              }
+      for (const auto& bands : bandsFrames) {
+          pool.add("melbands", bands);
+      }
+      LOGI("Added %d MelBands frames", spectra.numFrames);
+  }
+  else if (algorithm == "SpectralContrast") {
+      // Remove 'framewise' from params to avoid invalid configuration
+      auto spectralContrastParams = params;
+      spectralContrastParams.erase("framewise");
+
+      LOGI("Processing %d spectrum frames through SpectralContrast", spectra.numFrames);
+      std::vector<std::vector<essentia::Real>> contrastFrames(spectra.numFrames);
+      std::vector<std::vector<essentia::Real>> valleyFrames(spectra.numFrames);
+      forEachFrameChunk(spectra.numFrames, [&](int begin, int end) {
+          auto spectralContrastAlgo = algorithmPool.checkout("SpectralContrast", spectralContrastParams);
+          std::vector<essentia::Real> spectrumFrame;  // row staging buffer, reused across frames
+          for (int frameIdx = begin; frameIdx < end; ++frameIdx) {
+              spectra.copyRow(frameIdx, spectrumFrame);
+              spectralContrastAlgo->input("spectrum").set(spectrumFrame);
+              spectralContrastAlgo->output("spectralContrast").set(contrastFrames[frameIdx]);
+              spectralContrastAlgo->output("spectralValley").set(valleyFrames[frameIdx]);
+              spectralContrastAlgo->compute();
           }
+      });
 
-          delete melBandsAlgo;
+      for (int frameIdx = 0; frameIdx < spectra.numFrames; ++frameIdx) {
+          pool.add("spectralContrast", contrastFrames[frameIdx]);
+          pool.add("spectralValley", valleyFrames[frameIdx]);
       }
-      else if (algorithm == "FrameCutter") {
-          LOGI("Processing FrameCutter algorithm");
-
-          // Create and configure FrameCutter algorithm
-          auto frameCutter = essentia::standard::AlgorithmFactory::create("FrameCutter");
-
-          // Remove 'framewise' and 'computeMean' if present (not used by FrameCutter)
-          auto frameCutterParams = params;
-          frameCutterParams.erase("framewise");
-          frameCutterParams.erase("computeMean");
-          frameCutter->configure(convertToParameterMap(frameCutterParams));
-
-          // Set input and prepare output
-          frameCutter->input("signal").set(audioBuffer);
-          std::vector<essentia::Real> frame;
-          frameCutter->output("frame").set(frame);
-
-          // Process all frames in a loop
-          std::vector<std::vector<essentia::Real>> frames;
-          int frameCount = 0;
+      LOGI("Added %d SpectralContrast/SpectralValley frames", spectra.numFrames);
+  }
+}
 
-          while (true) {
-              // Clear frame for next iteration
-              frame.clear();
+void EssentiaWrapper::finishSpectralTask(SpectralTask& task, essentia::Pool& pool) {
+  const std::string& algorithm = task.algorithm;
+  const auto& params = task.params;
+
+  if (algorithm == "Key") {
+      if (task.framewise) {
+          pool.add("key_values", task.keyFrames);
+          pool.add("scale_values", task.scaleFrames);
+          pool.add("strength_values", task.strengthFrames);
+          pool.add("first_to_second_relative_strength_values", task.firstToSecondRelativeStrengthFrames);
+          LOGI("Added %zu key frames", task.keyFrames.size());
+          return;
+      }
 
-              // Compute next frame
-              frameCutter->compute();
+      // Normalize the average
+      std::vector<essentia::Real> averageHpcp = task.hpcpSum;
+      averageHpcp.resize(12, 0.0);
+      if (task.hpcpCount > 0) {
+          for (size_t i = 0; i < 12; ++i) {
+              averageHpcp[i] /= task.hpcpCount;
+          }
+      }
 
-              // Check if we've reached the end of the signal
-              if (frame.empty()) {
-                  LOGI("No more frames to process, total frames: %d", frameCount);
-                  break;
-              }
+      // Compute key on the averaged HPCP
+      auto keyAlgo = algorithmPool.checkout("Key", params);
+      std::string key, scale;
+      essentia::Real strength, firstToSecondRelativeStrength;
+      keyAlgo->input("pcp").set(averageHpcp);
+      keyAlgo->output("key").set(key);
+      keyAlgo->output("scale").set(scale);
+      keyAlgo->output("strength").set(strength);
+      keyAlgo->output("firstToSecondRelativeStrength").set(firstToSecondRelativeStrength);
+      keyAlgo->compute();
+
+      pool.set("key", key);
+      pool.set("scale", scale);
+      pool.set("strength", strength);
+      pool.set("first_to_second_relative_strength", firstToSecondRelativeStrength);
+      LOGI("Computed key: %s %s (strength: %f, firstToSecondRelativeStrength: %f)",
+            key.c_str(), scale.c_str(), strength, firstToSecondRelativeStrength);
+      return;
+  }
 
-              // Store the frame and continue
-              frames.push_back(frame);
-              frameCount++;
+  // Means over all frames, read back from the pool
+  bool computeMean = params.count("computeMean") && params.at("computeMean").toBool();
+  if (!computeMean) return;
 
-              if (frameCount % 100 == 0) {
-                  LOGI("Processed %d frames so far", frameCount);
-              }
-          }
+  std::vector<std::string> descriptors;
+  if (algorithm == "Tonnetz") descriptors = {"tonnetz"};
+  else if (algorithm == "HPCP") descriptors = {"hpcp"};
+  else if (algorithm == "MelBands") descriptors = {"melbands"};
+  else if (algorithm == "SpectralContrast") descriptors = {"spectralContrast", "spectralValley"};
 
+  for (const auto& name : descriptors) {
+      try {
+          const auto& frames = pool.value<std::vector<std::vector<essentia::Real>>>(name);
           if (frames.empty()) {
-              LOGE("No frames extracted by FrameCutter");
-              return createErrorResponse("No frames could be extracted from audio data", "NO_DATA");
+              LOGW("No %s frames available to compute mean", algorithm.c_str());
+              continue;
           }
-
-          // Add each frame individually to the pool
+          size_t frameSize = frames[0].size();
+          std::vector<essentia::Real> mean(frameSize, 0.0);
           for (const auto& frame : frames) {
-              pool.add("frame", frame);
-          }
-          LOGI("Successfully processed %zu frames with FrameCutter", frames.size());
-
-          // Clean up
-          delete frameCutter;
-      }
-      else if (algorithm == "SpectralContrast") {
-          LOGI("Processing SpectralContrast algorithm");
-          if (!spectrumComputed || allSpectra.empty()) {
-              computeSpectrum(frameSize, hopSize);
+              for (size_t i = 0; i < frameSize; ++i) {
+                  mean[i] += frame[i];
+              }
           }
-          if (allSpectra.empty()) {
-              LOGE("No spectrum frames computed for SpectralContrast");
-              return createErrorResponse("No valid spectrum frames computed", "NO_DATA");
+          for (auto& val : mean) {
+              val /= frames.size();
           }
+          pool.set(name + "_mean", mean);
+          LOGI("Computed mean %s values", name.c_str());
+      } catch (const std::exception& e) {
+          LOGW("Could not compute mean %s: %s", algorithm.c_str(), e.what());
+          // Continue execution, this is not a fatal error
+      }
+  }
+}
 
-          auto spectralContrastAlgo = essentia::standard::AlgorithmFactory::create("SpectralContrast");
-          // Remove 'framewise' from params to avoid invalid configuration
-          auto spectralContrastParams = params;
-          spectralContrastParams.erase("framewise");
-          spectralContrastAlgo->configure(convertToParameterMap(spectralContrastParams));
+std::string EssentiaWrapper::executeSpectralTasks(std::vector<SpectralTask>& tasks, essentia::Pool& pool) {
+  if (tasks.empty()) return "";
+  const int frameSize = tasks[0].frameSize;
+  const int hopSize = tasks[0].hopSize;
 
-          LOGI("Processing %zu spectrum frames through SpectralContrast", allSpectra.size());
-          for (const auto& spectrumFrame : allSpectra) {
-              std::vector<essentia::Real> spectralContrast, spectralValley;
-              spectralContrastAlgo->input("spectrum").set(spectrumFrame);
-              spectralContrastAlgo->output("spectralContrast").set(spectralContrast);
-              spectralContrastAlgo->output("spectralValley").set(spectralValley);
-              spectralContrastAlgo->compute();
-              pool.add("spectralContrast", spectralContrast);
-              pool.add("spectralValley", spectralValley);
-              LOGI("Added SpectralContrast frame of size %zu and SpectralValley frame of size %zu",
-                   spectralContrast.size(), spectralValley.size());
+  try {
+      RangeScope scope(*this, tasks[0].range);
+
+      // A spectrogram that is already cached is used as is (its rows in the range, with
+      // one); otherwise the frames (of the range) are computed a block at a time and every
+      // task runs on the block before the next one is cut
+      int numFrames = 0;
+      if (spectrumCache.count(SpectrumKey{frameSize, hopSize, "hann"})) {
+          SpectrumMatrix rangeStorage;
+          const SpectrumMatrix& spectra = analysisSpectrum(frameSize, hopSize, "hann", rangeStorage);
+          for (auto& task : tasks) {
+              Profiler::Scope stage(profiler, task.algorithm);
+              stage.addFrames(spectra.numFrames);
+              processSpectralBlock(task, spectra, pool);
           }
-
-          // Compute mean if requested
-          bool computeMean = params.count("computeMean") && params.at("computeMean").toBool();
-          if (computeMean) {
-              try {
-                  const auto& contrastFrames = pool.value<std::vector<std::vector<essentia::Real>>>("spectralContrast");
-                  const auto& valleyFrames = pool.value<std::vector<std::vector<essentia::Real>>>("spectralValley");
-
-                  if (!contrastFrames.empty() && !valleyFrames.empty()) {
-                      size_t contrastSize = contrastFrames[0].size();
-                      size_t valleySize = valleyFrames[0].size();
-
-                      std::vector<essentia::Real> meanContrast(contrastSize, 0.0);
-                      std::vector<essentia::Real> meanValley(valleySize, 0.0);
-
-                      for (const auto& frame : contrastFrames) {
-                          for (size_t i = 0; i < contrastSize; ++i) {
-                              meanContrast[i] += frame[i];
-                          }
-                      }
-
-                      for (const auto& frame : valleyFrames) {
-                          for (size_t i = 0; i < valleySize; ++i) {
-                              meanValley[i] += frame[i];
-                          }
-                      }
-
-                      for (auto& val : meanContrast) {
-                          val /= contrastFrames.size();
-                      }
-
-                      for (auto& val : meanValley) {
-                          val /= valleyFrames.size();
-                      }
-
-                      pool.set("spectralContrast_mean", meanContrast);
-                      pool.set("spectralValley_mean", meanValley);
-                      LOGI("Computed mean SpectralContrast and SpectralValley values");
-                  } else {
-                      LOGW("No SpectralContrast frames available to compute mean");
-                  }
-              } catch (const std::exception& e) {
-                  LOGW("Could not compute mean SpectralContrast: %s", e.what());
-                  // Continue execution, this is not a fatal error
-              }
+          numFrames = spectra.numFrames;
+          if (numFrames > 0) {
+              // Keep the last spectrum for backward compatibility (see computeSpectrum)
+              cachedSpectrum.assign(spectra.row(numFrames - 1), spectra.row(numFrames - 1) + spectra.numBins);
           }
-
-          delete spectralContrastAlgo;
+      } else {
+          SpectrumMatrix block;
+          computeSpectrumFrames(frameSize, hopSize, "hann", analysisRange, block, kSpectralBlockFrames, [&]() {
+              for (auto& task : tasks) {
+                  Profiler::Scope stage(profiler, task.algorithm);
+                  stage.addFrames(block.numFrames);
+                  processSpectralBlock(task, block, pool);
+              }
+              numFrames += block.numFrames;
+              // Keep the last spectrum for backward compatibility (see computeSpectrum)
+              cachedSpectrum.assign(block.row(block.numFrames - 1), block.row(block.numFrames - 1) + block.numBins);
+          });
       }
-      else {
-          // Fall back to dynamic algorithm handling for any other algorithm
-          LOGI("Falling back to dynamic algorithm for %s", algorithm.c_str());
-          return executeDynamicAlgorithm(algorithm, params);
+      spectrumComputed = numFrames > 0;
+
+      if (numFrames == 0) {
+          LOGE("No spectrum frames computed for %s", tasks[0].algorithm.c_str());
+          return createErrorResponse("No valid spectrum frames computed", "NO_DATA");
       }
 
-      // Convert the pool to JSON and wrap in success format
-      std::string dataJson = poolToJson(pool);
-      return "{\"success\":true,\"data\":" + dataJson + "}";
+      for (auto& task : tasks) {
+          Profiler::Scope stage(profiler, task.algorithm);
+          finishSpectralTask(task, pool);
+      }
+      LOGI("Processed %zu spectral features over %d frames (frameSize=%d, hopSize=%d)",
+           tasks.size(), numFrames, frameSize, hopSize);
+      return "";
   } catch (const std::exception& e) {
       return createErrorResponse(e.what(), "ALGORITHM_ERROR");
   }
 }
 
+std::string EssentiaWrapper::computeStftChroma(const std::map<std::string, essentia::Parameter>& params,
+                                               essentia::Pool& pool) {
+  ChromaKernelKey key;
+  key.sampleRate = params.count("sampleRate") ? params.at("sampleRate").toReal() : sampleRate;
+  if (params.count("binsPerOctave")) key.binsPerOctave = params.at("binsPerOctave").toInt();
+  if (params.count("minFrequency")) key.minFrequency = params.at("minFrequency").toReal();
+  if (params.count("numberBins")) key.numberBins = params.at("numberBins").toInt();
+  if (params.count("frameSize")) key.frameSize = params.at("frameSize").toInt();
+  const int hopSize = params.count("hopSize") ? params.at("hopSize").toInt() : key.frameSize / 2;
+  const std::string windowType = params.count("windowType") ? params.at("windowType").toString() : "hann";
+  const std::string normalizeType = params.count("normalizeType") ? params.at("normalizeType").toString() : "unit_max";
+
+  if (key.binsPerOctave <= 0 || key.numberBins <= 0 || key.minFrequency <= 0 || key.sampleRate <= 0 ||
+      key.frameSize <= 0 || hopSize <= 0) {
+      return createErrorResponse("Chromagram stft method needs positive binsPerOctave, numberBins, minFrequency, "
+                                 "sampleRate, frameSize and hopSize", "INVALID_PARAM");
+  }
+  if (normalizeType != "unit_max" && normalizeType != "unit_sum" && normalizeType != "none") {
+      return createErrorResponse("Unknown normalizeType: " + normalizeType, "INVALID_PARAM");
+  }
+
+  LOGI("Using frameSize=%d, hopSize=%d for STFT chroma", key.frameSize, hopSize);
+  Profiler::Scope stage(profiler, "ChromaKernel");
+  const ChromaKernel& kernel = getChromaKernel(key);
+  SpectrumMatrix rangeStorage;
+  const SpectrumMatrix& spectra = analysisSpectrum(key.frameSize, hopSize, windowType, rangeStorage);
+  if (spectra.empty()) {
+      return createErrorResponse("No valid spectrum frames computed", "NO_DATA");
+  }
+
+  std::vector<essentia::Real> chroma;
+  stage.addFrames(spectra.numFrames);
+  for (int frameIdx = 0; frameIdx < spectra.numFrames; ++frameIdx) {
+      kernel.apply(spectra.row(frameIdx), spectra.numBins, chroma);
+      ChromaKernel::normalize(chroma, normalizeType);
+      pool.add("chroma", chroma);
+  }
+  return "";
+}
+
+const ChromaKernel& EssentiaWrapper::getChromaKernel(const ChromaKernelKey& key) {
+  auto it = chromaKernels.find(key);
+  if (it != chromaKernels.end()) {
+      return *it->second;
+  }
+  if (chromaKernels.size() >= kMaxCachedChromaKernels) {
+      chromaKernels.erase(chromaKernels.begin());
+  }
+  LOGI("Building chroma kernel (frameSize=%d, binsPerOctave=%d)", key.frameSize, key.binsPerOctave);
+  auto& kernel = chromaKernels[key];
+  kernel.reset(new ChromaKernel(key));
+  return *kernel;
+}
+
+AlgorithmPool::Lease& EssentiaWrapper::getChromagramAlgorithm(const std::map<std::string, essentia::Parameter>& params) {
+  const std::string key = AlgorithmPool::canonicalKey("Chromagram", params);
+  auto it = chromagramAlgorithms.find(key);
+  if (it != chromagramAlgorithms.end()) {
+      return it->second;
+  }
+  if (chromagramAlgorithms.size() >= kMaxCachedChromaKernels) {
+      chromagramAlgorithms.erase(chromagramAlgorithms.begin());
+  }
+  LOGI("Building constant-Q Chromagram kernel");
+  // Checked out before inserting, so a configure error leaves no empty entry
+  AlgorithmPool::Lease lease = algorithmPool.checkout("Chromagram", params);
+  return chromagramAlgorithms.emplace(key, std::move(lease)).first->second;
+}
+
 // Execute dynamic algorithm
 std::string EssentiaWrapper::executeDynamicAlgorithm(const std::string& algorithm, const std::map<std::string, essentia::Parameter>& params) {
-  try {
-      // Get algorithm factory
-      essentia::standard::AlgorithmFactory& factory = essentia::standard::AlgorithmFactory::instance();
+  Profiler::Scope call(profiler, "executeDynamicAlgorithm");
+  essentia::Pool pool;
+  std::string error;
+  {
+      Profiler::Scope stage(profiler, algorithm);
+      error = executeDynamicAlgorithm(algorithm, params, pool);
+  }
+  if (!error.empty()) {
+      return error;
+  }
+  std::string dataJson;
+  {
+      Profiler::Scope serialize(profiler, "serialize");
+      dataJson = poolToJson(pool);
+  }
+  return successResponse(dataJson);
+}
 
+std::string EssentiaWrapper::executeDynamicAlgorithm(const std::string& algorithm, const std::map<std::string, essentia::Parameter>& params,
+                                                     essentia::Pool& pool) {
+  try {
       // Create a copy of params that we can modify if needed
       std::map<std::string, essentia::Parameter> modifiedParams = params;
 
@@ -883,207 +1090,213 @@ std::string EssentiaWrapper::executeDynamicAlgorithm(const std::string& algorith
           }
       }
 
-      // First create the algorithm without parameters
-      essentia::standard::Algorithm* algo = factory.create(algorithm);
+      // Check out a configured instance (created and configured on first use)
+      auto algo = algorithmPool.checkout(algorithm, modifiedParams);
 
-      // Then configure it with the parameters
-      if (!modifiedParams.empty()) {
-          essentia::ParameterMap algoParams = convertToParameterMap(modifiedParams);
-          algo->configure(algoParams);
+      // Port types are resolved once per algorithm; later calls reuse the buffers
+      auto binding = dynamicBindings.find(algorithm);
+      if (binding == dynamicBindings.end()) {
+          binding = dynamicBindings.emplace(algorithm, PortBinding::resolve(*algo.get())).first;
       }
+      binding->second.bind(*algo.get(), analysisSignal(), static_cast<essentia::Real>(sampleRate));
 
-      // Prepare storage for inputs and outputs
-      std::map<std::string, void*> inputPointers;
-      std::map<std::string, void*> outputPointers;
+      LOGI("Computing algorithm: %s", algorithm.c_str());
+      try {
+          algo->compute();
+      } catch (...) {
+          if (!binding->second.complete()) algo.discard();
+          throw;
+      }
+      binding->second.collect(algorithm, pool);
 
-      // Set up inputs based on their type
-      for (const auto& input : algo->inputs()) {
-          std::string inputName = input.first;
-          std::string inputType = input.second->typeInfo().name();
+      // Ports without a buffer keep whatever they were last bound to; such an
+      // instance is not safe to hand out again
+      if (!binding->second.complete()) {
+          algo.discard();
+      }
 
-          LOGI("Setting up input: %s of type %s", inputName.c_str(), inputType.c_str());
+      return "";
+  } catch (const std::exception& e) {
+      return createErrorResponse(e.what(), "ALGORITHM_EXECUTION_ERROR");
+  }
+}
 
-          // Handle different input types
-          if (inputType.find("std::vector<essentia::Real>") != std::string::npos) {
-              if (inputName == "frame" || inputName == "signal" || inputName == "audio") {
-                  // Use our audio buffer for these common input names
-                  algo->input(inputName).set(audioBuffer);
-              }
-              else {
-                  // For other vector inputs, create an empty vector
-                  std::vector<essentia::Real>* vec = new std::vector<essentia::Real>();
-                  inputPointers[inputName] = vec;
-                  algo->input(inputName).set(*vec);
-              }
-          }
-          else if (inputType.find("essentia::Real") != std::string::npos) {
-              // For single Real inputs, use 0.0 as default or sample rate for sampleRate input
-              essentia::Real* val = new essentia::Real;
-              *val = (inputName == "sampleRate") ? sampleRate : 0.0;
-              inputPointers[inputName] = val;
-              algo->input(inputName).set(*val);
-          }
-          else if (inputType.find("std::string") != std::string::npos) {
-              // For string inputs, use empty string
-              std::string* str = new std::string("");
-              inputPointers[inputName] = str;
-              algo->input(inputName).set(*str);
-          }
-      }
 
-      // Set up outputs based on their type
-      for (const auto& output : algo->outputs()) {
-          std::string outputName = output.first;
-          std::string outputType = output.second->typeInfo().name();
+void EssentiaWrapper::computeSpectrum(int frameSize, int hopSize) {
+  LOGI("computeSpectrum called with frameSize=%d, hopSize=%d", frameSize, hopSize);
 
-          LOGI("Setting up output: %s of type %s", outputName.c_str(), outputType.c_str());
+  const SpectrumMatrix& spectra = getSpectrum(frameSize, hopSize);
 
-          // Handle different output types
-          if (outputType.find("std::vector<essentia::Real>") != std::string::npos) {
-              std::vector<essentia::Real>* vec = new std::vector<essentia::Real>();
-              outputPointers[outputName] = vec;
-              algo->output(outputName).set(*vec);
-          }
-          else if (outputType.find("essentia::Real") != std::string::npos) {
-              essentia::Real* val = new essentia::Real;
-              outputPointers[outputName] = val;
-              algo->output(outputName).set(*val);
-          }
-          else if (outputType.find("std::string") != std::string::npos) {
-              std::string* str = new std::string();
-              outputPointers[outputName] = str;
-              algo->output(outputName).set(*str);
-          }
-      }
+  // Keep the last spectrum for backward compatibility
+  if (!spectra.empty()) {
+      cachedSpectrum.assign(spectra.row(spectra.numFrames - 1), spectra.row(spectra.numFrames - 1) + spectra.numBins);
+      spectrumComputed = true;
+      LOGI("Spectrum computation successful, cached last spectrum of size %zu", cachedSpectrum.size());
+  } else {
+      spectrumComputed = false;
+      LOGE("No spectrum frames were computed, marking spectrumComputed=false");
+  }
+}
 
-      // Compute the algorithm
-      LOGI("Computing algorithm: %s", algorithm.c_str());
-      algo->compute();
-
-      // Collect the outputs into the pool
-      essentia::Pool pool;
-      for (const auto& output : algo->outputs()) {
-          std::string outputName = output.first;
-          std::string outputType = output.second->typeInfo().name();
-
-          if (outputPointers.find(outputName) != outputPointers.end()) {
-              if (outputType.find("std::vector<essentia::Real>") != std::string::npos) {
-                  std::vector<essentia::Real>* vec = static_cast<std::vector<essentia::Real>*>(outputPointers[outputName]);
-                  pool.set(algorithm + "." + outputName, *vec);
-                  delete vec;
-              }
-              else if (outputType.find("essentia::Real") != std::string::npos) {
-                  essentia::Real* val = static_cast<essentia::Real*>(outputPointers[outputName]);
-                  pool.set(algorithm + "." + outputName, *val);
-                  delete val;
-              }
-              else if (outputType.find("std::string") != std::string::npos) {
-                  std::string* str = static_cast<std::string*>(outputPointers[outputName]);
-                  pool.set(algorithm + "." + outputName, *str);
-                  delete str;
-              }
-          }
-      }
+void EssentiaWrapper::setFrameThreadCount(int count) {
+  frameThreadCount = std::max(1, count);
+  LOGI("Frame thread count set to %d", frameThreadCount.load());
+}
 
-      // Clean up remaining input pointers
-      for (auto& inputPair : inputPointers) {
-          if (inputPair.second) {
-              const std::string& inputName = inputPair.first;
-              const char* typeInfoName = algo->input(inputName).typeInfo().name();
-              std::string typeStr(typeInfoName);
+int EssentiaWrapper::addPipelinePlan(std::unique_ptr<PipelinePlan> plan) {
+  int pipelineId = nextPipelineId++;
+  pipelinePlans[pipelineId] = std::move(plan);
+  return pipelineId;
+}
 
-              if (typeStr.find("std::vector<essentia::Real>") != std::string::npos) {
-                  delete static_cast<std::vector<essentia::Real>*>(inputPair.second);
-              }
-              else if (typeStr.find("essentia::Real") != std::string::npos) {
-                  delete static_cast<essentia::Real*>(inputPair.second);
-              }
-              else if (typeStr.find("std::string") != std::string::npos) {
-                  delete static_cast<std::string*>(inputPair.second);
-              }
-          }
-      }
+PipelinePlan* EssentiaWrapper::getPipelinePlan(int pipelineId) {
+  auto it = pipelinePlans.find(pipelineId);
+  return it != pipelinePlans.end() ? it->second.get() : nullptr;
+}
 
-      // Clean up the algorithm
-      delete algo;
+bool EssentiaWrapper::releasePipelinePlan(int pipelineId) {
+  return pipelinePlans.erase(pipelineId) > 0;
+}
 
-      // Convert results to JSON
-      std::string resultJson = poolToJson(pool);
+void EssentiaWrapper::forEachFrameChunk(int numFrames, const std::function<void(int begin, int end)>& fn) const {
+  if (numFrames <= 0) return;
 
-      // Return success with results
-      return "{\"success\":true,\"data\":" + resultJson + "}";
-  } catch (const std::exception& e) {
-      return createErrorResponse(e.what(), "ALGORITHM_EXECUTION_ERROR");
+  // The shared pool's workers plus the calling thread
+  int workers = std::min(frameThreadCount.load(), (numFrames + kMinFramesPerWorker - 1) / kMinFramesPerWorker);
+  workers = std::min(workers, WorkerPool::shared().maxWorkers() + 1);
+  if (workers <= 1) {
+      fn(0, numFrames);
+      return;
   }
+
+  const int chunkSize = (numFrames + workers - 1) / workers;
+  WorkerPool::shared().run(workers, [&](int w) {
+      const int begin = w * chunkSize;
+      const int end = std::min(numFrames, begin + chunkSize);
+      if (begin < end) fn(begin, end);
+  });
 }
 
+const SpectrumMatrix& EssentiaWrapper::getSpectrum(int frameSize, int hopSize, const std::string& windowType) {
+  SpectrumKey key{frameSize, hopSize, windowType};
+  auto cached = spectrumCache.find(key);
+  if (cached != spectrumCache.end()) {
+      cached->second.lastUse = ++spectrumUseCounter;
+      return cached->second.matrix;
+  }
 
-void EssentiaWrapper::computeSpectrum(int frameSize, int hopSize) {
-  LOGI("computeSpectrum called with frameSize=%d, hopSize=%d", frameSize, hopSize);
+  // Make room by dropping the least recently used config
+  if (spectrumCache.size() >= kMaxCachedSpectra) {
+      auto oldest = spectrumCache.begin();
+      for (auto it = spectrumCache.begin(); it != spectrumCache.end(); ++it) {
+          if (it->second.lastUse < oldest->second.lastUse) oldest = it;
+      }
+      spectrumCache.erase(oldest);
+  }
+
+  SpectrumEntry& entry = spectrumCache[key];
+  entry.lastUse = ++spectrumUseCounter;
+  computeSpectrumFrames(frameSize, hopSize, windowType, SampleRange(), entry.matrix);
+  return entry.matrix;
+}
 
-  if (audioBuffer.empty()) {
-      LOGE("Audio buffer is empty, cannot compute spectrum");
+void EssentiaWrapper::computeSpectrumFrames(int frameSize, int hopSize, const std::string& windowType, const SampleRange& range,
+                                            SpectrumMatrix& out, int blockFrames, const std::function<void()>& onBlock) {
+  out = SpectrumMatrix();
+  if (audioBuffer.empty() || frameSize <= 0 || hopSize <= 0) {
+      LOGE("Cannot compute spectrum (audio size: %zu, frameSize=%d, hopSize=%d)",
+           audioBuffer.size(), frameSize, hopSize);
       return;
   }
 
-  LOGI("Audio buffer size: %zu, sample rate: %.1f", audioBuffer.size(), sampleRate);
-
-  essentia::standard::Algorithm* frameCutter = essentia::standard::AlgorithmFactory::create(
-      "FrameCutter", "frameSize", frameSize, "hopSize", hopSize);
-  essentia::standard::Algorithm* windowing = essentia::standard::AlgorithmFactory::create(
-      "Windowing", "type", "hann");
-  essentia::standard::Algorithm* spectrum = essentia::standard::AlgorithmFactory::create("Spectrum");
+  LOGI("Computing spectrum: frameSize=%d, hopSize=%d, window=%s, audio size: %zu",
+       frameSize, hopSize, windowType.c_str(), audioBuffer.size());
+  // With blocks, the stages run on each block are timed on their own
+  Profiler::Scope stage(profiler, "spectrum");
+
+  std::map<std::string, essentia::Parameter> cutterParams = {
+      {"frameSize", essentia::Parameter(frameSize)},
+      {"hopSize", essentia::Parameter(hopSize)}};
+
+  // A range keeps the whole-audio framing: its frames are cut from just the samples they
+  // cover, zero-padded past either end of the audio as the whole-audio FrameCutter does
+  const std::vector<essentia::Real>* signal = &audioBuffer;
+  std::vector<essentia::Real> rangeSamples;
+  int maxFrames = -1;
+  if (!(range == SampleRange()) && !(range == fullRange())) {
+      const auto frames = rangeFrames(range, hopSize);
+      maxFrames = frames.second - frames.first;
+      if (maxFrames == 0) {
+          LOGW("No spectrum frame is centred in samples [%zu, %zu)", range.begin, range.end);
+          return;
+      }
+      const int64_t start = static_cast<int64_t>(frames.first) * hopSize - frameSize / 2;
+      rangeSamples.assign(static_cast<size_t>(maxFrames - 1) * hopSize + frameSize, 0.0f);
+      const int64_t from = std::max<int64_t>(start, 0);
+      const int64_t to = std::min<int64_t>(start + static_cast<int64_t>(rangeSamples.size()), audioBuffer.size());
+      if (to > from) {
+          std::copy(audioBuffer.begin() + from, audioBuffer.begin() + to, rangeSamples.begin() + (from - start));
+      }
+      signal = &rangeSamples;
+      cutterParams.emplace("startFromZero", essentia::Parameter(true));
+      LOGI("Computing spectrum frames [%d, %d) for samples [%zu, %zu)", frames.first, frames.second, range.begin, range.end);
+  }
 
-  LOGI("Created algorithms: FrameCutter, Windowing, Spectrum");
+  auto frameCutter = algorithmPool.checkout("FrameCutter", cutterParams);
+  auto windowing = algorithmPool.checkout("Windowing", {{"type", essentia::Parameter(windowType)}});
+  auto spectrum = algorithmPool.checkout("Spectrum");
 
   std::vector<essentia::Real> frame, windowedFrame, spectrumFrame;
-  frameCutter->input("signal").set(audioBuffer);
+  frameCutter->input("signal").set(*signal);
   frameCutter->output("frame").set(frame);
   windowing->input("frame").set(frame);
   windowing->output("frame").set(windowedFrame);
   spectrum->input("frame").set(windowedFrame);
   spectrum->output("spectrum").set(spectrumFrame);
 
-  LOGI("Connected algorithm inputs/outputs");
-  allSpectra.clear();
-  LOGI("Cleared previous spectrum data");
+  // One block for the whole spectrogram (sized from the expected frame count), or
+  // one reused block of blockFrames
+  out.numBins = frameSize / 2 + 1;
+  const size_t expectedFrames = blockFrames > 0 ? static_cast<size_t>(blockFrames)
+                                : maxFrames >= 0 ? static_cast<size_t>(maxFrames)
+                                                 : audioBuffer.size() / hopSize + 2;
+  out.data.reserve(expectedFrames * static_cast<size_t>(out.numBins));
 
-  int frameCount = 0;
-  while (true) {
+  int totalFrames = 0;
+  while (totalFrames != maxFrames) {
       frameCutter->compute();
       if (frame.empty()) {
-          LOGI("No more frames to process, breaking loop");
           break;
       }
-
-      frameCount++;
-      LOGI("Processing frame %d, size: %zu", frameCount, frame.size());
-
       windowing->compute();
-      LOGI("Applied windowing, windowed frame size: %zu", windowedFrame.size());
-
       spectrum->compute();
-      LOGI("Computed spectrum, frame size: %zu", spectrumFrame.size());
-
-      allSpectra.push_back(spectrumFrame);
+      if (static_cast<int>(spectrumFrame.size()) != out.numBins) {
+          LOGW("Unexpected spectrum size %zu (expected %d), skipping frame", spectrumFrame.size(), out.numBins);
+          continue;
+      }
+      out.data.insert(out.data.end(), spectrumFrame.begin(), spectrumFrame.end());
+      out.numFrames++;
+      totalFrames++;
+
+      if (blockFrames > 0 && out.numFrames == blockFrames) {
+          onBlock();
+          out.numFrames = 0;
+          out.data.clear();
+      }
   }
-
-  LOGI("Processed total of %d frames, allSpectra size: %zu", frameCount, allSpectra.size());
-
-  // Keep the last spectrum for backward compatibility
-  if (!allSpectra.empty()) {
-      cachedSpectrum = allSpectra.back();
-      spectrumComputed = true;
-      LOGI("Spectrum computation successful, cached last spectrum of size %zu", cachedSpectrum.size());
-  } else {
-      spectrumComputed = false;
-      LOGE("No spectrum frames were computed, marking spectrumComputed=false");
+  if (blockFrames > 0 && out.numFrames > 0) {
+      onBlock();
   }
+  stage.addFrames(totalFrames);
+  stage.addBytes(static_cast<int64_t>((out.data.capacity() + rangeSamples.capacity()) * sizeof(essentia::Real)));
 
-  delete frameCutter;
-  delete windowing;
-  delete spectrum;
-  LOGI("Cleaned up algorithm resources");
+  LOGI("Processed total of %d spectrum frames of %d bins", totalFrames, out.numBins);
+}
+
+void EssentiaWrapper::clearSpectrumCache() {
+  spectrumCache.clear();
+  spectrumComputed = false;
+  cachedSpectrum.clear();
 }
 
 
@@ -1099,64 +1312,58 @@ std::string EssentiaWrapper::getAlgorithmInfo(const std::string& algorithm) {
         return createErrorResponse("Algorithm name cannot be empty", "INVALID_ALGORITHM");
     }
 
-    LOGI("Getting information for algorithm: %s", algorithm.c_str());
-
-    essentia::standard::AlgorithmFactory& factory = essentia::standard::AlgorithmFactory::instance();
+    // Metadata does not depend on the session; the catalog builds it once per process
+    return EssentiaRuntime::algorithmInfo(algorithm, [&]() -> std::string {
+        LOGI("Getting information for algorithm: %s", algorithm.c_str());
 
-    // Check if algorithm exists by attempting to create it
-    essentia::standard::Algorithm* testAlgo = nullptr;
-    try {
-        testAlgo = factory.create(algorithm);
-        if (!testAlgo) {
+        // Check the algorithm exists and inspect its properties with a single (pooled) instance
+        AlgorithmPool::Lease algo;
+        try {
+            algo = algorithmPool.checkout(algorithm);
+        } catch (const std::exception& e) {
+            return createErrorResponse("Algorithm does not exist: " + algorithm, "ALGORITHM_NOT_FOUND");
+        }
+        if (!algo) {
             return createErrorResponse("Algorithm does not exist: " + algorithm, "ALGORITHM_NOT_FOUND");
         }
-        delete testAlgo;
-    } catch (const std::exception& e) {
-        return createErrorResponse("Algorithm does not exist: " + algorithm, "ALGORITHM_NOT_FOUND");
-    }
-
-    // Create algorithm to inspect its properties
-    essentia::standard::Algorithm* algo = factory.create(algorithm);
 
-    // Build the result manually as a string to avoid JSON parsing issues
-    std::string result = "{\"name\":\"" + algorithm + "\",\"inputs\":[";
+        // Build the result manually as a string to avoid JSON parsing issues
+        std::string result = "{\"name\":\"" + algorithm + "\",\"inputs\":[";
 
-    // Get inputs
-    bool firstInput = true;
-    for (const auto& input : algo->inputs()) {
-        if (!firstInput) {
-            result += ",";
+        // Get inputs
+        bool firstInput = true;
+        for (const auto& input : algo->inputs()) {
+            if (!firstInput) {
+                result += ",";
+            }
+            result += "{\"name\":\"" + input.first + "\",\"type\":\"" + input.second->typeInfo().name() + "\"}";
+            firstInput = false;
         }
-        result += "{\"name\":\"" + input.first + "\",\"type\":\"" + input.second->typeInfo().name() + "\"}";
-        firstInput = false;
-    }
 
-    result += "],\"outputs\":[";
+        result += "],\"outputs\":[";
 
-    // Get outputs
-    bool firstOutput = true;
-    for (const auto& output : algo->outputs()) {
-        if (!firstOutput) {
-            result += ",";
+        // Get outputs
+        bool firstOutput = true;
+        for (const auto& output : algo->outputs()) {
+            if (!firstOutput) {
+                result += ",";
+            }
+            result += "{\"name\":\"" + output.first + "\",\"type\":\"" + output.second->typeInfo().name() + "\"}";
+            firstOutput = false;
         }
-        result += "{\"name\":\"" + output.first + "\",\"type\":\"" + output.second->typeInfo().name() + "\"}";
-        firstOutput = false;
-    }
-
-    result += "],\"parameters\":";
 
-    // Get parameters
-    std::map<std::string, essentia::Parameter> params = algo->defaultParameters();
-    std::string paramsJsonStr = paramsMapToJson(params);
-    result += paramsJsonStr;
+        result += "],\"parameters\":";
 
-    result += "}";
+        // Get parameters
+        std::map<std::string, essentia::Parameter> params = algo->defaultParameters();
+        std::string paramsJsonStr = paramsMapToJson(params);
+        result += paramsJsonStr;
 
-    // Clean up
-    delete algo;
+        result += "}";
 
-    // Return success with results
-    return "{\"success\":true,\"data\":" + result + "}";
+        // Return success with results
+        return "{\"success\":true,\"data\":" + result + "}";
+    });
   } catch (const std::exception& e) {
       std::string errorMsg = std::string("Error getting algorithm info: ") + e.what();
       LOGE("%s", errorMsg.c_str());
@@ -1173,17 +1380,8 @@ std::string EssentiaWrapper::getAllAlgorithms() {
 
         LOGI("Getting list of all available algorithms");
 
-        essentia::standard::AlgorithmFactory& factory = essentia::standard::AlgorithmFactory::instance();
-        std::vector<std::string> algos = factory.keys();
-
-        // Create a JSON array of algorithm names
-        json result = json::array();
-        for (const auto& algo : algos) {
-            result.push_back(algo);
-        }
-
-        // Return success with results
-        return "{\"success\":true,\"data\":" + result.dump() + "}";
+        // Built from the factory once per process
+        return "{\"success\":true,\"data\":" + EssentiaRuntime::algorithmList() + "}";
     } catch (const std::exception& e) {
         std::string errorMsg = std::string("Error getting algorithm list: ") + e.what();
         LOGE("%s", errorMsg.c_str());
@@ -1193,16 +1391,11 @@ std::string EssentiaWrapper::getAllAlgorithms() {
 
 // Apply Tonnetz transform (vector version)
 std::vector<essentia::Real> EssentiaWrapper::applyTonnetzTransform(const std::vector<essentia::Real>& hpcp) {
-    // Initialize 6-dimensional Tonnetz vector
-    std::vector<essentia::Real> tonnetz(6, 0.0);
-
-    // Apply Tonnetz transformation with the 6x12 matrix
-    for (int i = 0; i < 6; i++) {
-        for (int j = 0; j < 12; j++) {
-            tonnetz[i] += TONNETZ_MATRIX[i][j] * hpcp[j];
-        }
+    if (hpcp.size() != kTonnetzHpcpSize) {
+        throw std::invalid_argument("HPCP vector must be 12-dimensional, got " + std::to_string(hpcp.size()));
     }
-
+    std::vector<essentia::Real> tonnetz(kTonnetzSize);
+    projectTonnetz(hpcp.data(), 1, tonnetz.data());
     return tonnetz;
 }
 
@@ -1220,7 +1413,7 @@ std::string EssentiaWrapper::findMatchingInputName(essentia::standard::Algorithm
     for (const auto& altName : alternatives) {
         for (const auto& input : algo->inputs()) {
             if (input.first == altName) {
-                LOGI("Using alternative input name: %s instead of %s", altName.c_str(), expectedName.c_str());
+                LOGD("Using alternative input name: %s instead of %s", altName.c_str(), expectedName.c_str());
                 return altName;
             }
         }
@@ -6,6 +6,12 @@
 #include <sstream>
 #include <map>
 #include <set>
+#include <tuple>
+#include <cstdint>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <mutex>
 
 #include "essentia/types.h"
 #include "essentia/essentia.h"
@@ -14,6 +20,12 @@
 #include "essentia/pool.h"
 #include "essentia/version.h"
 #include "Utils.h"
+#include "AlgorithmPool.h"
+#include "ChromaKernel.h"
+#include "PortBinding.h"
+#include "Profiler.h"
+
+class PipelinePlan;
 
 // Platform-specific includes
 #ifdef __ANDROID__
@@ -21,6 +33,46 @@
   // Other Android-specific includes
 #endif
 
+// Magnitude spectrogram for one framing config, stored row-major in one block
+struct SpectrumMatrix {
+    int numFrames = 0;
+    int numBins = 0;
+    std::vector<essentia::Real> data;  // numFrames * numBins
+
+    bool empty() const { return numFrames == 0; }
+    const essentia::Real* row(int frame) const { return data.data() + static_cast<size_t>(frame) * numBins; }
+    // Essentia inputs bind std::vector, so rows are staged through one reused buffer
+    void copyRow(int frame, std::vector<essentia::Real>& out) const { out.assign(row(frame), row(frame) + numBins); }
+};
+
+// A [begin, end) span of the loaded audio, in samples
+struct SampleRange {
+    size_t begin = 0;
+    size_t end = 0;
+
+    size_t size() const { return end - begin; }
+    bool operator==(const SampleRange& other) const { return begin == other.begin && end == other.end; }
+};
+
+// One spectral feature (MFCC, MelBands, SpectralContrast, HPCP, Key, Tonnetz, Spectrum)
+// run over a spectrogram block by block, with what has to outlive a block
+struct SpectralTask {
+    std::string algorithm;
+    std::map<std::string, essentia::Parameter> params;
+    int frameSize = 2048;
+    int hopSize = 1024;
+    bool framewise = false;
+    SampleRange range;
+
+    // Key: HPCP sum for the global estimate, or the per-frame results when framewise
+    std::vector<essentia::Real> hpcpSum;
+    int hpcpCount = 0;
+    std::vector<std::string> keyFrames;
+    std::vector<std::string> scaleFrames;
+    std::vector<essentia::Real> strengthFrames;
+    std::vector<essentia::Real> firstToSecondRelativeStrengthFrames;
+};
+
 class EssentiaWrapper {
 public:
     EssentiaWrapper();
@@ -28,41 +80,186 @@ public:
 
     bool initialize();
     bool setAudioData(const std::vector<essentia::Real>& data, double rate);
+    // Takes the samples over without copying. Odd-length audio is padded with one zero
+    // sample, in place if data has the capacity for it (reserve size + 1).
+    bool setAudioData(std::vector<essentia::Real>&& data, double rate);
 
     std::string executeAlgorithm(const std::string& algorithm, const std::string& paramsJson);
     std::string executeSpecificAlgorithm(const std::string& algorithm, const std::map<std::string, essentia::Parameter>& params);
     std::string executeDynamicAlgorithm(const std::string& algorithm, const std::map<std::string, essentia::Parameter>& params);
+
+    // Same as above, but add the results to a caller-supplied pool instead of serializing
+    // them. Return an empty string on success, otherwise the error response JSON.
+    std::string executeAlgorithm(const std::string& algorithm, const std::string& paramsJson, essentia::Pool& pool);
+    std::string executeSpecificAlgorithm(const std::string& algorithm, const std::map<std::string, essentia::Parameter>& params,
+                                         essentia::Pool& pool);
+    std::string executeDynamicAlgorithm(const std::string& algorithm, const std::map<std::string, essentia::Parameter>& params,
+                                        essentia::Pool& pool);
     std::vector<essentia::Real> applyTonnetzTransform(const std::vector<essentia::Real>& hpcp);
 
     std::string getAlgorithmInfo(const std::string& algorithm);
     std::string getAllAlgorithms();
 
     bool isInitialized() const  { return mIsInitialized; }
+
+    // A wrapper is one session: its audio, spectrum caches, algorithm pool and pipelines
+    // are its own and are not synchronized, so bridges hold this mutex for every call
+    // into a session. Different sessions can run at the same time; their frame-parallel
+    // work shares WorkerPool::shared(). Essentia itself is initialized once for all
+    // sessions and shut down with the last one.
+    std::mutex& sessionMutex() { return mSessionMutex; }
     void computeSpectrum(int frameSize, int hopSize);
 
+    // Spectrogram of the current audio for (frameSize, hopSize, windowType), computed on
+    // first use and kept until setAudioData. Several configs can be cached at once; the
+    // reference stays valid until the next getSpectrum call (which may evict) or setAudioData.
+    const SpectrumMatrix& getSpectrum(int frameSize, int hopSize, const std::string& windowType = "hann");
+    void clearSpectrumCache();
+
+    // Spectral features share one framing-dependent front end (FrameCutter, Windowing,
+    // Spectrum). executeSpectralTasks runs every task of one framing (the frameSize and
+    // hopSize of tasks[0]) over the same spectrum frames: if that spectrogram is not
+    // cached it is computed kSpectralBlockFrames frames at a time and each block goes
+    // through all the tasks before the next one is cut, so the full spectrogram is
+    // never stored. Returns an empty string on success, otherwise the error response JSON.
+    static bool isSpectralAlgorithm(const std::string& algorithm);
+    static std::string validateSpectralParams(const std::string& algorithm,
+                                              const std::map<std::string, essentia::Parameter>& params);
+    SpectralTask makeSpectralTask(const std::string& algorithm, const std::map<std::string, essentia::Parameter>& params) const;
+    std::string executeSpectralTasks(std::vector<SpectralTask>& tasks, essentia::Pool& pool);
+
     // Accessors for other private members used in FeatureExtractor
     bool getSpectrumComputed() const { return spectrumComputed; }
     void setSpectrumComputed(bool computed) { spectrumComputed = computed; }
     const std::vector<essentia::Real>& getCachedSpectrum() const { return cachedSpectrum; }
     void setCachedSpectrum(const std::vector<essentia::Real>& spectrum) { cachedSpectrum = spectrum; }
-    const std::vector<std::vector<essentia::Real>>& getAllSpectra() const { return allSpectra; }
-    void setAllSpectra(const std::vector<std::vector<essentia::Real>>& spectra) { allSpectra = spectra; }
+
+    // Analysis ranges. startSample/endSample (or startTime/endTime, in seconds) in
+    // algorithm params or a pipeline config restrict a call to part of the loaded audio
+    // without reloading it. While a RangeScope is alive, analysisSignal() is the
+    // range's samples; spectral features instead take the frames of the whole-buffer
+    // framing centred in the range, so every range shares the cached spectrograms.
+    // The take/resolve helpers return an empty string or the error response JSON.
+    std::string takeSampleRange(std::map<std::string, essentia::Parameter>& params, SampleRange& range) const;
+    std::string resolveSampleRange(const nlohmann::json& spec, SampleRange& range) const;
+    std::string resolveSampleRange(int64_t startSample, int64_t endSample, SampleRange& range) const;
+    SampleRange fullRange() const { return SampleRange{0, audioBuffer.size()}; }
+    const std::vector<essentia::Real>& analysisSignal();
+
+    class RangeScope {
+    public:
+        RangeScope(EssentiaWrapper& wrapper, const SampleRange& range);
+        ~RangeScope();
+        RangeScope(const RangeScope&) = delete;
+        RangeScope& operator=(const RangeScope&) = delete;
+
+    private:
+        EssentiaWrapper& mWrapper;
+        SampleRange mPrevious;
+    };
 
     double getSampleRate() const { return sampleRate; }
+    // ResultCache::hash of the loaded samples, computed on first use after setAudioData
+    uint64_t getAudioHash();
     const std::vector<essentia::Real>& getAudioBuffer() const { return audioBuffer; }
     const std::map<std::string, std::string>& getPrimaryOutputs() const { return primaryOutputs; }
+    AlgorithmPool& getAlgorithmPool() { return algorithmPool; }
+    Profiler& getProfiler() { return profiler; }
+
+    // When enabled, success responses carry a "profile" section with the call's
+    // per-stage timings, frame counts and buffer bytes (see Profiler)
+    void setProfilingEnabled(bool enabled) { profiler.setEnabled(enabled); }
+    bool isProfilingEnabled() const { return profiler.enabled(); }
+    // {"success":true,"data":dataJson} plus the profile when profiling is enabled
+    std::string successResponse(const std::string& dataJson) const;
+
+    // Worker threads used for frame-parallel processing in executeSpecificAlgorithm
+    // (capped by the shared WorkerPool size and by the frame count at run time)
+    void setFrameThreadCount(int count);
+    int getFrameThreadCount() const { return frameThreadCount; }
+
+    // Compiled pipelines (preparePipeline / runPipeline), kept until released
+    int addPipelinePlan(std::unique_ptr<PipelinePlan> plan);
+    PipelinePlan* getPipelinePlan(int pipelineId);
+    bool releasePipelinePlan(int pipelineId);
 
 private:
     bool mIsInitialized;
+    std::mutex mSessionMutex;
     std::vector<essentia::Real> audioBuffer;
     double sampleRate;
     bool spectrumComputed;
     std::vector<essentia::Real> cachedSpectrum;
-    std::vector<std::vector<essentia::Real>> allSpectra;
+    SampleRange analysisRange;                 // set by RangeScope; full when begin == end == 0
+    std::vector<essentia::Real> rangeSignal;  // samples of analysisRange, sliced on first use
+    uint64_t audioHash = 0;
+    bool audioHashValid = false;
+
+    struct SpectrumKey {
+        int frameSize;
+        int hopSize;
+        std::string windowType;
+        bool operator<(const SpectrumKey& other) const {
+            return std::tie(frameSize, hopSize, windowType) <
+                   std::tie(other.frameSize, other.hopSize, other.windowType);
+        }
+    };
+    struct SpectrumEntry {
+        SpectrumMatrix matrix;
+        uint64_t lastUse = 0;
+    };
+    static const size_t kMaxCachedSpectra = 4;
+    std::map<SpectrumKey, SpectrumEntry> spectrumCache;
+    uint64_t spectrumUseCounter = 0;
+    AlgorithmPool algorithmPool;
+    // Chromagram kernels, built once per configuration: STFT chroma kernels, and
+    // constant-Q Chromagram instances kept checked out so that AlgorithmPool eviction
+    // never throws their ConstantQ kernel away
+    static const size_t kMaxCachedChromaKernels = 4;
+    std::map<ChromaKernelKey, std::unique_ptr<ChromaKernel>> chromaKernels;
+    std::map<std::string, AlgorithmPool::Lease> chromagramAlgorithms;
+    // Port buffers of executeDynamicAlgorithm, by algorithm
+    std::map<std::string, PortBinding> dynamicBindings;
+    Profiler profiler;
+    std::atomic<int> frameThreadCount{4};  // may be set from another thread than the one computing
+    static const int kMinFramesPerWorker = 32;
+    static const int kSpectralBlockFrames = 128;  // ~0.5 MB of 2048-point spectra
+    std::map<int, std::unique_ptr<PipelinePlan>> pipelinePlans;
+    int nextPipelineId = 1;
+
+    // Splits [0, numFrames) into contiguous chunks and calls fn(begin, end) for each, on
+    // the shared WorkerPool and the calling thread. fn must only write to
+    // per-frame slots; the first exception thrown by any chunk is rethrown after all finish.
+    void forEachFrameChunk(int numFrames, const std::function<void(int begin, int end)>& fn) const;
+    // Runs FrameCutter -> Windowing -> Spectrum into out, over the whole audio or, for a
+    // range that is neither empty nor full, over just the frames of the whole-audio framing
+    // centred in it (see rangeFrames). With blockFrames > 0, onBlock is called each time out
+    // holds blockFrames frames (and for the last, partial block) and out is emptied after
+    // it; otherwise out ends up with every frame.
+    void computeSpectrumFrames(int frameSize, int hopSize, const std::string& windowType, const SampleRange& range,
+                               SpectrumMatrix& out, int blockFrames = 0, const std::function<void()>& onBlock = nullptr);
+    bool hasAnalysisRange() const { return !(analysisRange == SampleRange()) && !(analysisRange == fullRange()); }
+    // Frames [first, end) of the whole-audio framing, where frame i is centred on sample
+    // i * hopSize, that are centred in range
+    static std::pair<int, int> rangeFrames(const SampleRange& range, int hopSize);
+    // spectra itself, or (with an analysis range) its frames centred in the range copied to storage
+    const SpectrumMatrix& framesInRange(const SpectrumMatrix& spectra, int hopSize, SpectrumMatrix& storage) const;
+    // The spectrogram of the analysis range: without a range the cached whole-audio one
+    // (see getSpectrum); with one, the frames centred in it, copied from the cached
+    // spectrogram if there is one and otherwise computed for just those frames. Range
+    // frames go to storage and are never cached.
+    const SpectrumMatrix& analysisSpectrum(int frameSize, int hopSize, const std::string& windowType, SpectrumMatrix& storage);
+    void processSpectralBlock(SpectralTask& task, const SpectrumMatrix& spectra, essentia::Pool& pool);
+    // Adds what needs every frame (means, the global Key)
+    void finishSpectralTask(SpectralTask& task, essentia::Pool& pool);
+    // Chromagram method "stft": chroma from the cached spectrogram (only the frames of an
+    // analysis range, see analysisSpectrum) through a ChromaKernel
+    std::string computeStftChroma(const std::map<std::string, essentia::Parameter>& params, essentia::Pool& pool);
+    const ChromaKernel& getChromaKernel(const ChromaKernelKey& key);
+    AlgorithmPool::Lease& getChromagramAlgorithm(const std::map<std::string, essentia::Parameter>& params);
     std::string findMatchingInputName(essentia::standard::Algorithm* algo, const std::string& expectedName,
                                       const std::vector<std::string>& alternatives = {});
 
-    static const std::array<std::array<float, 12>, 6> TONNETZ_MATRIX;
     static const std::map<std::string, std::string> primaryOutputs;
 };
 
@@ -1,24 +1,47 @@
 // packages/react-native-essentia/cpp/FeatureExtractor.cpp
 #include "FeatureExtractor.h"
+#include "ChunkSink.h"
 #include "EssentiaWrapper.h"
+#include "PipelinePlan.h"
+#include "PoolCodec.h"
+#include "ResultCache.h"
+#include "TonnetzKernel.h"
 #include "Utils.h"
 #include "nlohmann/json.hpp"
 
-#ifdef __ANDROID__
-#include <android/log.h>
-#define LOGI(...) ((void)__android_log_print(ANDROID_LOG_INFO, "EssentiaWrapper", __VA_ARGS__))
-#define LOGW(...) ((void)__android_log_print(ANDROID_LOG_WARN, "EssentiaWrapper", __VA_ARGS__))
-#define LOGE(...) ((void)__android_log_print(ANDROID_LOG_ERROR, "EssentiaWrapper", __VA_ARGS__))
-#else
-#define LOGI(...) printf(__VA_ARGS__)
-#define LOGW(...) printf(__VA_ARGS__)
-#define LOGE(...) printf(__VA_ARGS__)
-#endif
-
 using json = nlohmann::json;
 
 FeatureExtractor::FeatureExtractor(EssentiaWrapper* wrapper) : mWrapper(wrapper) {}
 
+std::string FeatureExtractor::resultCacheKey(const char* kind, const std::string& configJson) {
+    if (!ResultCache::shared().enabled()) {
+        return std::string();
+    }
+    return ResultCache::makeKey(mWrapper->getAudioHash(), mWrapper->getSampleRate(), kind, configJson);
+}
+
+bool FeatureExtractor::cachedResult(const std::string& cacheKey, std::string& response) {
+    if (cacheKey.empty()) {
+        return false;
+    }
+    Profiler::Scope stage(mWrapper->getProfiler(), "cache");
+    std::vector<uint8_t> encoded;
+    essentia::Pool pool;
+    if (!ResultCache::shared().get(cacheKey, encoded) || !binaryToPool(encoded.data(), encoded.size(), pool)) {
+        return false;
+    }
+    stage.addBytes(static_cast<int64_t>(encoded.size()));
+    LOGI("Result cache hit (%zu bytes)", encoded.size());
+    response = mWrapper->successResponse(poolToJson(pool));
+    return true;
+}
+
+void FeatureExtractor::storeResult(const std::string& cacheKey, const essentia::Pool& pool) {
+    if (!cacheKey.empty()) {
+        ResultCache::shared().put(cacheKey, poolToBinary(pool));
+    }
+}
+
 // Extract features from the pool
 std::string FeatureExtractor::extractFeatures(const std::string& featuresJson) {
     if (!mWrapper->isInitialized()) {
@@ -29,11 +52,13 @@ std::string FeatureExtractor::extractFeatures(const std::string& featuresJson) {
         return createErrorResponse("No audio data loaded. Call setAudioData() first.", "ESSENTIA_NO_AUDIO_DATA");
     }
 
-    // Reset spectrum cache to ensure fresh computation for each feature extraction
-    mWrapper->setSpectrumComputed(false);
-    mWrapper->setCachedSpectrum({});
-    mWrapper->setAllSpectra({});
-
+    Profiler& profiler = mWrapper->getProfiler();
+    Profiler::Scope call(profiler, "extractFeatures");
+    const std::string cacheKey = resultCacheKey("extractFeatures", featuresJson);
+    std::string cached;
+    if (cachedResult(cacheKey, cached)) {
+        return cached;
+    }
     essentia::Pool pool;
 
     try {
@@ -43,22 +68,10 @@ std::string FeatureExtractor::extractFeatures(const std::string& featuresJson) {
             return createErrorResponse("Features must be an array of configurations", "INVALID_FORMAT");
         }
 
-        // Determine maximum required frame size
-        int maxFrameSize = 2048; // Default to a larger size
-        for (const auto& config : featureConfigs) {
-            std::string name = config["name"];
-            if ((name == "MelBands" || name == "MFCC") && config.contains("params")) {
-                int nb = 40; // Default
-                if (config["params"].contains("numberBands")) {
-                    nb = config["params"]["numberBands"];
-                }
-                int requiredFrameSize = (nb <= 40) ? 1024 : 2048;
-                maxFrameSize = std::max(maxFrameSize, requiredFrameSize);
-            }
-        }
-
-        // Compute spectrum with appropriate size (only once)
-        mWrapper->computeSpectrum(maxFrameSize, maxFrameSize / 2);
+        // Spectral features are grouped by framing (and analysis range) and run together on each block of
+        // spectrum frames once every configuration has been read; the others run as
+        // they come
+        std::vector<std::vector<SpectralTask>> spectralGroups;
 
         // Process each feature configuration
         for (const auto& config : featureConfigs) {
@@ -85,74 +98,53 @@ std::string FeatureExtractor::extractFeatures(const std::string& featuresJson) {
                 }
             }
 
-            // Execute the specific algorithm
-            std::string result = mWrapper->executeSpecificAlgorithm(name, params);
-
-            // Parse the result
-            json resultJson;
-            try {
-                resultJson = json::parse(result);
-            } catch (const json::exception& e) {
-                return createErrorResponse("Error parsing algorithm result: " + std::string(e.what()), "PARSING_ERROR", result);
+            if (EssentiaWrapper::isSpectralAlgorithm(name)) {
+                std::string error = EssentiaWrapper::validateSpectralParams(name, params);
+                if (!error.empty()) {
+                    return error;
+                }
+                SampleRange range;
+                error = mWrapper->takeSampleRange(params, range);
+                if (!error.empty()) {
+                    return error;
+                }
+                SpectralTask task = mWrapper->makeSpectralTask(name, params);
+                task.range = range;
+                auto group = std::find_if(spectralGroups.begin(), spectralGroups.end(), [&](const std::vector<SpectralTask>& tasks) {
+                    return tasks[0].frameSize == task.frameSize && tasks[0].hopSize == task.hopSize &&
+                           tasks[0].range == task.range;
+                });
+                if (group != spectralGroups.end()) {
+                    group->push_back(std::move(task));
+                } else {
+                    spectralGroups.push_back({std::move(task)});
+                }
+                continue;
             }
 
-            // Check for errors
-            if (!resultJson.contains("success") || !resultJson["success"].get<bool>()) {
-                return result; // Propagate the error response
+            // Execute the specific algorithm straight into the shared pool; results are
+            // serialized once, below
+            std::string error = mWrapper->executeSpecificAlgorithm(name, params, pool);
+            if (!error.empty()) {
+                return error; // Propagate the error response
             }
+        }
 
-            // Add algorithm results to the pool
-            if (resultJson.contains("data") && resultJson["data"].is_object()) {
-                for (auto it = resultJson["data"].items().begin(); it != resultJson["data"].items().end(); ++it) {
-                    const auto& key = it.key();
-                    auto& value = it.value();
-                    // Add to the pool using appropriate key
-                    if (value.is_array()) {
-                        if (!value.empty() && value[0].is_array()) {
-                            // Handle frame-wise data (array of arrays)
-                            std::vector<std::vector<essentia::Real>> framesData;
-                            for (const auto& frame : value) {
-                                std::vector<essentia::Real> frameData;
-                                for (const auto& item : frame) {
-                                    if (item.is_number()) {
-                                        double val = item.get<double>();
-                                        frameData.push_back(std::isfinite(val) ? val : 0.0);
-                                    }
-                                }
-                                framesData.push_back(frameData);
-                            }
-                            for (const auto& frame : framesData) {
-                                pool.add(key, frame);
-                            }
-                        } else {
-                            // Handle single vector data
-                            std::vector<essentia::Real> vec;
-                            for (const auto& item : value) {
-                                if (item.is_number()) {
-                                    double val = item.get<double>();
-                                    vec.push_back(std::isfinite(val) ? val : 0.0);
-                                }
-                            }
-                            pool.set(key, vec);
-                        }
-                    }
-                    else if (value.is_string()) {
-                        pool.set(key, value.get<std::string>());
-                    }
-                    else if (value.is_number()) {
-                        double val = value.get<double>();
-                        pool.set(key, std::isfinite(val) ? val : 0.0);
-                    }
-                    else if (value.is_boolean()) {
-                        pool.set(key, value.get<bool>());
-                    }
-                }
+        for (auto& tasks : spectralGroups) {
+            std::string error = mWrapper->executeSpectralTasks(tasks, pool);
+            if (!error.empty()) {
+                return error;
             }
         }
 
         // Convert the pool to JSON and return success
-        std::string resultJson = poolToJson(pool);
-        return "{\"success\":true,\"data\":" + resultJson + "}";
+        std::string resultJson;
+        {
+            Profiler::Scope serialize(profiler, "serialize");
+            resultJson = poolToJson(pool);
+        }
+        storeResult(cacheKey, pool);
+        return mWrapper->successResponse(resultJson);
     }
     catch (const json::exception& e) {
         return createErrorResponse("Error parsing feature configuration: " + std::string(e.what()), "JSON_PARSE_ERROR");
@@ -163,7 +155,98 @@ std::string FeatureExtractor::extractFeatures(const std::string& featuresJson) {
 }
 
 std::string FeatureExtractor::computeMelSpectrogram(int frameSize, int hopSize, int nMels, float fMin, float fMax,
-                                                  const std::string& windowType, bool normalize, bool logScale) {
+                                                  const std::string& windowType, bool normalize, bool logScale,
+                                                  int64_t startSample, int64_t endSample) {
+    Profiler& profiler = mWrapper->getProfiler();
+    Profiler::Scope call(profiler, "computeMelSpectrogram");
+
+    std::vector<std::vector<essentia::Real>> melSpectrogram;
+    CallbackChunkSink sink([&](const essentia::Real* rows, int numFrames, int numColumns) {
+        for (int i = 0; i < numFrames; ++i) {
+            melSpectrogram.emplace_back(rows + static_cast<size_t>(i) * numColumns, rows + static_cast<size_t>(i + 1) * numColumns);
+        }
+    });
+    int numFrames = 0;
+    std::string error = streamMelSpectrogram(frameSize, hopSize, nMels, fMin, fMax, windowType, normalize, logScale,
+                                             startSample, endSample, sink, kMelChunkFrames, numFrames);
+    if (!error.empty()) {
+        return error;
+    }
+    call.addFrames(numFrames);
+    call.addBytes(static_cast<int64_t>(melSpectrogram.size() * nMels * sizeof(essentia::Real)));
+
+    // Convert to JSON
+    Profiler::Scope serialize(profiler, "serialize");
+    json result;
+    result["bands"] = melSpectrogram;
+    result["sampleRate"] = mWrapper->getSampleRate();
+    result["nMels"] = nMels;
+    result["timeSteps"] = melSpectrogram.size();
+    result["durationMs"] = (melSpectrogram.size() * hopSize * 1000) / mWrapper->getSampleRate();
+
+    return mWrapper->successResponse(result.dump());
+}
+
+std::string FeatureExtractor::computeMelSpectrogram(int frameSize, int hopSize, int nMels, float fMin, float fMax,
+                                                  const std::string& windowType, bool normalize, bool logScale,
+                                                  int64_t startSample, int64_t endSample, ChunkSink& sink, int chunkFrames) {
+    json data;
+    std::string error = chunkedMelSpectrogram(frameSize, hopSize, nMels, fMin, fMax, windowType, normalize, logScale,
+                                              startSample, endSample, sink, chunkFrames, data);
+    return error.empty() ? mWrapper->successResponse(data.dump()) : error;
+}
+
+std::string FeatureExtractor::computeMelSpectrogramToFile(int frameSize, int hopSize, int nMels, float fMin, float fMax,
+                                                        const std::string& windowType, bool normalize, bool logScale,
+                                                        int64_t startSample, int64_t endSample, const std::string& path,
+                                                        int chunkFrames) {
+    std::unique_ptr<FileChunkSink> sink;
+    try {
+        sink.reset(new FileChunkSink(path));
+    } catch (const std::exception& e) {
+        return createErrorResponse(e.what(), "FILE_ERROR");
+    }
+    json data;
+    std::string error = chunkedMelSpectrogram(frameSize, hopSize, nMels, fMin, fMax, windowType, normalize, logScale,
+                                              startSample, endSample, *sink, chunkFrames, data);
+    if (!error.empty()) {
+        return error;
+    }
+    data["path"] = path;
+    data["format"] = "float32le";
+    return mWrapper->successResponse(data.dump());
+}
+
+std::string FeatureExtractor::chunkedMelSpectrogram(int frameSize, int hopSize, int nMels, float fMin, float fMax,
+                                                  const std::string& windowType, bool normalize, bool logScale,
+                                                  int64_t startSample, int64_t endSample, ChunkSink& sink,
+                                                  int chunkFrames, json& data) {
+    if (chunkFrames <= 0) {
+        return createErrorResponse("chunkFrames must be positive", "INVALID_PARAM");
+    }
+    Profiler::Scope call(mWrapper->getProfiler(), "computeMelSpectrogram");
+
+    int numFrames = 0;
+    std::string error = streamMelSpectrogram(frameSize, hopSize, nMels, fMin, fMax, windowType, normalize, logScale,
+                                             startSample, endSample, sink, chunkFrames, numFrames);
+    if (!error.empty()) {
+        return error;
+    }
+    call.addFrames(numFrames);
+    call.addBytes(static_cast<int64_t>(chunkFrames) * nMels * static_cast<int64_t>(sizeof(essentia::Real)));
+
+    data["sampleRate"] = mWrapper->getSampleRate();
+    data["nMels"] = nMels;
+    data["timeSteps"] = numFrames;
+    data["durationMs"] = (static_cast<size_t>(numFrames) * hopSize * 1000) / mWrapper->getSampleRate();
+    data["chunkFrames"] = chunkFrames;
+    return "";
+}
+
+std::string FeatureExtractor::streamMelSpectrogram(int frameSize, int hopSize, int nMels, float fMin, float fMax,
+                                                   const std::string& windowType, bool normalize, bool logScale,
+                                                   int64_t startSample, int64_t endSample, ChunkSink& sink,
+                                                   int chunkFrames, int& numFrames) {
     if (!mWrapper->isInitialized()) {
         return createErrorResponse("Essentia is not initialized", "NOT_INITIALIZED");
     }
@@ -172,1060 +255,271 @@ std::string FeatureExtractor::computeMelSpectrogram(int frameSize, int hopSize,
         return createErrorResponse("No audio data available", "NO_AUDIO_DATA");
     }
 
+    SampleRange range;
+    std::string rangeError = mWrapper->resolveSampleRange(startSample, endSample, range);
+    if (!rangeError.empty()) {
+        return rangeError;
+    }
+    EssentiaWrapper::RangeScope rangeScope(*mWrapper, range);
+
     try {
-        LOGI("Computing mel spectrogram with params: frameSize=%d, hopSize=%d, nMels=%d",
-              frameSize, hopSize, nMels);
-
-        essentia::standard::AlgorithmFactory& factory = essentia::standard::AlgorithmFactory::instance();
-
-        // Create algorithms
-        essentia::standard::Algorithm* frameCutter = factory.create("FrameCutter",
-            "frameSize", frameSize,
-            "hopSize", hopSize,
-            "startFromZero", true
-        );
-
-        essentia::standard::Algorithm* windowing = factory.create("Windowing",
-            "type", windowType,
-            "size", frameSize
-        );
-
-        essentia::standard::Algorithm* spectrum = factory.create("Spectrum",
-            "size", frameSize
-        );
-
-        essentia::standard::Algorithm* melBands = factory.create("MelBands",
-            "inputSize", (frameSize / 2) + 1, // Correct spectrum size
-            "numberBands", nMels,
-            "lowFrequencyBound", fMin,
-            "highFrequencyBound", fMax,
-            "sampleRate", static_cast<int>(mWrapper->getSampleRate()),
-            "normalize", normalize ? "unit_sum" : "none",
-            "log", logScale // This matches Essentia's API
-        );
-
-        // Process frames
-        std::vector<std::vector<essentia::Real>> melSpectrogram;
-        std::vector<essentia::Real> frame;
-
-        frameCutter->input("signal").set(mWrapper->getAudioBuffer());
+        LOGI("Computing mel spectrogram with params: frameSize=%d, hopSize=%d, nMels=%d, samples [%zu, %zu)",
+              frameSize, hopSize, nMels, range.begin, range.end);
+
+        // Check out configured algorithms (reused across calls with the same settings)
+        AlgorithmPool& algorithmPool = mWrapper->getAlgorithmPool();
+        auto frameCutter = algorithmPool.checkout("FrameCutter", {
+            {"frameSize", essentia::Parameter(frameSize)},
+            {"hopSize", essentia::Parameter(hopSize)},
+            {"startFromZero", essentia::Parameter(true)}
+        });
+
+        auto windowing = algorithmPool.checkout("Windowing", {
+            {"type", essentia::Parameter(windowType)},
+            {"size", essentia::Parameter(frameSize)}
+        });
+
+        auto spectrum = algorithmPool.checkout("Spectrum", {
+            {"size", essentia::Parameter(frameSize)}
+        });
+
+        auto melBands = algorithmPool.checkout("MelBands", {
+            {"inputSize", essentia::Parameter((frameSize / 2) + 1)}, // Correct spectrum size
+            {"numberBands", essentia::Parameter(nMels)},
+            {"lowFrequencyBound", essentia::Parameter(static_cast<essentia::Real>(fMin))},
+            {"highFrequencyBound", essentia::Parameter(static_cast<essentia::Real>(fMax))},
+            {"sampleRate", essentia::Parameter(static_cast<int>(mWrapper->getSampleRate()))},
+            {"normalize", essentia::Parameter(std::string(normalize ? "unit_sum" : "none"))},
+            {"log", essentia::Parameter(logScale)} // This matches Essentia's API
+        });
+
+        // Per-frame buffers, bound once
+        std::vector<essentia::Real> frame, windowedFrame, spec, bands;
+        frameCutter->input("signal").set(mWrapper->analysisSignal());
         frameCutter->output("frame").set(frame);
+        windowing->input("frame").set(frame);
+        windowing->output("frame").set(windowedFrame);
+        spectrum->input("frame").set(windowedFrame);
+        spectrum->output("spectrum").set(spec);
+        melBands->input("spectrum").set(spec);
+        melBands->output("bands").set(bands);
+
+        // Rows of the current chunk; handed to the sink whenever chunkFrames are ready
+        std::vector<essentia::Real> chunk;
+        chunk.reserve(static_cast<size_t>(chunkFrames) * nMels);
+        int chunkRows = 0;
+        numFrames = 0;
 
-        // Loop through frames
         while (true) {
-            // Reset frame for next input
             frame.clear();
-
-            // Process next frame
             frameCutter->compute();
-
             // If we got an empty frame, we're done
             if (frame.empty()) {
                 break;
             }
-
-            // Apply window to frame
-            std::vector<essentia::Real> windowedFrame;
-            windowing->input("frame").set(frame);
-            windowing->output("frame").set(windowedFrame);
             windowing->compute();
-
-            // Compute spectrum
-            std::vector<essentia::Real> spec;
-            spectrum->input("frame").set(windowedFrame);
-            spectrum->output("spectrum").set(spec);
             spectrum->compute();
-
-            // Compute mel bands
-            std::vector<essentia::Real> bands;
-            melBands->input("spectrum").set(spec);
-            melBands->output("bands").set(bands);
             melBands->compute();
+            if (static_cast<int>(bands.size()) != nMels) {
+                throw std::runtime_error("MelBands returned " + std::to_string(bands.size()) + " bands instead of " +
+                                         std::to_string(nMels));
+            }
 
-            // Add to mel spectrogram
-            melSpectrogram.push_back(bands);
+            chunk.insert(chunk.end(), bands.begin(), bands.end());
+            ++numFrames;
+            if (++chunkRows == chunkFrames) {
+                sink.write(chunk.data(), chunkRows, nMels);
+                chunk.clear();
+                chunkRows = 0;
+            }
         }
+        if (chunkRows > 0) {
+            sink.write(chunk.data(), chunkRows, nMels);
+        }
+        sink.finish();
 
-        // Clean up
-        delete frameCutter;
-        delete windowing;
-        delete spectrum;
-        delete melBands;
-
-        LOGI("Computed mel spectrogram with %d frames", (int)melSpectrogram.size());
-
-        // Convert to JSON
-        json result;
-        result["bands"] = melSpectrogram;
-        result["sampleRate"] = mWrapper->getSampleRate();
-        result["nMels"] = nMels;
-        result["timeSteps"] = melSpectrogram.size();
-        result["durationMs"] = (melSpectrogram.size() * hopSize * 1000) / mWrapper->getSampleRate();
-
-        return "{\"success\":true,\"data\":" + result.dump() + "}";
+        LOGI("Computed mel spectrogram with %d frames", numFrames);
+        return "";
     } catch (const std::exception& e) {
         std::string errorMsg = std::string("Error computing mel spectrogram: ") + e.what();
         LOGE("%s", errorMsg.c_str());
         return createErrorResponse(errorMsg, "MEL_SPECTROGRAM_ERROR");
     }
-
 }
 
-// Execute pipeline
-std::string FeatureExtractor::executePipeline(const std::string& pipelineJson) {
-      try {
-        LOGI("Starting pipeline execution with configuration length: %zu", pipelineJson.length());
-
-        if (!mWrapper->isInitialized()) {
-            LOGE("Essentia not initialized");
-            return createErrorResponse("Essentia not initialized", "NOT_INITIALIZED");
-        }
-
-        if (mWrapper->getAudioBuffer().empty()) {
-            LOGE("No audio data loaded");
-            return createErrorResponse("No audio data loaded", "NO_AUDIO_DATA");
-        }
-
-        // Parse the JSON configuration
-        json config;
-        try {
-            config = json::parse(pipelineJson);
-            LOGI("Successfully parsed pipeline JSON configuration");
-        } catch (const json::exception& e) {
-            LOGE("Failed to parse JSON configuration: %s", e.what());
-            return createErrorResponse(std::string("Invalid JSON configuration: ") + e.what(), "INVALID_CONFIG");
-        }
-
-        // Log the feature algorithms we're going to process
-        if (config.contains("features") && config["features"].is_array()) {
-            LOGI("Pipeline includes %zu features:", config["features"].size());
-            for (const auto& feature : config["features"]) {
-                if (feature.contains("name")) {
-                    LOGI("  - %s", feature["name"].get<std::string>().c_str());
-                }
-            }
-        }
-
-        // Validate configuration
-        if (!config.contains("preprocess") || !config["preprocess"].is_array()) {
-            LOGE("Invalid configuration: 'preprocess' must be an array");
-            return createErrorResponse("Invalid configuration: 'preprocess' must be an array", "INVALID_CONFIG");
-        }
-        if (!config.contains("features") || !config["features"].is_array()) {
-            LOGE("Invalid configuration: 'features' must be an array");
-            return createErrorResponse("Invalid configuration: 'features' must be an array", "INVALID_CONFIG");
-        }
-
-        essentia::Pool finalPool;
-        bool isFrameBased = false;
-        size_t frameCutterIndex = std::numeric_limits<size_t>::max();
-
-        // Determine if the pipeline is frame-based
-        for (size_t i = 0; i < config["preprocess"].size(); ++i) {
-            if (config["preprocess"][i]["name"].get<std::string>() == "FrameCutter") {
-                isFrameBased = true;
-                frameCutterIndex = i;
-                break;
-            }
-        }
-
-        LOGI("Executing pipeline (frame-based: %s)", isFrameBased ? "true" : "false");
-
-        essentia::standard::AlgorithmFactory& factory = essentia::standard::AlgorithmFactory::instance();
-
-        if (isFrameBased) {
-            // Frame-based processing
-            if (frameCutterIndex >= config["preprocess"].size()) {
-                LOGE("FrameCutter not found in preprocessing steps");
-                return createErrorResponse("FrameCutter not found in preprocessing steps", "INVALID_CONFIG");
-            }
-
-            // Create FrameCutter
-            json frameCutterConfig = config["preprocess"][frameCutterIndex];
-            if (!frameCutterConfig.contains("params") ||
-                !frameCutterConfig["params"].contains("frameSize") ||
-                !frameCutterConfig["params"].contains("hopSize")) {
-                LOGE("FrameCutter requires frameSize and hopSize parameters");
-                return createErrorResponse("FrameCutter requires frameSize and hopSize parameters", "INVALID_CONFIG");
-            }
-
-            // Configure FrameCutter
-            essentia::standard::Algorithm* frameCutter = factory.create("FrameCutter",
-                "frameSize", frameCutterConfig["params"]["frameSize"].get<int>(),
-                "hopSize", frameCutterConfig["params"]["hopSize"].get<int>()
-            );
-
-            std::vector<essentia::Real> frame;
-            frameCutter->input("signal").set(mWrapper->getAudioBuffer());
-            frameCutter->output("frame").set(frame);
-
-            // Map to store feature outputs across frames
-            std::map<std::string, std::vector<std::vector<essentia::Real>>> featureCollectors;
-
-            // Create and configure preprocessing algorithms (after FrameCutter)
-            std::vector<essentia::standard::Algorithm*> preprocessAlgos;
-            std::vector<std::vector<essentia::Real>> preprocessOutputs;
-            std::vector<std::string> preprocessOutputNames;
-
-            for (size_t i = frameCutterIndex + 1; i < config["preprocess"].size(); ++i) {
-                json step = config["preprocess"][i];
-                std::string name = step["name"].get<std::string>();
-
-                try {
-                    essentia::standard::Algorithm* algo = factory.create(name);
-
-                    // Configure algorithm parameters
-                    if (step.contains("params")) {
-                        json params = step["params"];
-                        for (auto& [key, value] : params.items()) {
-                            if (value.is_number_integer()) {
-                                algo->configure(key, value.get<int>());
-                            }
-                            else if (value.is_number_float()) {
-                                algo->configure(key, value.get<float>());
-                            }
-                            else if (value.is_string()) {
-                                algo->configure(key, value.get<std::string>());
-                            }
-                            else if (value.is_boolean()) {
-                                algo->configure(key, value.get<bool>());
-                            }
-                        }
-                    }
-
-                    preprocessAlgos.push_back(algo);
-                    preprocessOutputs.push_back(std::vector<essentia::Real>());
-                    preprocessOutputNames.push_back(name);
-                }
-                catch (const std::exception& e) {
-                    // Clean up already created algorithms
-                    for (auto* algo : preprocessAlgos) {
-                        delete algo;
-                    }
-                    LOGE("Error creating algorithm '%s': %s", name.c_str(), e.what());
-                    return createErrorResponse(std::string("Error creating algorithm '") + name + "': " + e.what(), "ALGORITHM_ERROR");
-                }
-            }
-
-            // Create and configure feature algorithms
-            std::vector<essentia::standard::Algorithm*> featureAlgos;
-            std::vector<std::vector<essentia::Real>> featureOutputs;
-            std::vector<std::string> featureNames;
-            std::vector<std::string> featureInputs;
-            std::vector<std::string> featureOutputNames;
-            std::vector<bool> featureUseMean;
-            std::vector<bool> featureUseVariance; // Add this to track variance requests
-
-            for (const auto& feature : config["features"]) {
-                std::string name = feature["name"].get<std::string>();
-
-                LOGI("Processing feature configuration: '%s'", name.c_str());
-
-                if (name == "Tonnetz") {
-                    LOGI("Detected Tonnetz feature - using special handling path");
-
-                    // Skip trying to create the Tonnetz algorithm using the factory
-                    // We'll handle it manually in the processing loop
-
-                    if (!feature.contains("input")) {
-                        // Clean up resources
-                        for (auto* algo : preprocessAlgos) delete algo;
-                        for (auto* algo : featureAlgos) delete algo;
-                        LOGE("Tonnetz feature missing required 'input' field");
-                        return createErrorResponse(std::string("Feature '") + name + "' is missing required 'input' field", "INVALID_CONFIG");
-                    }
-
-                    std::string inputName = feature["input"].get<std::string>();
-                    LOGI("Tonnetz will use input: '%s'", inputName.c_str());
-
-                    // Add to tracking arrays to maintain index alignment
-                    featureAlgos.push_back(nullptr); // No algorithm for Tonnetz
-                    featureOutputs.push_back(std::vector<essentia::Real>());
-                    featureNames.push_back(name);
-                    featureInputs.push_back(inputName);
-                    featureOutputNames.push_back("tonnetz");
-
-                    // Check for post-processing options
-                    bool useMean = false;
-                    bool useVariance = false;
-                    if (feature.contains("postProcess")) {
-                        if (feature["postProcess"].contains("mean")) {
-                            useMean = feature["postProcess"]["mean"].get<bool>();
-                        }
-                        if (feature["postProcess"].contains("variance")) {
-                            useVariance = feature["postProcess"]["variance"].get<bool>();
-                        }
-                    }
-                    featureUseMean.push_back(useMean);
-                    featureUseVariance.push_back(useVariance);
-
-                    continue;
-                }
-
-                if (!feature.contains("input")) {
-                    // Clean up resources
-                    for (auto* algo : preprocessAlgos) delete algo;
-                    for (auto* algo : featureAlgos) delete algo;
-                    LOGE("Feature '%s' is missing required 'input' field", name.c_str());
-                    return createErrorResponse(std::string("Feature '") + name + "' is missing required 'input' field", "INVALID_CONFIG");
-                }
-
-                std::string inputName = feature["input"].get<std::string>();
-
-                try {
-                    LOGI("Attempting to create algorithm '%s'", name.c_str());
-
-                    // Check if we're trying to create Tonnetz through the factory
-                    if (name == "Tonnetz") {
-                        LOGE("Unexpected code path: Trying to create Tonnetz algorithm through factory!");
-                        // This should never happen as we should have handled Tonnetz earlier
-                    }
-
-                    essentia::standard::Algorithm* algo = factory.create(name);
-                    LOGI("Successfully created algorithm '%s'", name.c_str());
-
-                    // Configure algorithm parameters
-                    if (feature.contains("params")) {
-                        json params = feature["params"];
-                        for (auto& [key, value] : params.items()) {
-                            if (value.is_number_integer()) {
-                                algo->configure(key, value.get<int>());
-                            }
-                            else if (value.is_number_float()) {
-                                algo->configure(key, value.get<float>());
-                            }
-                            else if (value.is_string()) {
-                                algo->configure(key, value.get<std::string>());
-                            }
-                            else if (value.is_boolean()) {
-                                algo->configure(key, value.get<bool>());
-                            }
-                        }
-                    }
-
-                    featureAlgos.push_back(algo);
-                    featureOutputs.push_back(std::vector<essentia::Real>());
-                    featureNames.push_back(name);
-                    featureInputs.push_back(inputName);
-
-                    // Determine the primary output name for this algorithm
-                    std::string outputName;
-                    if (mWrapper->getPrimaryOutputs().find(name) != mWrapper->getPrimaryOutputs().end()) {
-                        outputName = mWrapper->getPrimaryOutputs().at(name);
-                    } else {
-                        // Default to algorithm name in lowercase
-                        outputName = name;
-                        std::transform(outputName.begin(), outputName.end(), outputName.begin(), ::tolower);
-                    }
-                    featureOutputNames.push_back(outputName);
-
-                    // Check if we should compute mean and variance for this feature
-                    bool useMean = false;
-                    bool useVariance = false;
-                    if (feature.contains("postProcess")) {
-                        if (feature["postProcess"].contains("mean")) {
-                            useMean = feature["postProcess"]["mean"].get<bool>();
-                        }
-                        if (feature["postProcess"].contains("variance")) {
-                            useVariance = feature["postProcess"]["variance"].get<bool>();
-                        }
-                    }
-                    featureUseMean.push_back(useMean);
-                    featureUseVariance.push_back(useVariance);
-                }
-                catch (const std::exception& e) {
-                    // Clean up resources
-                    for (auto* algo : preprocessAlgos) delete algo;
-                    for (auto* algo : featureAlgos) delete algo;
-                    LOGE("Error creating algorithm '%s': %s", name.c_str(), e.what());
-                    return createErrorResponse(std::string("Error creating algorithm '") + name + "': " + e.what(), "ALGORITHM_ERROR");
-                }
-            }
-
-            // Create intermediate pools for feature computation
-            essentia::Pool framePool;
-            int frameCount = 0;
-
-            // Process frames
-            while (true) {
-                // Reset frame for next input
-                frame.clear();
-
-                // Extract frame
-                frameCutter->compute();
-                if (frame.empty()) break; // No more frames
-
-                frameCount++;
-
-                LOGI("Extracted frame %d with size: %zu", frameCount, frame.size());
-
-                // Clear the pool for this frame iteration to ensure a clean slate
-                framePool.clear();
-
-                // Add the frame to the pool with the name "frame"
-                if (!frame.empty()) {
-                    framePool.set("frame", frame);
-                    LOGI("Added frame to pool with name 'frame' (size: %zu)", frame.size());
-                }
-
-                // Apply preprocessing steps
-                if (!preprocessAlgos.empty()) {
-                    // Directly set the frame as input to the first preprocessing algorithm
-                    auto* firstAlgo = preprocessAlgos[0]; // Windowing
-                    std::vector<essentia::Real>& firstOutput = preprocessOutputs[0];
-
-                    // Connect the frame directly to the first algorithm
-                    firstAlgo->input("frame").set(frame);
-                    firstAlgo->output(mWrapper->getPrimaryOutputs().count(preprocessOutputNames[0]) ?
-                                    mWrapper->getPrimaryOutputs().at(preprocessOutputNames[0]) :
-                                    preprocessOutputNames[0]).set(firstOutput);
-
-                    // Compute the first algorithm
-                    firstAlgo->compute();
-
-                    // Use set instead of add for storing the output in the pool
-                    framePool.set(preprocessOutputNames[0], firstOutput);
-
-                    LOGI("Processed first preprocessing step '%s' directly from frame (output size: %zu)",
-                          preprocessOutputNames[0].c_str(), firstOutput.size());
-
-                    // Process remaining preprocessing steps (starting from index 1)
-                    for (size_t i = 1; i < preprocessAlgos.size(); ++i) {
-                        auto* algo = preprocessAlgos[i]; // Spectrum
-                        std::string inputName = preprocessOutputNames[i-1]; // "Windowing"
-                        std::vector<essentia::Real>& output = preprocessOutputs[i];
-
-                        // Check if the input key exists in the pool
-                        auto descriptors = framePool.descriptorNames();
-                        if (std::find(descriptors.begin(), descriptors.end(), inputName) == descriptors.end()) {
-                            LOGE("Input '%s' not found in pool for preprocessing step %zu",
-                                  inputName.c_str(), i);
-                            // Clean up resources
-                            for (auto* algo : preprocessAlgos) delete algo;
-                            for (auto* algo : featureAlgos) delete algo;
-                            return createErrorResponse("Input '" + inputName + "' not found in pool", "POOL_ERROR");
-                        }
-
-                        // Retrieve the input from the pool
-                        const auto& input = framePool.value<std::vector<essentia::Real>>(inputName);
-                        LOGI("Using input '%s' (size: %zu) for preprocessing step %zu",
-                              inputName.c_str(), input.size(), i);
-
-                        // Find the correct input port name for the algorithm
-                        std::string inputPortName = "frame";
-                        if (inputName == "Spectrum" || inputName == "spectrum") {
-                            inputPortName = "spectrum";
-                        }
-
-                        algo->input(inputPortName).set(input);
-                        algo->output(mWrapper->getPrimaryOutputs().count(preprocessOutputNames[i]) ?
-                                    mWrapper->getPrimaryOutputs().at(preprocessOutputNames[i]) :
-                                    preprocessOutputNames[i]).set(output);
-
-                        // Compute algorithm
-                        algo->compute();
-
-                        // Use set instead of add for storing the result in the pool
-                        framePool.set(preprocessOutputNames[i], output);
-                        LOGI("Set '%s' in pool (size: %zu)",
-                              preprocessOutputNames[i].c_str(), output.size());
-                    }
-                }
-                else if (featureAlgos.size() > 0) {
-                    // If there are no preprocessing steps but we have feature algorithms,
-                    // add the frame directly to the pool for feature extraction
-                    framePool.add("frame", frame);
-                    LOGI("No preprocessing steps, added frame directly to pool for feature extraction");
-                }
-
-                // Compute features
-                for (size_t i = 0; i < featureAlgos.size(); ++i) {
-                    auto* algo = featureAlgos[i];
-                    std::string inputName = featureInputs[i];
-                    std::string featureName = featureNames[i];
-                    std::string outputName = featureOutputNames[i];
-
-                    // Add special case for Tonnetz
-                    if (featureName == "Tonnetz") {
-                        LOGI("Executing special Tonnetz processing for frame %d", frameCount);
-
-                        // Check if the specified input exists in the pool
-                        if (!framePool.contains<std::vector<essentia::Real>>(inputName)) {
-                            LOGE("Input '%s' not found in pool for Tonnetz (available descriptors: %s)",
-                                  inputName.c_str(),
-                                  [&framePool]() {
-                                      std::string result = "";
-                                      auto descriptors = framePool.descriptorNames();
-                                      for (const auto& desc : descriptors) {
-                                          if (!result.empty()) result += ", ";
-                                          result += desc;
-                                      }
-                                      return result;
-                                  }().c_str());
-                            continue;
-                        }
-
-                        const auto& hpcp = framePool.value<std::vector<essentia::Real>>(inputName);
-                        LOGI("Retrieved input '%s' for Tonnetz (size: %zu)", inputName.c_str(), hpcp.size());
-
-                        // Validate HPCP size (must be 12 for Tonnetz)
-                        if (hpcp.size() != 12) {
-                            LOGE("Input '%s' vector must be 12-dimensional for Tonnetz, got %zu",
-                                  inputName.c_str(), hpcp.size());
-                            continue;
-                        }
-
-                        // Log before applying transformation
-                        LOGI("Applying Tonnetz transformation to HPCP values: [%s]",
-                              [&hpcp]() {
-                                  std::string values = "";
-                                  for (size_t i = 0; i < hpcp.size(); ++i) {
-                                      if (i > 0) values += ", ";
-                                      values += std::to_string(hpcp[i]);
-                                  }
-                                  return values;
-                              }().c_str());
-
-                        // Apply Tonnetz transformation
-                        std::vector<essentia::Real> tonnetz = mWrapper->applyTonnetzTransform(hpcp);
-
-                        // Log the result
-                        LOGI("Tonnetz transformation result: [%s]",
-                              [&tonnetz]() {
-                                  std::string values = "";
-                                  for (size_t i = 0; i < tonnetz.size(); ++i) {
-                                      if (i > 0) values += ", ";
-                                      values += std::to_string(tonnetz[i]);
-                                  }
-                                  return values;
-                              }().c_str());
-
-                        // Store in feature collectors
-                        if (featureCollectors.find("Tonnetz") == featureCollectors.end()) {
-                            featureCollectors["Tonnetz"] = std::vector<std::vector<essentia::Real>>();
-                            LOGI("Created new feature collector for Tonnetz");
-                        }
-                        featureCollectors["Tonnetz"].push_back(tonnetz);
-
-                        LOGI("Computed Tonnetz from input '%s' (size: %zu) with result size: %zu",
-                              inputName.c_str(), hpcp.size(), tonnetz.size());
-
-                        // Skip the rest of the processing for this feature
-                        continue;
-                    }
-
-                    // Special case: if the input is "frame" and we have no preprocessing steps,
-                    // use the frame directly
-                    if (inputName == "frame" && preprocessAlgos.empty()) {
-                        LOGI("Using frame directly for feature '%s'", featureNames[i].c_str());
-                        algo->input("frame").set(frame);
-                    }
-                    else {
-                        // Get the correct input data from the pool
-                        if (!framePool.contains<std::vector<essentia::Real>>(inputName)) {
-                            LOGW("Input '%s' for feature '%s' not found in pool, skipping",
-                                  inputName.c_str(), featureNames[i].c_str());
-                            continue;
-                        }
-
-                        // Connect input and output
-                        const std::vector<essentia::Real>& input = framePool.value<std::vector<essentia::Real>>(inputName);
-                        LOGI("Using input '%s' (size: %zu) for feature '%s'",
-                              inputName.c_str(), input.size(), featureNames[i].c_str());
-
-                        // Dynamically determine the input port name
-                        std::string inputPortName;
-                        auto inputs = algo->inputs();
-
-                        // Check if the algorithm has a "spectrum" input and the input is from Spectrum
-                        bool hasSpectrumInput = false;
-                        for (const auto& input : inputs) {
-                            if (input.first == "spectrum") {
-                                hasSpectrumInput = true;
-                                break;
-                            }
-                        }
-
-                        if (hasSpectrumInput && (inputName == "Spectrum" || inputName == "spectrum")) {
-                            inputPortName = "spectrum";
-                        }
-                        // Check for other common input names
-                        else {
-                            bool hasArrayInput = false;
-                            bool hasSignalInput = false;
-
-                            for (const auto& input : inputs) {
-                                if (input.first == "array") {
-                                    hasArrayInput = true;
-                                }
-                                else if (input.first == "signal") {
-                                    hasSignalInput = true;
-                                }
-                            }
-
-                            if (hasArrayInput) {
-                                inputPortName = "array";
-                            }
-                            else if (hasSignalInput) {
-                                inputPortName = "signal";
-                            }
-                            else if (!inputs.empty()) {
-                                // Use the first available input name as fallback
-                                inputPortName = inputs.begin()->first;
-                            }
-                            else {
-                                LOGE("Algorithm '%s' has no inputs", featureName.c_str());
-                                // Clean up resources
-                                for (auto* algo : preprocessAlgos) delete algo;
-                                for (auto* algo : featureAlgos) delete algo;
-                                return createErrorResponse(std::string("Algorithm '") + featureName +
-                                                          "' has no inputs", "ALGORITHM_ERROR");
-                            }
-                        }
-
-                        LOGI("Using input port '%s' for algorithm '%s'",
-                              inputPortName.c_str(), featureName.c_str());
-                        algo->input(inputPortName).set(input);
-                    }
-
-                    // Special handling for PitchYinFFT algorithm which has two outputs that must be bound
-                    if (featureName == "PitchYinFFT") {
-                        // Declare variables for both outputs
-                        essentia::Real pitchOutput;
-                        essentia::Real confidenceOutput;
-
-                        // Bind both outputs
-                        algo->output("pitch").set(pitchOutput);
-                        algo->output("pitchConfidence").set(confidenceOutput);
-
-                        // Compute algorithm
-                        algo->compute();
-
-                        // Store both outputs in the collectors
-                        if (featureCollectors.find(featureName) == featureCollectors.end()) {
-                            featureCollectors[featureName] = std::vector<std::vector<essentia::Real>>();
-                        }
-                        // Store pitch and confidence as a vector for each frame
-                        featureCollectors[featureName].push_back({pitchOutput, confidenceOutput});
-
-                        LOGI("Added feature '%s' output (pitch: %f, confidence: %f) to collectors",
-                              featureName.c_str(), pitchOutput, confidenceOutput);
-
-                        // Skip the standard output processing
-                        continue;
-                    }
-
-                    // Determine the output type
-                    const essentia::standard::OutputBase& outputBase = algo->output(outputName);
-                    std::string outputType = outputBase.typeInfo().name();
-
-                    LOGI("Output type for feature '%s': %s", featureName.c_str(), outputType.c_str());
-
-                    if (outputType.find("vector") != std::string::npos) {
-                        // Vector output (e.g., MelBands)
-                        if (featureName == "MFCC") {
-                            // Special handling for MFCC which has two outputs
-                            std::vector<essentia::Real> mfccOutput;
-                            std::vector<essentia::Real> bandsOutput;
-
-                            // Set both outputs
-                            algo->output("mfcc").set(mfccOutput);
-                            algo->output("bands").set(bandsOutput);
-
-                            // Compute algorithm
-                            algo->compute();
-
-                            // Store both outputs in the collectors
-                            if (featureCollectors.find(featureName) == featureCollectors.end()) {
-                                featureCollectors[featureName] = std::vector<std::vector<essentia::Real>>();
-                            }
-                            featureCollectors[featureName].push_back(mfccOutput);
-
-                            // Also store the bands output with a different key
-                            if (featureCollectors.find(featureName + "_bands") == featureCollectors.end()) {
-                                featureCollectors[featureName + "_bands"] = std::vector<std::vector<essentia::Real>>();
-                            }
-                            featureCollectors[featureName + "_bands"].push_back(bandsOutput);
-
-                            LOGI("Added feature '%s' output (size: %zu) and bands (size: %zu) to collectors",
-                                  featureName.c_str(), mfccOutput.size(), bandsOutput.size());
-                        }
-                        else if (featureName == "SpectralContrast") {
-                            // Special handling for SpectralContrast which also has two outputs
-                            std::vector<essentia::Real> contrastOutput;
-                            std::vector<essentia::Real> valleyOutput;
-
-                            // Set both outputs
-                            algo->output("spectralContrast").set(contrastOutput);
-                            algo->output("spectralValley").set(valleyOutput);
-
-                            // Compute algorithm
-                            algo->compute();
-
-                            // Store both outputs in the collectors
-                            if (featureCollectors.find(featureName) == featureCollectors.end()) {
-                                featureCollectors[featureName] = std::vector<std::vector<essentia::Real>>();
-                            }
-                            featureCollectors[featureName].push_back(contrastOutput);
-
-                            // Also store the valley output with a different key
-                            if (featureCollectors.find(featureName + "_valley") == featureCollectors.end()) {
-                                featureCollectors[featureName + "_valley"] = std::vector<std::vector<essentia::Real>>();
-                            }
-                            featureCollectors[featureName + "_valley"].push_back(valleyOutput);
-
-                            LOGI("Added feature '%s' output (size: %zu) and valley (size: %zu) to collectors",
-                                  featureName.c_str(), contrastOutput.size(), valleyOutput.size());
-                        }
-                        else {
-                            // Standard vector output
-                            std::vector<essentia::Real> vectorOutput;
-                            algo->output(outputName).set(vectorOutput);
-                            algo->compute();
-
-                            // Store vector output
-                            if (featureCollectors.find(featureName) == featureCollectors.end()) {
-                                featureCollectors[featureName] = std::vector<std::vector<essentia::Real>>();
-                            }
-                            featureCollectors[featureName].push_back(vectorOutput);
-                            LOGI("Added vector feature '%s' output (size: %zu) to collectors",
-                                  featureName.c_str(), vectorOutput.size());
-                        }
-                    }
-                    else if (outputType.find("Real") != std::string::npos || outputType == "f") {
-                        // Scalar output (e.g., Centroid)
-                        essentia::Real scalarOutput;
-                        algo->output(outputName).set(scalarOutput);
-                        algo->compute();
-
-                        // Store scalar output for this frame
-                        if (featureCollectors.find(featureName) == featureCollectors.end()) {
-                            featureCollectors[featureName] = std::vector<std::vector<essentia::Real>>();
-                        }
-                        // Wrap scalar in a vector for consistency
-                        featureCollectors[featureName].push_back({scalarOutput});
-                        LOGI("Added scalar feature '%s' output: %f to collectors",
-                              featureName.c_str(), scalarOutput);
-                    }
-                    else {
-                        LOGE("Unsupported output type for feature '%s': %s",
-                              featureName.c_str(), outputType.c_str());
-                        continue; // Skip unsupported types
-                    }
-                }
-            }
-
-            // Process feature data
-            for (size_t i = 0; i < featureNames.size(); ++i) {
-                const std::string& name = featureNames[i];
-                const auto& outputs = featureCollectors[name];
-
-                // Skip features that weren't computed successfully
-                if (outputs.empty()) continue;
-
-                size_t numFrames = outputs.size();
-                size_t featureSize = outputs[0].size();
-
-                if (featureSize == 1) {
-                    // Scalar feature (e.g., Centroid, ZeroCrossingRate)
-                    std::vector<essentia::Real> allValues;
-                    for (const auto& frameOutput : outputs) {
-                        allValues.push_back(frameOutput[0]); // Extract the scalar value
-                    }
-
-                    if (featureUseMean[i]) {
-                        // Compute scalar mean
-                        essentia::Real mean = 0.0;
-                        for (const auto& val : allValues) {
-                            mean += val;
-                        }
-                        mean /= allValues.size();
-
-                        finalPool.set(name + ".mean", mean); // Store as a single Real value
-                        LOGI("Stored scalar mean for '%s': %f", name.c_str(), mean);
-                    }
-
-                    if (featureUseVariance[i]) {
-                        // Compute scalar variance
-                        essentia::Real mean = 0.0;
-                        for (const auto& val : allValues) {
-                            mean += val;
-                        }
-                        mean /= allValues.size();
-
-                        essentia::Real variance = 0.0;
-                        for (const auto& val : allValues) {
-                            essentia::Real diff = val - mean;
-                            variance += diff * diff;
-                        }
-                        variance /= allValues.size();
-
-                        finalPool.set(name + ".variance", variance); // Store as a single Real value
-                        LOGI("Stored scalar variance for '%s': %f", name.c_str(), variance);
-                    }
-                } else {
-                    // Vector feature (e.g., MFCC, MelBands)
-                    // Compute mean
-                    std::vector<essentia::Real> mean(featureSize, 0.0);
-                    if (featureUseMean[i] || featureUseVariance[i]) { // Mean is needed for variance too
-                        for (const auto& frameOutput : outputs) {
-                            for (size_t j = 0; j < featureSize; ++j) {
-                                mean[j] += frameOutput[j];
-                            }
-                        }
-                        for (auto& val : mean) {
-                            val /= numFrames;
-                        }
-                        if (featureUseMean[i]) {
-                            // Fix: use set instead of add for vector means
-                            finalPool.set(name + ".mean", mean);
-                            LOGI("Stored vector mean for '%s' (size: %zu)", name.c_str(), mean.size());
-                        }
-                    }
-
-                    // Compute variance
-                    if (featureUseVariance[i]) {
-                        std::vector<essentia::Real> variance(featureSize, 0.0);
-                        for (const auto& frameOutput : outputs) {
-                            for (size_t j = 0; j < featureSize; ++j) {
-                                essentia::Real diff = frameOutput[j] - mean[j];
-                                variance[j] += diff * diff;
-                            }
-                        }
-                        for (auto& val : variance) {
-                            val /= numFrames;
-                        }
-                        // Fix: use set instead of add for vector variance
-                        finalPool.set(name + ".variance", variance);
-                        LOGI("Stored vector variance for '%s' (size: %zu)", name.c_str(), variance.size());
-                    }
-                }
-
-                // If neither mean nor variance is requested, store raw frame data
-                if (!featureUseMean[i] && !featureUseVariance[i]) {
-                    for (const auto& frameOutput : outputs) {
-                        finalPool.add(name, frameOutput);
-                    }
-                }
-            }
-
-            // Clean up resources
-            delete frameCutter;
-            for (auto* algo : preprocessAlgos) delete algo;
-            for (auto* algo : featureAlgos) delete algo;
-
-            LOGI("Processed %d frames", frameCount);
-        }
-        else {
-            // Signal-based processing
-            essentia::Pool signalPool;
-            signalPool.add("signal", mWrapper->getAudioBuffer());
-
-            // Apply preprocessing steps
-            std::string currentOutput = "signal";
-
-            for (const auto& step : config["preprocess"]) {
-                std::string name = step["name"].get<std::string>();
-
-                try {
-                    essentia::standard::Algorithm* algo = factory.create(name);
-
-                    // Configure algorithm parameters
-                    if (step.contains("params")) {
-                        json params = step["params"];
-                        for (auto& [key, value] : params.items()) {
-                            if (value.is_number_integer()) {
-                                algo->configure(key, value.get<int>());
-                            }
-                            else if (value.is_number_float()) {
-                                algo->configure(key, value.get<float>());
-                            }
-                            else if (value.is_string()) {
-                                algo->configure(key, value.get<std::string>());
-                            }
-                            else if (value.is_boolean()) {
-                                algo->configure(key, value.get<bool>());
-                            }
-                        }
-                    }
-
-                    // Connect input from previous step's output
-                    algo->input("signal").set(signalPool.value<std::vector<essentia::Real>>(currentOutput));
-
-                    // Determine the output name
-                    std::string outputName;
-                    if (mWrapper->getPrimaryOutputs().find(name) != mWrapper->getPrimaryOutputs().end()) {
-                        outputName = mWrapper->getPrimaryOutputs().at(name);
-                    } else {
-                        outputName = name;
-                        std::transform(outputName.begin(), outputName.end(), outputName.begin(), ::tolower);
-                    }
-
-                    std::vector<essentia::Real> output;
-                    algo->output(outputName).set(output);
+// Compile a pipeline config once; the returned id can be run any number of times
+std::string FeatureExtractor::preparePipeline(const std::string& pipelineJson) {
+    if (!mWrapper->isInitialized()) {
+        return createErrorResponse("Essentia not initialized", "NOT_INITIALIZED");
+    }
 
-                    // Compute algorithm
-                    algo->compute();
+    Profiler::Scope call(mWrapper->getProfiler(), "preparePipeline");
+    std::string error;
+    std::unique_ptr<PipelinePlan> plan = compilePipeline(pipelineJson, error);
+    if (!plan) {
+        return error;
+    }
 
-                    // Store result in the pool
-                    signalPool.add(name, output);
+    int pipelineId = mWrapper->addPipelinePlan(std::move(plan));
+    LOGI("Prepared pipeline %d", pipelineId);
+    return mWrapper->successResponse("{\"pipelineId\":" + std::to_string(pipelineId) + "}");
+}
 
-                    // Update current output for next iteration
-                    currentOutput = name;
+std::string FeatureExtractor::runPipeline(int pipelineId) {
+    if (mWrapper->getAudioBuffer().empty()) {
+        LOGE("No audio data loaded");
+        return createErrorResponse("No audio data loaded", "NO_AUDIO_DATA");
+    }
+    return runPipeline(pipelineId, mWrapper->getAudioBuffer());
+}
 
-                    // Clean up
-                    delete algo;
-                }
-                catch (const std::exception& e) {
-                    return createErrorResponse(std::string("Error in preprocessing step '") + name + "': " + e.what(), "ALGORITHM_ERROR");
-                }
-            }
+std::string FeatureExtractor::runPipeline(int pipelineId, const std::vector<essentia::Real>& signal) {
+    if (!mWrapper->isInitialized()) {
+        return createErrorResponse("Essentia not initialized", "NOT_INITIALIZED");
+    }
+    if (signal.empty()) {
+        return createErrorResponse("Audio signal is empty", "NO_AUDIO_DATA");
+    }
 
-            // Compute features
-            for (const auto& feature : config["features"]) {
-                std::string name = feature["name"].get<std::string>();
+    PipelinePlan* plan = mWrapper->getPipelinePlan(pipelineId);
+    if (!plan) {
+        return createErrorResponse("Unknown pipeline id " + std::to_string(pipelineId), "INVALID_PIPELINE");
+    }
+    Profiler::Scope call(mWrapper->getProfiler(), "runPipeline");
+    return runPipelinePlan(*plan, signal);
+}
 
-                if (!feature.contains("input")) {
-                    return createErrorResponse(std::string("Feature '") + name + "' is missing required 'input' field", "INVALID_CONFIG");
-                }
+std::string FeatureExtractor::releasePipeline(int pipelineId) {
+    if (!mWrapper->releasePipelinePlan(pipelineId)) {
+        return createErrorResponse("Unknown pipeline id " + std::to_string(pipelineId), "INVALID_PIPELINE");
+    }
+    return "{\"success\":true,\"data\":true}";
+}
 
-                std::string inputName = feature["input"].get<std::string>();
-
-                try {
-                    essentia::standard::Algorithm* algo = factory.create(name);
-
-                    // Configure algorithm parameters
-                    if (feature.contains("params")) {
-                        json params = feature["params"];
-                        for (auto& [key, value] : params.items()) {
-                            if (value.is_number_integer()) {
-                                algo->configure(key, value.get<int>());
-                            }
-                            else if (value.is_number_float()) {
-                                algo->configure(key, value.get<float>());
-                            }
-                            else if (value.is_string()) {
-                                algo->configure(key, value.get<std::string>());
-                            }
-                            else if (value.is_boolean()) {
-                                algo->configure(key, value.get<bool>());
-                            }
-                        }
-                    }
+std::string FeatureExtractor::startPipelineStream(int pipelineId) {
+    if (!mWrapper->isInitialized()) {
+        return createErrorResponse("Essentia not initialized", "NOT_INITIALIZED");
+    }
 
-                    // Make sure the input exists in the pool
-                    if (!signalPool.contains<std::vector<essentia::Real>>(inputName)) {
-                        delete algo;
-                        return createErrorResponse(std::string("Input '") + inputName + "' for feature '" + name + "' not found in pool", "INVALID_CONFIG");
-                    }
+    PipelinePlan* plan = mWrapper->getPipelinePlan(pipelineId);
+    if (!plan) {
+        return createErrorResponse("Unknown pipeline id " + std::to_string(pipelineId), "INVALID_PIPELINE");
+    }
+    std::string error = plan->startStream();
+    if (!error.empty()) {
+        return error;
+    }
+    return "{\"success\":true,\"data\":true}";
+}
 
-                    // Get the appropriate input port name
-                    std::string inputPortName = "signal";
-                    if (inputName == "Spectrum" || inputName == "spectrum") {
-                        inputPortName = "spectrum";
-                    }
+std::string FeatureExtractor::appendAudio(int pipelineId, const std::vector<essentia::Real>& chunk) {
+    PipelinePlan* plan = mWrapper->getPipelinePlan(pipelineId);
+    if (!plan) {
+        return createErrorResponse("Unknown pipeline id " + std::to_string(pipelineId), "INVALID_PIPELINE");
+    }
 
-                    const std::vector<essentia::Real>& input = signalPool.value<std::vector<essentia::Real>>(inputName);
+    Profiler::Scope call(mWrapper->getProfiler(), "appendAudio");
+    json data;
+    std::string error = plan->appendStream(chunk, data);
+    if (!error.empty()) {
+        return error;
+    }
+    return mWrapper->successResponse(data.dump());
+}
 
-                    // Determine the output name
-                    std::string outputName;
-                    if (mWrapper->getPrimaryOutputs().find(name) != mWrapper->getPrimaryOutputs().end()) {
-                        outputName = mWrapper->getPrimaryOutputs().at(name);
-                    } else {
-                        outputName = name;
-                        std::transform(outputName.begin(), outputName.end(), outputName.begin(), ::tolower);
-                    }
+std::string FeatureExtractor::finishPipelineStream(int pipelineId) {
+    PipelinePlan* plan = mWrapper->getPipelinePlan(pipelineId);
+    if (!plan) {
+        return createErrorResponse("Unknown pipeline id " + std::to_string(pipelineId), "INVALID_PIPELINE");
+    }
 
-                    // Connect I/O
-                    std::vector<essentia::Real> output;
-                    algo->input(inputPortName).set(input);
-                    algo->output(outputName).set(output);
+    Profiler::Scope call(mWrapper->getProfiler(), "finishPipelineStream");
+    json data;
+    std::string error = plan->finishStream(data);
+    if (!error.empty()) {
+        return error;
+    }
+    return mWrapper->successResponse(data.dump());
+}
 
-                    // Compute algorithm
-                    algo->compute();
+// Execute pipeline (prepare, run once and drop the plan)
+std::string FeatureExtractor::executePipeline(const std::string& pipelineJson) {
+    LOGI("Starting pipeline execution with configuration length: %zu", pipelineJson.length());
 
-                    // Add to final pool
-                    finalPool.add(name, output);
+    if (!mWrapper->isInitialized()) {
+        LOGE("Essentia not initialized");
+        return createErrorResponse("Essentia not initialized", "NOT_INITIALIZED");
+    }
 
-                    // Clean up
-                    delete algo;
-                }
-                catch (const std::exception& e) {
-                    return createErrorResponse(std::string("Error in feature extraction '") + name + "': " + e.what(), "ALGORITHM_ERROR");
-                }
-            }
-        }
+    if (mWrapper->getAudioBuffer().empty()) {
+        LOGE("No audio data loaded");
+        return createErrorResponse("No audio data loaded", "NO_AUDIO_DATA");
+    }
 
-        // Apply global post-processing
-        if (config.contains("postProcess")) {
-            if (config["postProcess"].contains("concatenate") &&
-                config["postProcess"]["concatenate"].get<bool>()) {
-
-                // Concatenate all feature vectors and scalars
-                std::vector<essentia::Real> concatenated;
-                for (const auto& descName : finalPool.descriptorNames()) {
-                    if (finalPool.contains<std::vector<essentia::Real>>(descName)) {
-                        // Vector descriptor
-                        const auto& values = finalPool.value<std::vector<essentia::Real>>(descName);
-                        concatenated.insert(concatenated.end(), values.begin(), values.end());
-                        LOGI("Concatenated vector '%s' (size: %zu)", descName.c_str(), values.size());
-                    } else if (finalPool.contains<essentia::Real>(descName)) {
-                        // Scalar descriptor
-                        essentia::Real value = finalPool.value<essentia::Real>(descName);
-                        concatenated.push_back(value);
-                        LOGI("Concatenated scalar '%s' (value: %f)", descName.c_str(), value);
-                    } else {
-                        // Skip unsupported types
-                        LOGW("Ignoring descriptor '%s' of unsupported type for concatenation", descName.c_str());
-                    }
-                }
+    Profiler::Scope call(mWrapper->getProfiler(), "executePipeline");
+    const std::string cacheKey = resultCacheKey("executePipeline", pipelineJson);
+    std::string cached;
+    if (cachedResult(cacheKey, cached)) {
+        return cached;
+    }
+    std::string error;
+    std::unique_ptr<PipelinePlan> plan = compilePipeline(pipelineJson, error);
+    if (!plan) {
+        return error;
+    }
 
-                finalPool.add("concatenatedFeatures", concatenated);
-                LOGI("Stored concatenatedFeatures (total size: %zu)", concatenated.size());
-            }
+    // Optional startSample/endSample (or startTime/endTime) at the top level of the config
+    SampleRange range;
+    error = mWrapper->resolveSampleRange(json::parse(pipelineJson), range);
+    if (!error.empty()) {
+        return error;
+    }
+    EssentiaWrapper::RangeScope rangeScope(*mWrapper, range);
+    return runPipelinePlan(*plan, mWrapper->analysisSignal(), cacheKey);
+}
 
-            // Add more post-processing options as needed
-        }
+std::unique_ptr<PipelinePlan> FeatureExtractor::compilePipeline(const std::string& pipelineJson, std::string& error) {
+    json config;
+    try {
+        config = json::parse(pipelineJson);
+    } catch (const json::exception& e) {
+        LOGE("Failed to parse JSON configuration: %s", e.what());
+        error = createErrorResponse(std::string("Invalid JSON configuration: ") + e.what(), "INVALID_CONFIG");
+        return nullptr;
+    }
 
-        // Convert the pool to JSON
-        json result;
-        for (const auto& descName : finalPool.descriptorNames()) {
-            try {
-                // Check if this is a scalar (Real) value first
-                if (finalPool.contains<essentia::Real>(descName)) {
-                    // For scalar values, directly store in the result
-                    result[descName] = finalPool.value<essentia::Real>(descName);
-                    LOGI("Added scalar value '%s' to result", descName.c_str());
-                }
-                // If not scalar, try vector type
-                else if (finalPool.contains<std::vector<essentia::Real>>(descName)) {
-                    const auto& values = finalPool.value<std::vector<essentia::Real>>(descName);
-                    result[descName] = values;
-                    LOGI("Added vector '%s' to result (size: %zu)", descName.c_str(), values.size());
-                }
-                // Handle other types (strings, etc.) if needed
-                else if (finalPool.contains<std::string>(descName)) {
-                    result[descName] = finalPool.value<std::string>(descName);
-                    LOGI("Added string '%s' to result", descName.c_str());
-                }
-                else {
-                    LOGW("Unknown type for descriptor '%s', skipping", descName.c_str());
-                }
-            } catch (const std::exception& e) {
-                LOGW("Failed to convert descriptor '%s' to JSON: %s", descName.c_str(), e.what());
-                // Skip descriptors that can't be converted
-            }
-        }
+    try {
+        Profiler::Scope stage(mWrapper->getProfiler(), "pipeline.compile");
+        return PipelinePlan::compile(config, *mWrapper, error);
+    } catch (const std::exception& e) {
+        std::string errorMsg = std::string("Error preparing pipeline: ") + e.what();
+        LOGE("%s", errorMsg.c_str());
+        error = createErrorResponse(errorMsg, "PIPELINE_EXECUTION_ERROR");
+        return nullptr;
+    }
+}
 
-        // Convert the pool to JSON and wrap in success format
-        std::string dataJson = poolToJson(finalPool);
-        return "{\"success\":true,\"data\":" + dataJson + "}";
+std::string FeatureExtractor::runPipelinePlan(PipelinePlan& plan, const std::vector<essentia::Real>& signal,
+                                              const std::string& cacheKey) {
+    Profiler& profiler = mWrapper->getProfiler();
+    essentia::Pool finalPool;
+    std::string error;
+    {
+        Profiler::Scope stage(profiler, "pipeline.run");
+        error = plan.run(signal, finalPool);
     }
-    catch (const std::exception& e) {
-        std::string errorMsg = std::string("Error executing pipeline: ") + e.what();
-        LOGE("%s", errorMsg.c_str());
-        return createErrorResponse(errorMsg, "PIPELINE_EXECUTION_ERROR");
+    if (!error.empty()) {
+        return error;
     }
+
+    // Convert the pool to JSON and wrap in success format
+    std::string dataJson;
+    {
+        Profiler::Scope serialize(profiler, "serialize");
+        dataJson = poolToJson(finalPool);
+    }
+    storeResult(cacheKey, finalPool);
+    return mWrapper->successResponse(dataJson);
 }
 
 // Apply tonnetz transform
@@ -1255,15 +549,25 @@ std::string FeatureExtractor::applyTonnetzTransform(const std::string& hpcpJson)
             json result = tonnetz;
             return result.dump();
         } else {
-            // Process multiple HPCP frames
+            // Process multiple HPCP frames as one contiguous matrix
             std::vector<std::vector<essentia::Real>> hpcpFrames = input.get<std::vector<std::vector<essentia::Real>>>();
-            std::vector<std::vector<essentia::Real>> tonnetzFrames;
-
+            std::vector<essentia::Real> hpcpRows;
+            hpcpRows.reserve(hpcpFrames.size() * kTonnetzHpcpSize);
             for (const auto& hpcp : hpcpFrames) {
-                if (hpcp.size() != 12) {
+                if (hpcp.size() != kTonnetzHpcpSize) {
                     return createErrorResponse("Each HPCP vector must be 12-dimensional", "INVALID_INPUT_SIZE");
                 }
-                tonnetzFrames.push_back(applyTonnetzTransform(hpcp));
+                hpcpRows.insert(hpcpRows.end(), hpcp.begin(), hpcp.end());
+            }
+
+            std::vector<essentia::Real> tonnetzRows(hpcpFrames.size() * kTonnetzSize);
+            projectTonnetz(hpcpRows.data(), hpcpFrames.size(), tonnetzRows.data());
+
+            std::vector<std::vector<essentia::Real>> tonnetzFrames;
+            tonnetzFrames.reserve(hpcpFrames.size());
+            for (size_t frame = 0; frame < hpcpFrames.size(); ++frame) {
+                const auto row = tonnetzRows.begin() + frame * kTonnetzSize;
+                tonnetzFrames.emplace_back(row, row + kTonnetzSize);
             }
 
             // Compute mean if requested
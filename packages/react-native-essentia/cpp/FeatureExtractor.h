@@ -2,22 +2,78 @@
 #ifndef FEATURE_EXTRACTOR_H
 #define FEATURE_EXTRACTOR_H
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 #include <essentia/essentia.h>
 #include "EssentiaWrapper.h"
+#include "PipelinePlan.h"
+
+class ChunkSink;
 
 class FeatureExtractor {
 public:
     FeatureExtractor(EssentiaWrapper* wrapper);
     std::string extractFeatures(const std::string& featuresJson);
+    // endSample < 0: to the end of the audio
+    std::string computeMelSpectrogram(int frameSize, int hopSize, int nMels, float fMin, float fMax,
+                                     const std::string& windowType, bool normalize, bool logScale,
+                                     int64_t startSample = 0, int64_t endSample = -1);
+    // Chunked mode: the bands go to sink chunkFrames rows at a time instead of into the
+    // response, so memory stays bounded however long the audio is. The response only
+    // carries the shape (timeSteps, nMels, sampleRate, durationMs).
     std::string computeMelSpectrogram(int frameSize, int hopSize, int nMels, float fMin, float fMax,
-                                     const std::string& windowType, bool normalize, bool logScale);
+                                     const std::string& windowType, bool normalize, bool logScale,
+                                     int64_t startSample, int64_t endSample, ChunkSink& sink,
+                                     int chunkFrames = kMelChunkFrames);
+    // Chunked mode into a file of little-endian float32 values (timeSteps x nMels,
+    // row-major); the response also carries the path
+    std::string computeMelSpectrogramToFile(int frameSize, int hopSize, int nMels, float fMin, float fMax,
+                                            const std::string& windowType, bool normalize, bool logScale,
+                                            int64_t startSample, int64_t endSample, const std::string& path,
+                                            int chunkFrames = kMelChunkFrames);
+    static const int kMelChunkFrames = 256;
     std::string executePipeline(const std::string& pipelineJson);
+
+    // Compiled pipelines: prepare once, run repeatedly on the current audio (or
+    // another buffer), release when done. Plans are owned by the wrapper.
+    std::string preparePipeline(const std::string& pipelineJson);
+    std::string runPipeline(int pipelineId);
+    std::string runPipeline(int pipelineId, const std::vector<essentia::Real>& signal);
+    std::string releasePipeline(int pipelineId);
+
+    // Incremental runs of a prepared frame-based pipeline on live audio: each
+    // appendAudio processes only the frames the chunk completes and returns their
+    // rows; finishPipelineStream flushes the tail and returns the summary.
+    std::string startPipelineStream(int pipelineId);
+    std::string appendAudio(int pipelineId, const std::vector<essentia::Real>& chunk);
+    std::string finishPipelineStream(int pipelineId);
     std::string applyTonnetzTransform(const std::string& hpcpJson);
     std::vector<essentia::Real> applyTonnetzTransform(const std::vector<essentia::Real>& hpcp);
 
 private:
+    // Mel bands of the range, handed to sink a chunk at a time; returns an empty string
+    // or the error response JSON. chunkedMelSpectrogram also fills the response data.
+    std::string chunkedMelSpectrogram(int frameSize, int hopSize, int nMels, float fMin, float fMax,
+                                      const std::string& windowType, bool normalize, bool logScale,
+                                      int64_t startSample, int64_t endSample, ChunkSink& sink,
+                                      int chunkFrames, nlohmann::json& data);
+    std::string streamMelSpectrogram(int frameSize, int hopSize, int nMels, float fMin, float fMax,
+                                     const std::string& windowType, bool normalize, bool logScale,
+                                     int64_t startSample, int64_t endSample, ChunkSink& sink,
+                                     int chunkFrames, int& numFrames);
+    std::unique_ptr<PipelinePlan> compilePipeline(const std::string& pipelineJson, std::string& error);
+    // Stores the result pool under cacheKey unless it is empty
+    std::string runPipelinePlan(PipelinePlan& plan, const std::vector<essentia::Real>& signal,
+                                const std::string& cacheKey = std::string());
+
+    // ResultCache lookups of extractFeatures / executePipeline on the loaded audio. The
+    // key is empty when the cache is disabled; a hit is answered without running anything.
+    std::string resultCacheKey(const char* kind, const std::string& configJson);
+    bool cachedResult(const std::string& cacheKey, std::string& response);
+    void storeResult(const std::string& cacheKey, const essentia::Pool& pool);
+
     EssentiaWrapper* mWrapper;
 };
 
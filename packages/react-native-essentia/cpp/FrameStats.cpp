@@ -0,0 +1,148 @@
+// packages/react-native-essentia/cpp/FrameStats.cpp
+#include "FrameStats.h"
+
+#include <algorithm>
+#include <cmath>
+
+FrameStats::Quantile::Quantile(double p) : mP(p) {}
+
+void FrameStats::Quantile::add(double x) {
+    // Until five samples arrive the markers are just the sorted samples
+    if (mCount < 5) {
+        auto end = mHeights.begin() + mCount;
+        auto at = std::upper_bound(mHeights.begin(), end, x);
+        std::copy_backward(at, end, end + 1);
+        *at = x;
+        mCount++;
+        if (mCount == 5) {
+            mPositions = {1, 2, 3, 4, 5};
+            mDesired = {1, 1 + 2 * mP, 1 + 4 * mP, 3 + 2 * mP, 5};
+            mIncrements = {0, mP / 2, mP, (1 + mP) / 2, 1};
+        }
+        return;
+    }
+    mCount++;
+
+    // Cell of x, widening the extreme markers if needed
+    int k;
+    if (x < mHeights[0]) {
+        mHeights[0] = x;
+        k = 0;
+    } else if (x >= mHeights[4]) {
+        mHeights[4] = x;
+        k = 3;
+    } else {
+        k = 0;
+        while (k < 3 && x >= mHeights[k + 1]) k++;
+    }
+
+    for (int i = k + 1; i < 5; ++i) mPositions[i] += 1;
+    for (int i = 0; i < 5; ++i) mDesired[i] += mIncrements[i];
+
+    // Move the middle markers towards their desired positions
+    for (int i = 1; i <= 3; ++i) {
+        const double d = mDesired[i] - mPositions[i];
+        if ((d >= 1 && mPositions[i + 1] - mPositions[i] > 1) ||
+            (d <= -1 && mPositions[i - 1] - mPositions[i] < -1)) {
+            const int step = d > 0 ? 1 : -1;
+            const double candidate = parabolic(i, step);
+            if (mHeights[i - 1] < candidate && candidate < mHeights[i + 1]) {
+                mHeights[i] = candidate;
+            } else {
+                mHeights[i] = linear(i, step);
+            }
+            mPositions[i] += step;
+        }
+    }
+}
+
+double FrameStats::Quantile::parabolic(int i, double d) const {
+    const double* q = mHeights.data();
+    const double* n = mPositions.data();
+    return q[i] + d / (n[i + 1] - n[i - 1]) *
+                      ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i]) +
+                       (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+}
+
+double FrameStats::Quantile::linear(int i, int d) const {
+    return mHeights[i] + d * (mHeights[i + d] - mHeights[i]) / (mPositions[i + d] - mPositions[i]);
+}
+
+double FrameStats::Quantile::value() const {
+    if (mCount == 0) return 0;
+    if (mCount >= 5) {
+        // The outer markers are the exact minimum and maximum; the middle one only
+        // estimates interior quantiles (its P² update collapses at p = 0 and p = 1)
+        if (mP <= 0) return mHeights[0];
+        if (mP >= 1) return mHeights[4];
+        return mHeights[2];
+    }
+
+    // Exact, interpolating between the sorted samples
+    const double position = mP * static_cast<double>(mCount - 1);
+    const size_t below = static_cast<size_t>(std::floor(position));
+    const size_t above = std::min<size_t>(below + 1, static_cast<size_t>(mCount - 1));
+    return mHeights[below] + (position - below) * (mHeights[above] - mHeights[below]);
+}
+
+FrameStats::FrameStats(std::vector<essentia::Real> percentiles) : mPercentiles(std::move(percentiles)) {}
+
+void FrameStats::add(const std::vector<essentia::Real>& frame) {
+    if (mCount == 0) {
+        const size_t size = frame.size();
+        mMean.assign(size, 0.0);
+        mM2.assign(size, 0.0);
+        mMin.assign(frame.begin(), frame.end());
+        mMax.assign(frame.begin(), frame.end());
+        mQuantiles.assign(mPercentiles.size(), {});
+        for (size_t p = 0; p < mPercentiles.size(); ++p) {
+            mQuantiles[p].assign(size, Quantile(mPercentiles[p] / 100.0));
+        }
+    }
+    mCount++;
+
+    const double n = static_cast<double>(mCount);
+    for (size_t j = 0; j < mMean.size(); ++j) {
+        const essentia::Real value = j < frame.size() ? frame[j] : 0;
+        const double delta = value - mMean[j];
+        mMean[j] += delta / n;
+        mM2[j] += delta * (value - mMean[j]);
+        mMin[j] = std::min(mMin[j], value);
+        mMax[j] = std::max(mMax[j], value);
+        for (auto& quantiles : mQuantiles) {
+            quantiles[j].add(value);
+        }
+    }
+}
+
+void FrameStats::clear() {
+    mCount = 0;
+    mMean.clear();
+    mM2.clear();
+    mMin.clear();
+    mMax.clear();
+    mQuantiles.clear();
+}
+
+std::vector<essentia::Real> FrameStats::mean() const {
+    return std::vector<essentia::Real>(mMean.begin(), mMean.end());
+}
+
+std::vector<essentia::Real> FrameStats::variance() const {
+    std::vector<essentia::Real> variance(mM2.size(), 0.0);
+    if (mCount == 0) return variance;
+    for (size_t j = 0; j < mM2.size(); ++j) {
+        variance[j] = static_cast<essentia::Real>(mM2[j] / static_cast<double>(mCount));
+    }
+    return variance;
+}
+
+std::vector<essentia::Real> FrameStats::percentile(size_t index) const {
+    std::vector<essentia::Real> values;
+    if (index >= mQuantiles.size()) return values;
+    values.reserve(mQuantiles[index].size());
+    for (const auto& quantile : mQuantiles[index]) {
+        values.push_back(static_cast<essentia::Real>(quantile.value()));
+    }
+    return values;
+}
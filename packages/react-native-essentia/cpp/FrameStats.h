@@ -0,0 +1,66 @@
+// packages/react-native-essentia/cpp/FrameStats.h
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "essentia/essentia.h"
+
+// Per-dimension statistics of a stream of frames, updated one frame at a time in
+// constant memory: mean and (population) variance with Welford's method, min,
+// max, and optionally percentiles with the P-square estimator (Jain & Chlamtac,
+// five markers per percentile, exact while fewer than five frames were seen).
+//
+// The dimension is fixed by the first frame. Later frames that are shorter count
+// their missing values as 0 and longer ones are truncated, as the collectors this
+// replaces did.
+class FrameStats {
+public:
+    // percentiles in [0, 100]
+    explicit FrameStats(std::vector<essentia::Real> percentiles = {});
+
+    void add(const std::vector<essentia::Real>& frame);
+    void clear();
+
+    int64_t count() const { return mCount; }
+    size_t size() const { return mMean.size(); }
+    const std::vector<essentia::Real>& percentiles() const { return mPercentiles; }
+
+    std::vector<essentia::Real> mean() const;
+    std::vector<essentia::Real> variance() const;
+    const std::vector<essentia::Real>& min() const { return mMin; }
+    const std::vector<essentia::Real>& max() const { return mMax; }
+    // Estimate for percentiles()[index]
+    std::vector<essentia::Real> percentile(size_t index) const;
+
+private:
+    class Quantile {
+    public:
+        explicit Quantile(double p = 0.5);
+        void add(double x);
+        double value() const;
+
+    private:
+        double parabolic(int i, double d) const;
+        double linear(int i, int d) const;
+
+        double mP;
+        int64_t mCount = 0;
+        std::array<double, 5> mHeights{};   // marker heights (the first samples until five arrive)
+        std::array<double, 5> mPositions{};
+        std::array<double, 5> mDesired{};
+        std::array<double, 5> mIncrements{};
+    };
+
+    std::vector<essentia::Real> mPercentiles;
+    int64_t mCount = 0;
+    std::vector<double> mMean;
+    std::vector<double> mM2;
+    std::vector<essentia::Real> mMin;
+    std::vector<essentia::Real> mMax;
+    std::vector<std::vector<Quantile>> mQuantiles;  // [percentile][dimension]
+};
+
+#endif
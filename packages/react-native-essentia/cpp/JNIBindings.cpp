@@ -4,9 +4,25 @@
 #endif
 #include "EssentiaWrapper.h"
 #include "FeatureExtractor.h"
+#include "PoolCodec.h"
+#include "ResultCache.h"
+#include "EssentiaRuntime.h"
 #include "Utils.h"
 
-// Helper function to convert jlong to EssentiaWrapper pointer
+#include <map>
+#include <mutex>
+
+namespace {
+// Encoded pools handed to Java by executeAlgorithmBinary, keyed by the address of
+// their bytes. The ByteBuffer wraps the vector's own block, and releaseBuffer only
+// frees addresses found here, so a foreign or already released buffer is a no-op.
+std::mutex gBufferMutex;
+std::map<void*, std::vector<uint8_t>> gBuffers;
+}
+
+// Helper function to convert jlong to EssentiaWrapper pointer. Each handle is an
+// independent session; calls on one handle are serialized by its sessionMutex, calls
+// on different handles run concurrently.
 EssentiaWrapper* getWrapper(JNIEnv* env, jlong ptr) {
     return reinterpret_cast<EssentiaWrapper*>(ptr);
 }
@@ -26,22 +42,46 @@ extern "C" JNIEXPORT void JNICALL destroyEssentiaWrapper(JNIEnv* env, jobject th
 // 3. Initialize Essentia
 extern "C" JNIEXPORT jboolean JNICALL initializeEssentia(JNIEnv* env, jobject /* thiz */, jlong ptr) {
     EssentiaWrapper* wrapper = getWrapper(env, ptr);
+    std::lock_guard<std::mutex> sessionLock(wrapper->sessionMutex());
     return wrapper->initialize() ? JNI_TRUE : JNI_FALSE; // Assuming initialize() returns bool
 }
 
 // 4. Set audio data
 extern "C" JNIEXPORT jboolean JNICALL setAudioData(JNIEnv* env, jobject /* thiz */, jlong ptr, jfloatArray audioData, jdouble sampleRate) {
     EssentiaWrapper* wrapper = getWrapper(env, ptr);
+    std::lock_guard<std::mutex> sessionLock(wrapper->sessionMutex());
     jsize len = env->GetArrayLength(audioData);
-    jfloat* data = env->GetFloatArrayElements(audioData, nullptr);
-    std::vector<float> buffer(data, data + len); // Assuming Essentia uses std::vector<float>
-    env->ReleaseFloatArrayElements(audioData, data, 0);
-    return wrapper->setAudioData(buffer, sampleRate) ? JNI_TRUE : JNI_FALSE; // Assuming method exists
+    // Copied once, straight into the buffer the wrapper takes over (with room for the
+    // even-length padding sample)
+    std::vector<float> buffer;
+    buffer.reserve(static_cast<size_t>(len) + len % 2);
+    buffer.resize(len);
+    env->GetFloatArrayRegion(audioData, 0, len, buffer.data());
+    return wrapper->setAudioData(std::move(buffer), sampleRate) ? JNI_TRUE : JNI_FALSE;
+}
+
+// 4b. Set audio data from a direct ByteBuffer of native-order floats, e.g. a
+// MappedByteBuffer over the PCM data of a WAV file, without going through a FloatArray
+extern "C" JNIEXPORT jboolean JNICALL setAudioDataDirect(JNIEnv* env, jobject /* thiz */, jlong ptr, jobject audioData, jdouble sampleRate) {
+    EssentiaWrapper* wrapper = getWrapper(env, ptr);
+    std::lock_guard<std::mutex> sessionLock(wrapper->sessionMutex());
+    const float* data = static_cast<const float*>(env->GetDirectBufferAddress(audioData));
+    jlong capacity = env->GetDirectBufferCapacity(audioData);
+    if (data == nullptr || capacity < 0) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "audioData must be a direct ByteBuffer");
+        return JNI_FALSE;
+    }
+    size_t len = static_cast<size_t>(capacity) / sizeof(float);
+    std::vector<float> buffer;
+    buffer.reserve(len + len % 2);
+    buffer.assign(data, data + len);
+    return wrapper->setAudioData(std::move(buffer), sampleRate) ? JNI_TRUE : JNI_FALSE;
 }
 
 // 5. Execute algorithm
 extern "C" JNIEXPORT jstring JNICALL executeAlgorithm(JNIEnv* env, jobject /* thiz */, jlong ptr, jstring algorithm, jstring paramsJson) {
     EssentiaWrapper* wrapper = getWrapper(env, ptr);
+    std::lock_guard<std::mutex> sessionLock(wrapper->sessionMutex());
     const char* algoStr = env->GetStringUTFChars(algorithm, nullptr);
     const char* paramsStr = env->GetStringUTFChars(paramsJson, nullptr);
     std::string result = wrapper->executeAlgorithm(algoStr, paramsStr); // Assuming method exists
@@ -50,6 +90,50 @@ extern "C" JNIEXPORT jstring JNICALL executeAlgorithm(JNIEnv* env, jobject /* th
     return env->NewStringUTF(result.c_str());
 }
 
+// 5b. Execute algorithm, returning the result pool in the binary encoding (see PoolCodec.h)
+// as a direct ByteBuffer that must be freed with nativeReleaseBuffer. Errors are thrown as
+// RuntimeException with the error response JSON as message.
+extern "C" JNIEXPORT jobject JNICALL executeAlgorithmBinary(JNIEnv* env, jobject /* thiz */, jlong ptr, jstring algorithm, jstring paramsJson) {
+    EssentiaWrapper* wrapper = getWrapper(env, ptr);
+    std::lock_guard<std::mutex> sessionLock(wrapper->sessionMutex());
+    const char* algoStr = env->GetStringUTFChars(algorithm, nullptr);
+    const char* paramsStr = env->GetStringUTFChars(paramsJson, nullptr);
+    essentia::Pool pool;
+    std::string error = wrapper->executeAlgorithm(algoStr, paramsStr, pool);
+    env->ReleaseStringUTFChars(algorithm, algoStr);
+    env->ReleaseStringUTFChars(paramsJson, paramsStr);
+
+    if (!error.empty()) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), error.c_str());
+        return nullptr;
+    }
+
+    std::vector<uint8_t> encoded = poolToBinary(pool);
+    void* bytes = encoded.data();
+    jlong size = static_cast<jlong>(encoded.size());
+    {
+        // Moving the vector keeps its heap block, so bytes stays valid
+        std::lock_guard<std::mutex> lock(gBufferMutex);
+        gBuffers.emplace(bytes, std::move(encoded));
+    }
+    jobject buffer = env->NewDirectByteBuffer(bytes, size);
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(gBufferMutex);
+        gBuffers.erase(bytes);
+    }
+    return buffer;
+}
+
+// 5c. Free a buffer returned by executeAlgorithmBinary
+extern "C" JNIEXPORT void JNICALL releaseBuffer(JNIEnv* env, jobject /* thiz */, jobject buffer) {
+    if (!buffer) {
+        return;
+    }
+    void* bytes = env->GetDirectBufferAddress(buffer);
+    std::lock_guard<std::mutex> lock(gBufferMutex);
+    gBuffers.erase(bytes);
+}
+
 // 6. Test JNI connection
 extern "C" JNIEXPORT jstring JNICALL testJniConnection(JNIEnv* env, jobject /* thiz */) {
     return env->NewStringUTF("JNI connection successful");
@@ -58,6 +142,7 @@ extern "C" JNIEXPORT jstring JNICALL testJniConnection(JNIEnv* env, jobject /* t
 // 7. Get algorithm info
 extern "C" JNIEXPORT jstring JNICALL getAlgorithmInfo(JNIEnv* env, jobject /* thiz */, jlong ptr, jstring algorithm) {
     EssentiaWrapper* wrapper = getWrapper(env, ptr);
+    std::lock_guard<std::mutex> sessionLock(wrapper->sessionMutex());
     const char* algoStr = env->GetStringUTFChars(algorithm, nullptr);
     std::string result = wrapper->getAlgorithmInfo(algoStr); // Assuming method exists
     env->ReleaseStringUTFChars(algorithm, algoStr);
@@ -67,6 +152,7 @@ extern "C" JNIEXPORT jstring JNICALL getAlgorithmInfo(JNIEnv* env, jobject /* th
 // 8. Get all algorithms
 extern "C" JNIEXPORT jstring JNICALL getAllAlgorithms(JNIEnv* env, jobject /* thiz */, jlong ptr) {
     EssentiaWrapper* wrapper = getWrapper(env, ptr);
+    std::lock_guard<std::mutex> sessionLock(wrapper->sessionMutex());
     std::string result = wrapper->getAllAlgorithms(); // Assuming method exists
     return env->NewStringUTF(result.c_str());
 }
@@ -74,6 +160,7 @@ extern "C" JNIEXPORT jstring JNICALL getAllAlgorithms(JNIEnv* env, jobject /* th
 // 9. Extract features
 extern "C" JNIEXPORT jstring JNICALL nativeExtractFeatures(JNIEnv* env, jobject /* thiz */, jlong ptr, jstring featuresJson) {
     EssentiaWrapper* wrapper = getWrapper(env, ptr);
+    std::lock_guard<std::mutex> sessionLock(wrapper->sessionMutex());
     FeatureExtractor extractor(wrapper); // Assuming FeatureExtractor constructor takes EssentiaWrapper*
     const char* jsonStr = env->GetStringUTFChars(featuresJson, nullptr);
     std::string result = extractor.extractFeatures(jsonStr); // Assuming method exists
@@ -87,18 +174,35 @@ extern "C" JNIEXPORT jstring JNICALL getVersion(JNIEnv* env, jobject /* thiz */)
 }
 
 // 11. Compute mel spectrogram
-extern "C" JNIEXPORT jstring JNICALL nativeComputeMelSpectrogram(JNIEnv* env, jobject /* thiz */, jlong ptr, jint frameSize, jint hopSize, jint nMels, jfloat fMin, jfloat fMax, jstring windowType, jboolean normalize, jboolean logScale) {
+extern "C" JNIEXPORT jstring JNICALL nativeComputeMelSpectrogram(JNIEnv* env, jobject /* thiz */, jlong ptr, jint frameSize, jint hopSize, jint nMels, jfloat fMin, jfloat fMax, jstring windowType, jboolean normalize, jboolean logScale, jlong startSample, jlong endSample) {
+    EssentiaWrapper* wrapper = getWrapper(env, ptr);
+    std::lock_guard<std::mutex> sessionLock(wrapper->sessionMutex());
+    FeatureExtractor extractor(wrapper);
+    const char* windowStr = env->GetStringUTFChars(windowType, nullptr);
+    std::string result = extractor.computeMelSpectrogram(frameSize, hopSize, nMels, fMin, fMax, windowStr, normalize, logScale,
+                                                         startSample, endSample);
+    env->ReleaseStringUTFChars(windowType, windowStr);
+    return env->NewStringUTF(result.c_str());
+}
+
+// 11b. Compute mel spectrogram into a file a chunk of frames at a time (bounded memory)
+extern "C" JNIEXPORT jstring JNICALL nativeComputeMelSpectrogramToFile(JNIEnv* env, jobject /* thiz */, jlong ptr, jint frameSize, jint hopSize, jint nMels, jfloat fMin, jfloat fMax, jstring windowType, jboolean normalize, jboolean logScale, jlong startSample, jlong endSample, jstring path, jint chunkFrames) {
     EssentiaWrapper* wrapper = getWrapper(env, ptr);
+    std::lock_guard<std::mutex> sessionLock(wrapper->sessionMutex());
     FeatureExtractor extractor(wrapper);
     const char* windowStr = env->GetStringUTFChars(windowType, nullptr);
-    std::string result = extractor.computeMelSpectrogram(frameSize, hopSize, nMels, fMin, fMax, windowStr, normalize, logScale); // Assuming method exists
+    const char* pathStr = env->GetStringUTFChars(path, nullptr);
+    std::string result = extractor.computeMelSpectrogramToFile(frameSize, hopSize, nMels, fMin, fMax, windowStr, normalize, logScale,
+                                                               startSample, endSample, pathStr, chunkFrames);
     env->ReleaseStringUTFChars(windowType, windowStr);
+    env->ReleaseStringUTFChars(path, pathStr);
     return env->NewStringUTF(result.c_str());
 }
 
 // 12. Execute pipeline
 extern "C" JNIEXPORT jstring JNICALL nativeExecutePipeline(JNIEnv* env, jobject /* thiz */, jlong ptr, jstring pipelineJson) {
     EssentiaWrapper* wrapper = getWrapper(env, ptr);
+    std::lock_guard<std::mutex> sessionLock(wrapper->sessionMutex());
     FeatureExtractor extractor(wrapper);
     const char* jsonStr = env->GetStringUTFChars(pipelineJson, nullptr);
     std::string result = extractor.executePipeline(jsonStr); // Assuming method exists
@@ -106,9 +210,74 @@ extern "C" JNIEXPORT jstring JNICALL nativeExecutePipeline(JNIEnv* env, jobject
     return env->NewStringUTF(result.c_str());
 }
 
+// Compile a pipeline once; resolves to {"pipelineId": n}
+extern "C" JNIEXPORT jstring JNICALL nativePreparePipeline(JNIEnv* env, jobject /* thiz */, jlong ptr, jstring pipelineJson) {
+    EssentiaWrapper* wrapper = getWrapper(env, ptr);
+    std::lock_guard<std::mutex> sessionLock(wrapper->sessionMutex());
+    FeatureExtractor extractor(wrapper);
+    const char* jsonStr = env->GetStringUTFChars(pipelineJson, nullptr);
+    std::string result = extractor.preparePipeline(jsonStr);
+    env->ReleaseStringUTFChars(pipelineJson, jsonStr);
+    return env->NewStringUTF(result.c_str());
+}
+
+// Run a prepared pipeline on the current audio, or on audioData when it is not null
+extern "C" JNIEXPORT jstring JNICALL nativeRunPipeline(JNIEnv* env, jobject /* thiz */, jlong ptr, jint pipelineId, jfloatArray audioData) {
+    EssentiaWrapper* wrapper = getWrapper(env, ptr);
+    std::lock_guard<std::mutex> sessionLock(wrapper->sessionMutex());
+    FeatureExtractor extractor(wrapper);
+    std::string result;
+    if (audioData == nullptr) {
+        result = extractor.runPipeline(pipelineId);
+    } else {
+        jsize len = env->GetArrayLength(audioData);
+        std::vector<float> buffer(len);
+        env->GetFloatArrayRegion(audioData, 0, len, buffer.data());
+        result = extractor.runPipeline(pipelineId, buffer);
+    }
+    return env->NewStringUTF(result.c_str());
+}
+
+extern "C" JNIEXPORT jstring JNICALL nativeReleasePipeline(JNIEnv* env, jobject /* thiz */, jlong ptr, jint pipelineId) {
+    EssentiaWrapper* wrapper = getWrapper(env, ptr);
+    std::lock_guard<std::mutex> sessionLock(wrapper->sessionMutex());
+    FeatureExtractor extractor(wrapper);
+    std::string result = extractor.releasePipeline(pipelineId);
+    return env->NewStringUTF(result.c_str());
+}
+
+// Streaming runs of a prepared pipeline
+extern "C" JNIEXPORT jstring JNICALL nativeStartPipelineStream(JNIEnv* env, jobject /* thiz */, jlong ptr, jint pipelineId) {
+    EssentiaWrapper* wrapper = getWrapper(env, ptr);
+    std::lock_guard<std::mutex> sessionLock(wrapper->sessionMutex());
+    FeatureExtractor extractor(wrapper);
+    std::string result = extractor.startPipelineStream(pipelineId);
+    return env->NewStringUTF(result.c_str());
+}
+
+extern "C" JNIEXPORT jstring JNICALL nativeAppendAudio(JNIEnv* env, jobject /* thiz */, jlong ptr, jint pipelineId, jfloatArray audioData) {
+    EssentiaWrapper* wrapper = getWrapper(env, ptr);
+    std::lock_guard<std::mutex> sessionLock(wrapper->sessionMutex());
+    FeatureExtractor extractor(wrapper);
+    jsize len = env->GetArrayLength(audioData);
+    std::vector<float> chunk(len);
+    env->GetFloatArrayRegion(audioData, 0, len, chunk.data());
+    std::string result = extractor.appendAudio(pipelineId, chunk);
+    return env->NewStringUTF(result.c_str());
+}
+
+extern "C" JNIEXPORT jstring JNICALL nativeFinishPipelineStream(JNIEnv* env, jobject /* thiz */, jlong ptr, jint pipelineId) {
+    EssentiaWrapper* wrapper = getWrapper(env, ptr);
+    std::lock_guard<std::mutex> sessionLock(wrapper->sessionMutex());
+    FeatureExtractor extractor(wrapper);
+    std::string result = extractor.finishPipelineStream(pipelineId);
+    return env->NewStringUTF(result.c_str());
+}
+
 // 13. Compute spectrum
 extern "C" JNIEXPORT jboolean JNICALL nativeComputeSpectrum(JNIEnv* env, jobject /* thiz */, jlong ptr, jint frameSize, jint hopSize) {
     EssentiaWrapper* wrapper = getWrapper(env, ptr);
+    std::lock_guard<std::mutex> sessionLock(wrapper->sessionMutex());
     wrapper->computeSpectrum(frameSize, hopSize); // Assuming method exists
     return wrapper->getSpectrumComputed() ? JNI_TRUE : JNI_FALSE; // Assuming method exists
 }
@@ -116,6 +285,7 @@ extern "C" JNIEXPORT jboolean JNICALL nativeComputeSpectrum(JNIEnv* env, jobject
 // Add a dedicated method for Tonnetz transformation using nlohmann/json
 extern "C" JNIEXPORT jstring JNICALL nativeComputeTonnetz(JNIEnv* env, jobject /* thiz */, jlong ptr, jstring hpcpJson) {
     EssentiaWrapper* wrapper = getWrapper(env, ptr);
+    std::lock_guard<std::mutex> sessionLock(wrapper->sessionMutex());
     const char* jsonStr = env->GetStringUTFChars(hpcpJson, nullptr);
 
     // Parse the HPCP array from JSON
@@ -155,6 +325,35 @@ extern "C" JNIEXPORT jstring JNICALL nativeComputeTonnetz(JNIEnv* env, jobject /
     return env->NewStringUTF(result.c_str());
 }
 
+// Set the number of worker threads used for frame-parallel processing
+extern "C" JNIEXPORT void JNICALL nativeSetFrameThreadCount(JNIEnv* env, jobject /* thiz */, jlong ptr, jint count) {
+    EssentiaWrapper* wrapper = getWrapper(env, ptr);
+    wrapper->setFrameThreadCount(count);
+}
+
+// Add a "profile" section (per-stage timings) to success responses
+extern "C" JNIEXPORT void JNICALL nativeSetProfilingEnabled(JNIEnv* env, jobject /* thiz */, jlong ptr, jboolean enabled) {
+    EssentiaWrapper* wrapper = getWrapper(env, ptr);
+    wrapper->setProfilingEnabled(enabled == JNI_TRUE);
+}
+
+// Size the result memo cache shared by all sessions (0 disables it); directory, when
+// not empty, persists the entries
+extern "C" JNIEXPORT void JNICALL nativeConfigureResultCache(JNIEnv* env, jobject /* thiz */, jlong maxBytes, jstring directory) {
+    const char* directoryStr = env->GetStringUTFChars(directory, nullptr);
+    ResultCache::shared().configure(maxBytes > 0 ? static_cast<size_t>(maxBytes) : 0, directoryStr);
+    env->ReleaseStringUTFChars(directory, directoryStr);
+}
+
+extern "C" JNIEXPORT void JNICALL nativeClearResultCache(JNIEnv* env, jobject /* thiz */) {
+    ResultCache::shared().clear();
+}
+
+// Register the algorithms on first use (default) or when the first session initializes
+extern "C" JNIEXPORT void JNICALL nativeSetLazyRegistration(JNIEnv* env, jobject /* thiz */, jboolean lazy) {
+    EssentiaRuntime::setLazyRegistration(lazy == JNI_TRUE);
+}
+
 // JNI_OnLoad function (unchanged from your code)
 extern "C" JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void* reserved) {
     JNIEnv* env;
@@ -172,16 +371,31 @@ extern "C" JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void* reserved) {
         {"nativeDestroyEssentiaWrapper", "(J)V", (void*)destroyEssentiaWrapper},
         {"nativeInitializeEssentia", "(J)Z", (void*)initializeEssentia},
         {"nativeSetAudioData", "(J[FD)Z", (void*)setAudioData},
+        {"nativeSetAudioDataDirect", "(JLjava/nio/ByteBuffer;D)Z", (void*)setAudioDataDirect},
         {"nativeExecuteAlgorithm", "(JLjava/lang/String;Ljava/lang/String;)Ljava/lang/String;", (void*)executeAlgorithm},
         {"testJniConnection", "()Ljava/lang/String;", (void*)testJniConnection},
         {"nativeGetAlgorithmInfo", "(JLjava/lang/String;)Ljava/lang/String;", (void*)getAlgorithmInfo},
         {"nativeGetAllAlgorithms", "(J)Ljava/lang/String;", (void*)getAllAlgorithms},
         {"nativeExtractFeatures", "(JLjava/lang/String;)Ljava/lang/String;", (void*)nativeExtractFeatures},
         {"getVersion", "()Ljava/lang/String;", (void*)getVersion},
-        {"nativeComputeMelSpectrogram", "(JIIIFFLjava/lang/String;ZZ)Ljava/lang/String;", (void*)nativeComputeMelSpectrogram},
+        {"nativeComputeMelSpectrogram", "(JIIIFFLjava/lang/String;ZZJJ)Ljava/lang/String;", (void*)nativeComputeMelSpectrogram},
+        {"nativeComputeMelSpectrogramToFile", "(JIIIFFLjava/lang/String;ZZJJLjava/lang/String;I)Ljava/lang/String;", (void*)nativeComputeMelSpectrogramToFile},
         {"nativeExecutePipeline", "(JLjava/lang/String;)Ljava/lang/String;", (void*)nativeExecutePipeline},
         {"nativeComputeSpectrum", "(JII)Z", (void*)nativeComputeSpectrum},
         {"nativeComputeTonnetz", "(JLjava/lang/String;)Ljava/lang/String;", (void*)nativeComputeTonnetz},
+        {"nativeSetFrameThreadCount", "(JI)V", (void*)nativeSetFrameThreadCount},
+        {"nativeSetProfilingEnabled", "(JZ)V", (void*)nativeSetProfilingEnabled},
+        {"nativeExecuteAlgorithmBinary", "(JLjava/lang/String;Ljava/lang/String;)Ljava/nio/ByteBuffer;", (void*)executeAlgorithmBinary},
+        {"nativeReleaseBuffer", "(Ljava/nio/ByteBuffer;)V", (void*)releaseBuffer},
+        {"nativePreparePipeline", "(JLjava/lang/String;)Ljava/lang/String;", (void*)nativePreparePipeline},
+        {"nativeRunPipeline", "(JI[F)Ljava/lang/String;", (void*)nativeRunPipeline},
+        {"nativeReleasePipeline", "(JI)Ljava/lang/String;", (void*)nativeReleasePipeline},
+        {"nativeStartPipelineStream", "(JI)Ljava/lang/String;", (void*)nativeStartPipelineStream},
+        {"nativeAppendAudio", "(JI[F)Ljava/lang/String;", (void*)nativeAppendAudio},
+        {"nativeFinishPipelineStream", "(JI)Ljava/lang/String;", (void*)nativeFinishPipelineStream},
+        {"nativeConfigureResultCache", "(JLjava/lang/String;)V", (void*)nativeConfigureResultCache},
+        {"nativeClearResultCache", "()V", (void*)nativeClearResultCache},
+        {"nativeSetLazyRegistration", "(Z)V", (void*)nativeSetLazyRegistration},
     };
 
     int rc = env->RegisterNatives(clazz, methods, sizeof(methods) / sizeof(methods[0]));
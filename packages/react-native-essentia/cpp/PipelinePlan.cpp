@@ -0,0 +1,833 @@
+// packages/react-native-essentia/cpp/PipelinePlan.cpp
+#include "PipelinePlan.h"
+#include "EssentiaWrapper.h"
+#include "TonnetzKernel.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <typeinfo>
+
+using json = nlohmann::json;
+
+namespace {
+
+bool isSpectrumName(const std::string& name) {
+    return name == "Spectrum" || name == "spectrum";
+}
+
+std::map<std::string, essentia::Parameter> paramsOf(const json& node) {
+    if (!node.contains("params") || !node["params"].is_object()) {
+        return {};
+    }
+    return jsonToParamsMap(node["params"].dump());
+}
+
+// Primary output port of an algorithm; unknown algorithms use their own name
+// (lowercased everywhere except the frame-based preprocess chain, as before)
+std::string outputPortFor(const std::map<std::string, std::string>& primaryOutputs,
+                          const std::string& name, bool lowercase) {
+    auto it = primaryOutputs.find(name);
+    if (it != primaryOutputs.end()) {
+        return it->second;
+    }
+    std::string port = name;
+    if (lowercase) {
+        std::transform(port.begin(), port.end(), port.begin(), ::tolower);
+    }
+    return port;
+}
+
+bool postProcessFlag(const json& feature, const char* key) {
+    return feature.contains("postProcess") && feature["postProcess"].contains(key) &&
+           feature["postProcess"][key].is_boolean() && feature["postProcess"][key].get<bool>();
+}
+
+// Input port of a frame-based feature: "spectrum" for Spectrum outputs when the
+// algorithm has one, otherwise "array", "signal" or its first input
+std::string featureInputPort(essentia::standard::Algorithm* algo, const std::string& inputName,
+                             bool noPreprocess) {
+    if (inputName == "frame" && noPreprocess) {
+        return "frame";
+    }
+    const auto& inputs = algo->inputs();
+    bool hasSpectrum = false, hasArray = false, hasSignal = false;
+    for (const auto& input : inputs) {
+        hasSpectrum = hasSpectrum || input.first == "spectrum";
+        hasArray = hasArray || input.first == "array";
+        hasSignal = hasSignal || input.first == "signal";
+    }
+    if (hasSpectrum && isSpectrumName(inputName)) return "spectrum";
+    if (hasArray) return "array";
+    if (hasSignal) return "signal";
+    return inputs.empty() ? std::string() : inputs.begin()->first;
+}
+
+// "50", "12.5", ... for the .p<percentile> descriptors
+std::string percentileLabel(essentia::Real percentile) {
+    char label[32];
+    snprintf(label, sizeof(label), "%g", static_cast<double>(percentile));
+    return label;
+}
+
+} // namespace
+
+PipelinePlan::Node::~Node() {
+    if (algo && !reusable) {
+        algo.discard();
+    }
+}
+
+void PipelinePlan::Node::bindPorts() {
+    for (const auto& input : inputs) {
+        if (input.second) {
+            algo->input(input.first).set(*input.second);
+        }
+    }
+    // Inputs left unbound may still point at buffers of an earlier user
+    if (algo->inputs().size() > inputs.size()) {
+        reusable = false;
+    }
+
+    for (const auto& entry : algo->outputs()) {
+        const std::type_info& type = entry.second->typeInfo();
+        if (type == typeid(std::vector<essentia::Real>)) {
+            entry.second->set(vectors[entry.first]);
+        } else if (type == typeid(essentia::Real)) {
+            entry.second->set(scalars[entry.first]);
+        } else if (type == typeid(std::string)) {
+            entry.second->set(strings[entry.first]);
+        } else {
+            reusable = false;
+        }
+    }
+}
+
+void PipelinePlan::Node::bindSignal(const std::vector<essentia::Real>& signal) {
+    for (const auto& input : inputs) {
+        if (!input.second) {
+            algo->input(input.first).set(signal);
+        }
+    }
+}
+
+const std::vector<essentia::Real>& PipelinePlan::Node::vectorOutput(const std::string& port) const {
+    auto it = vectors.find(port);
+    if (it == vectors.end()) {
+        throw std::runtime_error("output '" + port + "' of '" + name + "' is not a vector of reals");
+    }
+    return it->second;
+}
+
+std::unique_ptr<PipelinePlan> PipelinePlan::compile(const json& config, EssentiaWrapper& wrapper, std::string& error) {
+    if (!config.contains("preprocess") || !config["preprocess"].is_array()) {
+        error = createErrorResponse("Invalid configuration: 'preprocess' must be an array", "INVALID_CONFIG");
+        return nullptr;
+    }
+    if (!config.contains("features") || !config["features"].is_array()) {
+        error = createErrorResponse("Invalid configuration: 'features' must be an array", "INVALID_CONFIG");
+        return nullptr;
+    }
+    for (const char* section : {"preprocess", "features"}) {
+        for (const auto& node : config[section]) {
+            if (!node.is_object() || !node.contains("name") || !node["name"].is_string()) {
+                error = createErrorResponse(std::string("Invalid configuration: every '") + section +
+                                            "' entry needs a 'name'", "INVALID_CONFIG");
+                return nullptr;
+            }
+        }
+    }
+
+    std::unique_ptr<PipelinePlan> plan(new PipelinePlan());
+    plan->mWrapper = &wrapper;
+
+    size_t frameCutterIndex = config["preprocess"].size();
+    for (size_t i = 0; i < config["preprocess"].size(); ++i) {
+        if (config["preprocess"][i]["name"].get<std::string>() == "FrameCutter") {
+            frameCutterIndex = i;
+            break;
+        }
+    }
+    plan->mFrameBased = frameCutterIndex < config["preprocess"].size();
+
+    if (config.contains("postProcess") && config["postProcess"].contains("concatenate") &&
+        config["postProcess"]["concatenate"].is_boolean()) {
+        plan->mConcatenate = config["postProcess"]["concatenate"].get<bool>();
+    }
+
+    error = plan->mFrameBased ? plan->compileFrameBased(config, frameCutterIndex, wrapper)
+                              : plan->compileSignalBased(config, wrapper);
+    if (!error.empty()) {
+        return nullptr;
+    }
+
+    LOGI("Compiled %s pipeline: %zu nodes, %zu features",
+         plan->mFrameBased ? "frame-based" : "signal-based", plan->mNodes.size(), plan->mFeatures.size());
+    return plan;
+}
+
+PipelinePlan::Node& PipelinePlan::internNode(
+        const std::string& name, const std::map<std::string, essentia::Parameter>& params,
+        const std::vector<std::pair<std::string, const std::vector<essentia::Real>*>>& inputs,
+        bool isFeature, bool* created) {
+    std::string key = AlgorithmPool::canonicalKey(name, params);
+    for (const auto& input : inputs) {
+        key += '|' + input.first + '@' +
+               (input.second ? std::to_string(reinterpret_cast<uintptr_t>(input.second)) : std::string("signal"));
+    }
+
+    auto existing = mNodesByKey.find(key);
+    if (existing != mNodesByKey.end()) {
+        LOGI("Sharing '%s' between pipeline consumers", name.c_str());
+        if (created) *created = false;
+        return *existing->second;
+    }
+
+    Node& node = mNodes.emplace_back();
+    node.name = name;
+    node.key = key;
+    node.isFeature = isFeature;
+    node.inputs = inputs;
+    try {
+        node.algo = mWrapper->getAlgorithmPool().checkout(name, params);
+        node.bindPorts();
+    } catch (...) {
+        mNodes.pop_back();
+        throw;
+    }
+    mNodesByKey[key] = &node;
+    if (created) *created = true;
+    return node;
+}
+
+const std::vector<essentia::Real>& PipelinePlan::internHpcp(
+        const std::string& feature, const std::map<std::string, essentia::Parameter>& params,
+        const std::vector<essentia::Real>& spectrum) {
+    // Same defaults as extractFeatures. Every harmonic feature reads the peak and
+    // reference settings, so equal settings give equal keys and shared nodes.
+    const essentia::Real sampleRate = params.count("sampleRate") ? params.at("sampleRate").toReal()
+                                                                 : static_cast<essentia::Real>(mWrapper->getSampleRate());
+    if (!params.count("sampleRate")) {
+        mCompiledSampleRate = sampleRate;
+    }
+    std::map<std::string, essentia::Parameter> peaksParams = {
+        {"sampleRate", essentia::Parameter(sampleRate)},
+        {"maxPeaks", essentia::Parameter(params.count("maxPeaks") ? params.at("maxPeaks").toInt() : 100)},
+        {"magnitudeThreshold", essentia::Parameter(params.count("magnitudeThreshold") ?
+            params.at("magnitudeThreshold").toReal() : 0.0f)}};
+    std::map<std::string, essentia::Parameter> hpcpParams = {
+        {"sampleRate", essentia::Parameter(sampleRate)},
+        {"size", essentia::Parameter(12)},
+        {"referenceFrequency", essentia::Parameter(params.count("referenceFrequency") ?
+            params.at("referenceFrequency").toReal() : 440.0f)}};
+    // An HPCP feature's remaining parameters are its own (Key and Tonnetz need 12 bins)
+    if (feature == "HPCP") {
+        for (const auto& param : params) {
+            if (!peaksParams.count(param.first) || param.first == "sampleRate") {
+                hpcpParams.erase(param.first);
+                hpcpParams.insert(param);
+            }
+        }
+    }
+
+    Node& peaks = internNode("SpectralPeaks", peaksParams, {{"spectrum", &spectrum}}, true);
+    Node& hpcp = internNode("HPCP", hpcpParams, {{"frequencies", &peaks.vectorOutput("frequencies")},
+                                                 {"magnitudes", &peaks.vectorOutput("magnitudes")}}, true);
+    return hpcp.vectorOutput("hpcp");
+}
+
+std::string PipelinePlan::compileFrameBased(const json& config, size_t frameCutterIndex, EssentiaWrapper& wrapper) {
+    const json& cutterConfig = config["preprocess"][frameCutterIndex];
+    if (!cutterConfig.contains("params") ||
+        !cutterConfig["params"].contains("frameSize") || !cutterConfig["params"]["frameSize"].is_number() ||
+        !cutterConfig["params"].contains("hopSize") || !cutterConfig["params"]["hopSize"].is_number()) {
+        return createErrorResponse("FrameCutter requires frameSize and hopSize parameters", "INVALID_CONFIG");
+    }
+
+    const json& cutterParams = cutterConfig["params"];
+    mFrameSize = cutterParams["frameSize"].get<int>();
+    mHopSize = cutterParams["hopSize"].get<int>();
+    if (mFrameSize <= 0 || mHopSize <= 0) {
+        return createErrorResponse("FrameCutter frameSize and hopSize must be positive", "INVALID_CONFIG");
+    }
+    mStartFromZero = cutterParams.contains("startFromZero") && cutterParams["startFromZero"].is_boolean() &&
+                     cutterParams["startFromZero"].get<bool>();
+    mLastFrameToEndOfFile = cutterParams.contains("lastFrameToEndOfFile") &&
+                            cutterParams["lastFrameToEndOfFile"].is_boolean() &&
+                            cutterParams["lastFrameToEndOfFile"].get<bool>();
+
+    const auto& primaryOutputs = wrapper.getPrimaryOutputs();
+    AlgorithmPool& algorithms = wrapper.getAlgorithmPool();
+    std::string current = "FrameCutter";
+
+    try {
+        mFrameCutter.name = current;
+        mFrameCutter.inputs = {{"signal", nullptr}};
+        mFrameCutter.algo = algorithms.checkout(current, paramsOf(cutterConfig));
+        mFrameCutter.bindPorts();
+        mFrameCutter.algo->output("frame").set(mFrame);
+
+        // Buffers features can read from, by preprocess step name
+        std::map<std::string, const std::vector<essentia::Real>*> slots = {{"frame", &mFrame}};
+
+        // Steps after the FrameCutter form a chain, each reading the previous output
+        const std::vector<essentia::Real>* previous = &mFrame;
+        std::string previousName;
+        for (size_t i = frameCutterIndex + 1; i < config["preprocess"].size(); ++i) {
+            const json& step = config["preprocess"][i];
+            current = step["name"].get<std::string>();
+
+            const std::string inputPort = isSpectrumName(previousName) ? "spectrum" : "frame";
+            Node& node = internNode(current, paramsOf(step), {{inputPort, previous}}, false);
+
+            previous = &node.vectorOutput(outputPortFor(primaryOutputs, current, false));
+            slots[current] = previous;
+            previousName = current;
+        }
+        const bool noPreprocess = previousName.empty();
+
+        for (const auto& feature : config["features"]) {
+            current = feature["name"].get<std::string>();
+
+            if (!feature.contains("input") || !feature["input"].is_string()) {
+                return createErrorResponse(std::string("Feature '") + current + "' is missing required 'input' field",
+                                           "INVALID_CONFIG");
+            }
+            const std::string inputName = feature["input"].get<std::string>();
+            auto slot = slots.find(inputName);
+            if (slot == slots.end()) {
+                return createErrorResponse(std::string("Input '") + inputName + "' for feature '" + current +
+                                           "' is not produced by the pipeline", "INVALID_CONFIG");
+            }
+
+            std::string error = compileFrameFeature(feature, inputName, *slot->second, noPreprocess);
+            if (!error.empty()) {
+                return error;
+            }
+            if (!mFeatures.empty()) {
+                dropDuplicateFeature();
+            }
+        }
+    } catch (const std::exception& e) {
+        LOGE("Error creating algorithm '%s': %s", current.c_str(), e.what());
+        return createErrorResponse(std::string("Error creating algorithm '") + current + "': " + e.what(), "ALGORITHM_ERROR");
+    }
+
+    return "";
+}
+
+std::string PipelinePlan::compileFrameFeature(const json& feature, const std::string& inputName,
+                                              const std::vector<essentia::Real>& input, bool noPreprocess) {
+    const std::string name = feature["name"].get<std::string>();
+    const auto& primaryOutputs = mWrapper->getPrimaryOutputs();
+    AlgorithmPool& algorithms = mWrapper->getAlgorithmPool();
+
+    Feature& out = mFeatures.emplace_back();
+    out.name = name;
+    out.useMean = postProcessFlag(feature, "mean");
+    out.useVariance = postProcessFlag(feature, "variance");
+    out.useMin = postProcessFlag(feature, "min");
+    out.useMax = postProcessFlag(feature, "max");
+    if (feature.contains("postProcess") && feature["postProcess"].contains("percentiles")) {
+        const json& requested = feature["postProcess"]["percentiles"];
+        std::vector<essentia::Real> percentiles;
+        bool valid = requested.is_array();
+        for (const auto& value : valid ? requested : json::array()) {
+            valid = valid && value.is_number() && value.get<double>() >= 0 && value.get<double>() <= 100;
+            if (valid) percentiles.push_back(value.get<essentia::Real>());
+        }
+        if (!valid) {
+            return createErrorResponse(std::string("Feature '") + name +
+                                       "' has invalid percentiles (must be an array of numbers in [0, 100])",
+                                       "INVALID_CONFIG");
+        }
+        out.stats = FrameStats(percentiles);
+    }
+    const auto params = paramsOf(feature);
+
+    // Harmonic features on a spectrum go through the shared peaks -> HPCP nodes
+    const bool harmonic = name == "HPCP" || name == "Key" || name == "Tonnetz";
+    if (harmonic && isSpectrumName(inputName)) {
+        const std::vector<essentia::Real>& hpcp = internHpcp(name, params, input);
+        if (name == "Key") {
+            std::map<std::string, essentia::Parameter> keyParams = params;
+            for (const char* shared : {"sampleRate", "maxPeaks", "magnitudeThreshold", "referenceFrequency"}) {
+                keyParams.erase(shared);
+            }
+            out.kind = OutputKind::Key;
+            out.vectorSource = &hpcp;
+            out.hpcpMean.assign(12, 0.0);
+            Node& keyNode = mSummaryNodes.emplace_back();
+            keyNode.name = name;
+            keyNode.key = AlgorithmPool::canonicalKey(name, keyParams);
+            keyNode.inputs = {{"pcp", &out.hpcpMean}};
+            keyNode.algo = algorithms.checkout(name, keyParams);
+            keyNode.bindPorts();
+            out.keyNode = &keyNode;
+            return "";
+        }
+        out.kind = name == "Tonnetz" ? OutputKind::Tonnetz : OutputKind::Vector;
+        out.vectorSource = &hpcp;
+        out.collector = &mCollectors[name];
+        return "";
+    }
+
+    // Tonnetz is not an Essentia algorithm; the wrapper applies the transform
+    if (name == "Tonnetz") {
+        out.kind = OutputKind::Tonnetz;
+        out.vectorSource = &input;
+        out.collector = &mCollectors[name];
+        return "";
+    }
+
+    // The input port depends on the algorithm's inputs: ask an existing node with
+    // the same configuration, or a pooled instance (which the node then reuses)
+    const std::string configKey = AlgorithmPool::canonicalKey(name, params) + '|';
+    auto sameConfig = std::find_if(mNodes.begin(), mNodes.end(), [&](const Node& node) {
+        return node.key.compare(0, configKey.size(), configKey) == 0;
+    });
+    std::string inputPort;
+    if (sameConfig != mNodes.end()) {
+        inputPort = featureInputPort(sameConfig->algo.get(), inputName, noPreprocess);
+    } else {
+        AlgorithmPool::Lease probe = algorithms.checkout(name, params);
+        inputPort = featureInputPort(probe.get(), inputName, noPreprocess);
+    }
+    if (inputPort.empty()) {
+        return createErrorResponse(std::string("Algorithm '") + name + "' has no inputs", "ALGORITHM_ERROR");
+    }
+    bool created = false;
+    Node& node = internNode(name, params, {{inputPort, &input}}, true, &created);
+
+    if (name == "PitchYinFFT") {
+        out.kind = OutputKind::PitchYinFFT;
+        out.scalarSource = &node.scalars.at("pitch");
+        out.confidenceSource = &node.scalars.at("pitchConfidence");
+        out.collector = &mCollectors[name];
+        return "";
+    }
+
+    const std::string outputPort = outputPortFor(primaryOutputs, name, true);
+    node.algo->output(outputPort);  // throws for unknown ports
+    if (node.vectors.count(outputPort)) {
+        out.kind = OutputKind::Vector;
+        out.vectorSource = &node.vectors[outputPort];
+    } else if (node.scalars.count(outputPort)) {
+        out.kind = OutputKind::Scalar;
+        out.scalarSource = &node.scalars[outputPort];
+    } else {
+        LOGE("Unsupported output type for feature '%s': %s, skipping", name.c_str(),
+             node.algo->output(outputPort).typeInfo().name());
+        mFeatures.pop_back();
+        if (created) {
+            mNodesByKey.erase(node.key);
+            mNodes.pop_back();
+        }
+        return "";
+    }
+    // Only features that resolved to an output get a collector, so a skipped one
+    // leaves no empty result behind
+    out.collector = &mCollectors[name];
+    return "";
+}
+
+void PipelinePlan::dropDuplicateFeature() {
+    // A feature listed twice with the same settings reads the same node; keep one
+    const Feature& last = mFeatures.back();
+    for (size_t i = 0; i + 1 < mFeatures.size(); ++i) {
+        const Feature& other = mFeatures[i];
+        if (other.name == last.name && other.kind == last.kind && other.vectorSource == last.vectorSource &&
+            other.scalarSource == last.scalarSource && other.useMean == last.useMean &&
+            other.useVariance == last.useVariance && other.useMin == last.useMin && other.useMax == last.useMax &&
+            other.stats.percentiles() == last.stats.percentiles() &&
+            (other.keyNode ? other.keyNode->key : "") == (last.keyNode ? last.keyNode->key : "")) {
+            LOGI("Feature '%s' is listed twice, computing it once", last.name.c_str());
+            if (last.keyNode) mSummaryNodes.pop_back();
+            mFeatures.pop_back();
+            return;
+        }
+    }
+}
+
+std::string PipelinePlan::compileSignalBased(const json& config, EssentiaWrapper& wrapper) {
+    const auto& primaryOutputs = wrapper.getPrimaryOutputs();
+    std::string current;
+
+    try {
+        // nullptr stands for the signal passed to run()
+        std::map<std::string, const std::vector<essentia::Real>*> slots = {{"signal", nullptr}};
+        const std::vector<essentia::Real>* previous = nullptr;
+
+        for (const auto& step : config["preprocess"]) {
+            current = step["name"].get<std::string>();
+
+            Node& node = internNode(current, paramsOf(step), {{"signal", previous}}, false);
+            previous = &node.vectorOutput(outputPortFor(primaryOutputs, current, true));
+            slots[current] = previous;
+        }
+
+        for (const auto& feature : config["features"]) {
+            current = feature["name"].get<std::string>();
+
+            if (!feature.contains("input") || !feature["input"].is_string()) {
+                return createErrorResponse(std::string("Feature '") + current + "' is missing required 'input' field",
+                                           "INVALID_CONFIG");
+            }
+            const std::string inputName = feature["input"].get<std::string>();
+            auto slot = slots.find(inputName);
+            if (slot == slots.end()) {
+                return createErrorResponse(std::string("Input '") + inputName + "' for feature '" + current +
+                                           "' not found in pool", "INVALID_CONFIG");
+            }
+
+            const std::string inputPort = isSpectrumName(inputName) ? "spectrum" : "signal";
+            Node& node = internNode(current, paramsOf(feature), {{inputPort, slot->second}}, true);
+
+            Feature& out = mFeatures.emplace_back();
+            out.name = current;
+            out.vectorSource = &node.vectorOutput(outputPortFor(primaryOutputs, current, true));
+        }
+    } catch (const std::exception& e) {
+        LOGE("Error creating algorithm '%s': %s", current.c_str(), e.what());
+        return createErrorResponse(std::string("Error creating algorithm '") + current + "': " + e.what(), "ALGORITHM_ERROR");
+    }
+
+    return "";
+}
+
+std::string PipelinePlan::checkSampleRate() const {
+    const essentia::Real current = static_cast<essentia::Real>(mWrapper->getSampleRate());
+    if (mCompiledSampleRate == 0 || current == mCompiledSampleRate) {
+        return "";
+    }
+    return createErrorResponse("Pipeline was compiled for " + std::to_string(static_cast<int>(mCompiledSampleRate)) +
+                               " Hz audio but the current audio is " + std::to_string(static_cast<int>(current)) +
+                               " Hz; compile it again or set sampleRate on its harmonic features",
+                               "INVALID_PIPELINE");
+}
+
+std::string PipelinePlan::run(const std::vector<essentia::Real>& signal, essentia::Pool& pool) {
+    std::string rateError = checkSampleRate();
+    if (!rateError.empty()) {
+        return rateError;
+    }
+    try {
+        if (mFrameBased) {
+            runFrameBased(signal, pool);
+        } else {
+            std::string error = runSignalBased(signal, pool);
+            if (!error.empty()) {
+                return error;
+            }
+        }
+        applyGlobalPostProcess(pool);
+        return "";
+    }
+    catch (const std::exception& e) {
+        std::string errorMsg = std::string("Error executing pipeline: ") + e.what();
+        LOGE("%s", errorMsg.c_str());
+        return createErrorResponse(errorMsg, "PIPELINE_EXECUTION_ERROR");
+    }
+}
+
+void PipelinePlan::runFrameBased(const std::vector<essentia::Real>& signal, essentia::Pool& pool) {
+    resetState();
+    mFrameCutter.bindSignal(signal);
+    beginNodeTimes();
+
+    int frameCount = 0;
+    while (true) {
+        mFrame.clear();
+        mFrameCutter.algo->compute();
+        if (mFrame.empty()) break;
+        frameCount++;
+        processFrame();
+    }
+    reportNodeTimes(frameCount);
+
+    summarizeFrames(pool, true);
+    LOGI("Processed %d frames", frameCount);
+}
+
+void PipelinePlan::resetState() {
+    // Start from a clean state (FrameCutter keeps its read position, Flux its
+    // previous spectrum, ...)
+    mStream = StreamState();
+    mFrameCutter.algo->reset();
+    for (auto& node : mNodes) node.algo->reset();
+    for (auto& node : mSummaryNodes) node.algo->reset();
+    for (auto& feature : mFeatures) {
+        feature.stats.clear();
+    }
+    for (auto& collector : mCollectors) {
+        collector.second.clear();
+    }
+}
+
+void PipelinePlan::beginNodeTimes() {
+    mProfiling = mWrapper->getProfiler().enabled();
+    if (mProfiling) mNodeMs.assign(mNodes.size(), 0.0);
+}
+
+void PipelinePlan::reportNodeTimes(int64_t frames) {
+    if (!mProfiling) return;
+    size_t index = 0;
+    for (const auto& node : mNodes) {
+        mWrapper->getProfiler().addStage("pipeline." + node.name, mNodeMs[index++], 1, frames);
+    }
+    mProfiling = false;
+}
+
+void PipelinePlan::processFrame() {
+    // Each node once, however many features read it
+    if (mProfiling) {
+        size_t index = 0;
+        for (auto& node : mNodes) {
+            const auto start = std::chrono::steady_clock::now();
+            node.algo->compute();
+            mNodeMs[index++] += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+    } else {
+        for (auto& node : mNodes) {
+            node.algo->compute();
+        }
+    }
+
+    for (auto& feature : mFeatures) {
+        switch (feature.kind) {
+            case OutputKind::Tonnetz:
+                if (feature.vectorSource->size() != 12) {
+                    LOGE("Input for Tonnetz must be 12-dimensional, got %zu", feature.vectorSource->size());
+                    break;
+                }
+                mRow.resize(kTonnetzSize);
+                projectTonnetz(feature.vectorSource->data(), 1, mRow.data());
+                recordFrame(feature, mRow);
+                break;
+            case OutputKind::Key:
+                if (feature.vectorSource->size() >= 12) {
+                    mRow.assign(feature.vectorSource->begin(), feature.vectorSource->begin() + 12);
+                    feature.stats.add(mRow);
+                }
+                break;
+            case OutputKind::PitchYinFFT:
+                mRow.assign({*feature.scalarSource, *feature.confidenceSource});
+                recordFrame(feature, mRow);
+                break;
+            case OutputKind::Vector:
+                recordFrame(feature, *feature.vectorSource);
+                break;
+            case OutputKind::Scalar:
+                mRow.assign(1, *feature.scalarSource);
+                recordFrame(feature, mRow);
+                break;
+        }
+    }
+}
+
+void PipelinePlan::recordFrame(Feature& feature, const std::vector<essentia::Real>& row) {
+    if (feature.hasStats()) {
+        feature.stats.add(row);
+        // Statistics need no frames; a stream still hands each row out once
+        if (!mStream.active) return;
+    }
+    feature.collector->push_back(row);
+}
+
+void PipelinePlan::summarizeFrames(essentia::Pool& pool, bool includeRawFrames) {
+    for (auto& feature : mFeatures) {
+        if (feature.kind == OutputKind::Key) {
+            if (feature.stats.count() == 0) continue;
+            feature.hpcpMean = feature.stats.mean();
+            Node& key = *feature.keyNode;
+            key.algo->compute();
+            pool.set(feature.name + ".key", key.strings["key"]);
+            pool.set(feature.name + ".scale", key.strings["scale"]);
+            pool.set(feature.name + ".strength", key.scalars["strength"]);
+            pool.set(feature.name + ".firstToSecondRelativeStrength", key.scalars["firstToSecondRelativeStrength"]);
+            continue;
+        }
+
+        if (!feature.hasStats()) {
+            if (includeRawFrames) {
+                for (const auto& frame : *feature.collector) {
+                    pool.add(feature.name, frame);
+                }
+            }
+            continue;
+        }
+
+        const FrameStats& stats = feature.stats;
+        if (stats.count() == 0) continue;
+
+        // Single-value features are stored as scalars
+        auto store = [&](const std::string& suffix, const std::vector<essentia::Real>& values) {
+            if (values.size() == 1) {
+                pool.set(feature.name + suffix, values[0]);
+            } else {
+                pool.set(feature.name + suffix, values);
+            }
+        };
+        if (feature.useMean) store(".mean", stats.mean());
+        if (feature.useVariance) store(".variance", stats.variance());
+        if (feature.useMin) store(".min", stats.min());
+        if (feature.useMax) store(".max", stats.max());
+        for (size_t i = 0; i < stats.percentiles().size(); ++i) {
+            store(".p" + percentileLabel(stats.percentiles()[i]), stats.percentile(i));
+        }
+    }
+}
+
+std::string PipelinePlan::startStream() {
+    if (!mFrameBased) {
+        return createErrorResponse("Streaming needs a frame-based pipeline (with a FrameCutter step)", "INVALID_PIPELINE");
+    }
+    std::string rateError = checkSampleRate();
+    if (!rateError.empty()) {
+        return rateError;
+    }
+
+    resetState();
+    mStream.active = true;
+    mStream.nextFrameStart = mStartFromZero ? 0 : -(mFrameSize / 2);
+    return "";
+}
+
+std::string PipelinePlan::appendStream(const std::vector<essentia::Real>& chunk, json& data) {
+    if (!mStream.active) {
+        return createErrorResponse("No stream in progress for this pipeline", "STREAM_NOT_STARTED");
+    }
+
+    try {
+        mStream.pending.insert(mStream.pending.end(), chunk.begin(), chunk.end());
+        mStream.totalSamples += static_cast<int64_t>(chunk.size());
+        processStreamFrames(false, data);
+        return "";
+    }
+    catch (const std::exception& e) {
+        mStream.active = false;
+        std::string errorMsg = std::string("Error executing pipeline: ") + e.what();
+        LOGE("%s", errorMsg.c_str());
+        return createErrorResponse(errorMsg, "PIPELINE_EXECUTION_ERROR");
+    }
+}
+
+std::string PipelinePlan::finishStream(json& data) {
+    if (!mStream.active) {
+        return createErrorResponse("No stream in progress for this pipeline", "STREAM_NOT_STARTED");
+    }
+
+    try {
+        processStreamFrames(true, data);
+
+        essentia::Pool summary;
+        summarizeFrames(summary, false);
+        applyGlobalPostProcess(summary);
+        data["summary"] = json::parse(poolToJson(summary));
+        data["totalFrames"] = mStream.frameCount;
+
+        LOGI("Stream finished after %lld frames", static_cast<long long>(mStream.frameCount));
+        resetState();
+        return "";
+    }
+    catch (const std::exception& e) {
+        mStream.active = false;
+        std::string errorMsg = std::string("Error executing pipeline: ") + e.what();
+        LOGE("%s", errorMsg.c_str());
+        return createErrorResponse(errorMsg, "PIPELINE_EXECUTION_ERROR");
+    }
+}
+
+void PipelinePlan::processStreamFrames(bool flush, json& data) {
+    StreamState& stream = mStream;
+    const int64_t startFrame = stream.frameCount;
+    beginNodeTimes();
+
+    while (true) {
+        const int64_t start = stream.nextFrameStart;
+        const int64_t end = start + mFrameSize;
+        if (!flush) {
+            // Only complete frames; the rest waits for the next chunk
+            if (end > stream.totalSamples) break;
+        } else if (start >= stream.totalSamples ||
+                   (mStartFromZero && !mLastFrameToEndOfFile && end > stream.totalSamples)) {
+            // Same end-of-signal rule as FrameCutter
+            break;
+        }
+
+        // Samples outside [0, totalSamples) are zero, like FrameCutter's padding
+        mFrame.assign(mFrameSize, 0.0);
+        const int64_t from = std::max(start, stream.pendingStart);
+        const int64_t to = std::min(end, stream.totalSamples);
+        if (from < to) {
+            std::copy(stream.pending.begin() + (from - stream.pendingStart),
+                      stream.pending.begin() + (to - stream.pendingStart),
+                      mFrame.begin() + (from - start));
+        }
+
+        processFrame();
+        stream.frameCount++;
+        stream.nextFrameStart += mHopSize;
+    }
+    reportNodeTimes(stream.frameCount - startFrame);
+
+    // Drop samples no later frame can reach
+    const int64_t keepFrom = std::min(std::max<int64_t>(stream.nextFrameStart, 0), stream.totalSamples);
+    if (keepFrom > stream.pendingStart) {
+        stream.pending.erase(stream.pending.begin(), stream.pending.begin() + (keepFrom - stream.pendingStart));
+        stream.pendingStart = keepFrom;
+    }
+
+    // Hand out the rows of the new frames
+    json features = json::object();
+    for (auto& collector : mCollectors) {
+        features[collector.first] = collector.second;
+        collector.second.clear();
+    }
+
+    data["startFrame"] = startFrame;
+    data["frameCount"] = stream.frameCount - startFrame;
+    data["features"] = std::move(features);
+}
+
+std::string PipelinePlan::runSignalBased(const std::vector<essentia::Real>& signal, essentia::Pool& pool) {
+    for (auto& node : mNodes) {
+        try {
+            node.bindSignal(signal);
+            node.algo->reset();
+            node.algo->compute();
+        } catch (const std::exception& e) {
+            return createErrorResponse(std::string(node.isFeature ? "Error in feature extraction '"
+                                                                  : "Error in preprocessing step '") +
+                                       node.name + "': " + e.what(), "ALGORITHM_ERROR");
+        }
+    }
+
+    for (const auto& feature : mFeatures) {
+        pool.add(feature.name, *feature.vectorSource);
+    }
+
+    return "";
+}
+
+void PipelinePlan::applyGlobalPostProcess(essentia::Pool& pool) const {
+    if (!mConcatenate) return;
+
+    // Concatenate all feature vectors and scalars
+    std::vector<essentia::Real> concatenated;
+    for (const auto& descName : pool.descriptorNames()) {
+        if (pool.contains<std::vector<essentia::Real>>(descName)) {
+            const auto& values = pool.value<std::vector<essentia::Real>>(descName);
+            concatenated.insert(concatenated.end(), values.begin(), values.end());
+        } else if (pool.contains<essentia::Real>(descName)) {
+            concatenated.push_back(pool.value<essentia::Real>(descName));
+        } else {
+            LOGW("Ignoring descriptor '%s' of unsupported type for concatenation", descName.c_str());
+        }
+    }
+
+    pool.add("concatenatedFeatures", concatenated);
+    LOGI("Stored concatenatedFeatures (total size: %zu)", concatenated.size());
+}
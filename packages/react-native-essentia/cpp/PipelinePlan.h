@@ -0,0 +1,192 @@
+// packages/react-native-essentia/cpp/PipelinePlan.h
+#ifndef PIPELINE_PLAN_H
+#define PIPELINE_PLAN_H
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "essentia/essentia.h"
+#include "essentia/pool.h"
+#include "nlohmann/json.hpp"
+#include "AlgorithmPool.h"
+#include "FrameStats.h"
+
+class EssentiaWrapper;
+
+// Compiled form of an executePipeline configuration.
+//
+// compile() validates the config once, checks every algorithm out of the wrapper's
+// AlgorithmPool, resolves input/output port names and binds the ports to buffers
+// owned by the plan. run() then just computes the nodes in order (FrameCutter,
+// preprocess chain, features) for each frame, so a plan can be run many times, on
+// the current audio or on another buffer, without parsing or creating anything.
+//
+// Nodes are interned by algorithm, canonical parameters and input buffers: two
+// consumers asking for the same computation share one node, computed once per
+// frame. HPCP, Key and Tonnetz features on a spectrum are expanded into a common
+// SpectralPeaks -> HPCP front end, so requesting all three costs one peak pick
+// and one HPCP per frame.
+//
+// Features that ask for statistics (mean, variance, min, max, percentiles)
+// update them frame by frame and keep no frames, so memory does not grow with
+// the length of the audio.
+//
+// Frame-based plans can also be fed incrementally (startStream / appendStream /
+// finishStream): frames are cut from the appended audio with the FrameCutter's
+// framing, and the overlap between chunks and the state of stateful algorithms
+// (Flux, onset detection, ...) carry over, so each chunk costs only its new frames.
+//
+// A plan is not reentrant: callers serialize run() like every other wrapper call.
+class PipelinePlan {
+public:
+    // Returns nullptr and sets error (an error response JSON) if the config is invalid
+    static std::unique_ptr<PipelinePlan> compile(const nlohmann::json& config, EssentiaWrapper& wrapper,
+                                                 std::string& error);
+
+    // Adds the pipeline results for signal to pool. Returns an empty string on
+    // success, otherwise the error response JSON.
+    std::string run(const std::vector<essentia::Real>& signal, essentia::Pool& pool);
+
+    bool isFrameBased() const { return mFrameBased; }
+
+    // Streaming. Each call returns an empty string or the error response JSON and
+    // fills data with {startFrame, frameCount, features: {name: rows}} for the
+    // frames it completed. Rows are handed out once and not kept; statistics are
+    // updated as frames arrive. finishStream also processes the zero-padded tail
+    // frames and adds data.summary (statistics and concatenation, as in run()).
+    // run() or startStream() abandon a stream in progress.
+    std::string startStream();
+    std::string appendStream(const std::vector<essentia::Real>& chunk, nlohmann::json& data);
+    std::string finishStream(nlohmann::json& data);
+    bool isStreaming() const { return mStream.active; }
+
+    PipelinePlan(const PipelinePlan&) = delete;
+    PipelinePlan& operator=(const PipelinePlan&) = delete;
+
+private:
+    enum class OutputKind { Vector, Scalar, PitchYinFFT, Tonnetz, Key };
+
+    // One algorithm with its ports bound; shared by every consumer with the same key
+    struct Node {
+        std::string name;
+        std::string key;          // algorithm, canonical parameters and input buffers
+        AlgorithmPool::Lease algo;
+        bool isFeature = false;   // for error messages
+        // Bound inputs by port; a null buffer stands for the run() signal
+        std::vector<std::pair<std::string, const std::vector<essentia::Real>*>> inputs;
+
+        // Every output, by port (std::map keeps the bound addresses put)
+        std::map<std::string, std::vector<essentia::Real>> vectors;
+        std::map<std::string, essentia::Real> scalars;
+        std::map<std::string, std::string> strings;
+        bool reusable = true;
+
+        Node() = default;
+        ~Node();
+        void bindPorts();
+        void bindSignal(const std::vector<essentia::Real>& signal);
+        const std::vector<essentia::Real>& vectorOutput(const std::string& port) const;
+    };
+
+    // A requested feature: reads node outputs into its per-frame collector and/or
+    // its running statistics
+    struct Feature {
+        std::string name;
+        OutputKind kind = OutputKind::Vector;
+        const std::vector<essentia::Real>* vectorSource = nullptr;
+        const essentia::Real* scalarSource = nullptr;
+        const essentia::Real* confidenceSource = nullptr;  // PitchYinFFT second output
+
+        // Per-frame results, shared by features with the same name. Only filled for
+        // features without statistics (and while streaming, until handed out).
+        std::vector<std::vector<essentia::Real>>* collector = nullptr;
+        bool useMean = false;
+        bool useVariance = false;
+        bool useMin = false;
+        bool useMax = false;
+        FrameStats stats;  // percentiles are configured on it
+
+        // Key: like extractFeatures, estimated once from the mean HPCP of all frames
+        Node* keyNode = nullptr;
+        std::vector<essentia::Real> hpcpMean;
+
+        bool hasStats() const {
+            return useMean || useVariance || useMin || useMax || !stats.percentiles().empty();
+        }
+    };
+
+    PipelinePlan() = default;
+
+    std::string compileFrameBased(const nlohmann::json& config, size_t frameCutterIndex, EssentiaWrapper& wrapper);
+    std::string compileSignalBased(const nlohmann::json& config, EssentiaWrapper& wrapper);
+    std::string compileFrameFeature(const nlohmann::json& feature, const std::string& inputName,
+                                    const std::vector<essentia::Real>& input, bool noPreprocess);
+    void dropDuplicateFeature();
+    // Returns the node computing name(params) on inputs, creating it if no earlier
+    // consumer asked for the same thing (created tells which)
+    Node& internNode(const std::string& name, const std::map<std::string, essentia::Parameter>& params,
+                     const std::vector<std::pair<std::string, const std::vector<essentia::Real>*>>& inputs,
+                     bool isFeature, bool* created = nullptr);
+    // Shared SpectralPeaks -> HPCP nodes for a harmonic feature; returns the HPCP output
+    const std::vector<essentia::Real>& internHpcp(const std::string& feature,
+                                                  const std::map<std::string, essentia::Parameter>& params,
+                                                  const std::vector<essentia::Real>& spectrum);
+    void runFrameBased(const std::vector<essentia::Real>& signal, essentia::Pool& pool);
+    void resetState();
+    void processFrame();
+    // Per-node compute times, reported to the wrapper's Profiler as "pipeline.<node>"
+    void beginNodeTimes();
+    void reportNodeTimes(int64_t frames);
+    void recordFrame(Feature& feature, const std::vector<essentia::Real>& row);
+    void summarizeFrames(essentia::Pool& pool, bool includeRawFrames);
+    // Cuts and processes every frame that ends before totalSamples (or, when
+    // flushing, every remaining frame FrameCutter would still produce)
+    void processStreamFrames(bool flush, nlohmann::json& data);
+    std::string runSignalBased(const std::vector<essentia::Real>& signal, essentia::Pool& pool);
+    void applyGlobalPostProcess(essentia::Pool& pool) const;
+    // Error response if the wrapper's sample rate changed since harmonic nodes took it
+    std::string checkSampleRate() const;
+
+    EssentiaWrapper* mWrapper = nullptr;
+    bool mFrameBased = false;
+    bool mConcatenate = false;
+    // Wrapper sample rate that HPCP nodes without a sampleRate parameter were
+    // compiled with; 0 when no node depends on it
+    essentia::Real mCompiledSampleRate = 0;
+
+    Node mFrameCutter;
+    std::vector<essentia::Real> mFrame;
+    std::vector<essentia::Real> mRow;  // staging row for scalar outputs, Key and Tonnetz
+    // Deques so node addresses (and the buffers bound to ports) stay put. mNodes
+    // is in dependency order: preprocess chain, then the nodes features added.
+    std::deque<Node> mNodes;
+    std::map<std::string, Node*> mNodesByKey;
+    std::deque<Node> mSummaryNodes;  // computed once at the end, not per frame
+    bool mProfiling = false;
+    std::vector<double> mNodeMs;  // by mNodes index, while profiling
+    std::deque<Feature> mFeatures;
+    std::map<std::string, std::vector<std::vector<essentia::Real>>> mCollectors;
+
+    // FrameCutter framing, replayed by the stream scheduler
+    int mFrameSize = 0;
+    int mHopSize = 0;
+    bool mStartFromZero = false;
+    bool mLastFrameToEndOfFile = false;
+
+    struct StreamState {
+        bool active = false;
+        std::vector<essentia::Real> pending;  // samples from pendingStart on
+        int64_t pendingStart = 0;             // absolute index of pending[0]
+        int64_t nextFrameStart = 0;           // may be negative (centered first frame)
+        int64_t totalSamples = 0;
+        int64_t frameCount = 0;
+    };
+    StreamState mStream;
+};
+
+#endif
@@ -0,0 +1,286 @@
+// packages/react-native-essentia/cpp/PoolCodec.cpp
+#include "PoolCodec.h"
+#include "Utils.h"
+
+#include <cstring>
+#include <functional>
+#include <string>
+
+static_assert(sizeof(essentia::Real) == 4, "Binary pool encoding assumes 32-bit essentia::Real");
+
+namespace {
+
+const uint32_t kPoolBinaryVersion = 1;
+const size_t kHeaderBytes = 16;
+const size_t kDescriptorFixedBytes = 20;
+const size_t kPayloadAlignment = 16;
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+struct Descriptor {
+    std::string name;
+    PoolDType dtype = PoolDType::Float32;
+    uint8_t rank = 0;
+    uint32_t dim0 = 0;
+    uint32_t dim1 = 0;
+    size_t byteLength = 0;
+    size_t offset = 0;
+    std::function<void(uint8_t*)> writePayload;
+};
+
+void writeU32(uint8_t* dst, uint32_t value) {
+    std::memcpy(dst, &value, sizeof(value));
+}
+
+void writeU16(uint8_t* dst, uint16_t value) {
+    std::memcpy(dst, &value, sizeof(value));
+}
+
+uint32_t readU32(const uint8_t* src) {
+    uint32_t value;
+    std::memcpy(&value, src, sizeof(value));
+    return value;
+}
+
+uint16_t readU16(const uint8_t* src) {
+    uint16_t value;
+    std::memcpy(&value, src, sizeof(value));
+    return value;
+}
+
+std::vector<essentia::Real> readFloats(const uint8_t* src, size_t count) {
+    std::vector<essentia::Real> values(count);
+    if (count > 0) std::memcpy(values.data(), src, count * sizeof(float));
+    return values;
+}
+
+Descriptor stringsDescriptor(const std::string& name, const std::vector<std::string>* values, uint8_t rank) {
+    Descriptor d;
+    d.name = name;
+    d.dtype = PoolDType::String;
+    d.rank = rank;
+    d.dim0 = static_cast<uint32_t>(values->size());
+    for (const auto& value : *values) {
+        d.byteLength += sizeof(uint32_t) + value.size();
+    }
+    d.writePayload = [values](uint8_t* dst) {
+        for (const auto& value : *values) {
+            writeU32(dst, static_cast<uint32_t>(value.size()));
+            dst += sizeof(uint32_t);
+            if (!value.empty()) std::memcpy(dst, value.data(), value.size());
+            dst += value.size();
+        }
+    };
+    return d;
+}
+
+} // namespace
+
+std::vector<uint8_t> poolToBinary(const essentia::Pool& pool) {
+    std::vector<Descriptor> descriptors;
+    // Single strings are wrapped so they share the list encoding; kept alive until written
+    std::vector<std::vector<std::string>> singleStrings;
+    std::vector<std::string> names = pool.descriptorNames();
+    singleStrings.reserve(names.size());
+
+    for (const auto& key : names) {
+        try {
+            if (pool.contains<std::vector<std::vector<essentia::Real>>>(key)) {
+                const auto* rows = &pool.value<std::vector<std::vector<essentia::Real>>>(key);
+                Descriptor d;
+                d.name = key;
+                d.rank = 2;
+                d.dim0 = static_cast<uint32_t>(rows->size());
+                size_t total = 0;
+                bool uniform = true;
+                for (const auto& row : *rows) {
+                    total += row.size();
+                    uniform = uniform && row.size() == rows->front().size();
+                }
+                if (uniform) {
+                    d.dtype = PoolDType::Float32;
+                    d.dim1 = rows->empty() ? 0 : static_cast<uint32_t>(rows->front().size());
+                    d.byteLength = total * sizeof(float);
+                    d.writePayload = [rows](uint8_t* dst) {
+                        for (const auto& row : *rows) {
+                            if (row.empty()) continue;
+                            std::memcpy(dst, row.data(), row.size() * sizeof(float));
+                            dst += row.size() * sizeof(float);
+                        }
+                    };
+                } else {
+                    d.dtype = PoolDType::RaggedFloat32;
+                    d.byteLength = rows->size() * sizeof(uint32_t) + total * sizeof(float);
+                    d.writePayload = [rows](uint8_t* dst) {
+                        for (const auto& row : *rows) {
+                            writeU32(dst, static_cast<uint32_t>(row.size()));
+                            dst += sizeof(uint32_t);
+                        }
+                        for (const auto& row : *rows) {
+                            if (row.empty()) continue;
+                            std::memcpy(dst, row.data(), row.size() * sizeof(float));
+                            dst += row.size() * sizeof(float);
+                        }
+                    };
+                }
+                descriptors.push_back(std::move(d));
+            } else if (pool.contains<std::vector<essentia::Real>>(key)) {
+                const auto* values = &pool.value<std::vector<essentia::Real>>(key);
+                Descriptor d;
+                d.name = key;
+                d.rank = 1;
+                d.dim0 = static_cast<uint32_t>(values->size());
+                d.byteLength = values->size() * sizeof(float);
+                d.writePayload = [values](uint8_t* dst) {
+                    std::memcpy(dst, values->data(), values->size() * sizeof(float));
+                };
+                descriptors.push_back(std::move(d));
+            } else if (pool.contains<essentia::Real>(key)) {
+                const essentia::Real value = pool.value<essentia::Real>(key);
+                Descriptor d;
+                d.name = key;
+                d.byteLength = sizeof(float);
+                d.writePayload = [value](uint8_t* dst) {
+                    std::memcpy(dst, &value, sizeof(float));
+                };
+                descriptors.push_back(std::move(d));
+            } else if (pool.contains<std::string>(key)) {
+                singleStrings.push_back({pool.value<std::string>(key)});
+                descriptors.push_back(stringsDescriptor(key, &singleStrings.back(), 0));
+            } else if (pool.contains<std::vector<std::string>>(key)) {
+                descriptors.push_back(stringsDescriptor(key, &pool.value<std::vector<std::string>>(key), 1));
+            } else {
+                // Same placeholder as poolToJson
+                singleStrings.push_back({"unsupported_type"});
+                descriptors.push_back(stringsDescriptor(key, &singleStrings.back(), 0));
+                LOGI("Unsupported type for %s", key.c_str());
+            }
+        } catch (const std::exception& e) {
+            LOGE("Error serializing %s: %s", key.c_str(), e.what());
+            singleStrings.push_back({"error_reading_value"});
+            descriptors.push_back(stringsDescriptor(key, &singleStrings.back(), 0));
+        }
+    }
+
+    // Lay out the table, then the aligned payloads
+    size_t tableBytes = 0;
+    for (const auto& d : descriptors) {
+        tableBytes += alignUp(kDescriptorFixedBytes + d.name.size(), 4);
+    }
+    size_t cursor = alignUp(kHeaderBytes + tableBytes, kPayloadAlignment);
+    for (auto& d : descriptors) {
+        d.offset = cursor;
+        cursor = alignUp(cursor + d.byteLength, kPayloadAlignment);
+    }
+
+    std::vector<uint8_t> out(cursor, 0);
+    std::memcpy(out.data(), "EPB1", 4);
+    writeU32(out.data() + 4, kPoolBinaryVersion);
+    writeU32(out.data() + 8, static_cast<uint32_t>(descriptors.size()));
+    writeU32(out.data() + 12, static_cast<uint32_t>(tableBytes));
+
+    uint8_t* entry = out.data() + kHeaderBytes;
+    for (const auto& d : descriptors) {
+        writeU32(entry, static_cast<uint32_t>(d.offset));
+        writeU32(entry + 4, static_cast<uint32_t>(d.byteLength));
+        writeU32(entry + 8, d.dim0);
+        writeU32(entry + 12, d.dim1);
+        entry[16] = static_cast<uint8_t>(d.dtype);
+        entry[17] = d.rank;
+        writeU16(entry + 18, static_cast<uint16_t>(d.name.size()));
+        std::memcpy(entry + kDescriptorFixedBytes, d.name.data(), d.name.size());
+        entry += alignUp(kDescriptorFixedBytes + d.name.size(), 4);
+
+        if (d.byteLength > 0) {
+            d.writePayload(out.data() + d.offset);
+        }
+    }
+
+    return out;
+}
+
+bool binaryToPool(const uint8_t* data, size_t size, essentia::Pool& pool) {
+    if (size < kHeaderBytes || std::memcmp(data, "EPB1", 4) != 0 || readU32(data + 4) != kPoolBinaryVersion) {
+        return false;
+    }
+    const uint32_t count = readU32(data + 8);
+    const size_t tableEnd = kHeaderBytes + static_cast<size_t>(readU32(data + 12));
+    if (tableEnd > size) {
+        return false;
+    }
+
+    const uint8_t* entry = data + kHeaderBytes;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (static_cast<size_t>(entry - data) + kDescriptorFixedBytes > tableEnd) return false;
+        const size_t offset = readU32(entry);
+        const size_t byteLength = readU32(entry + 4);
+        const size_t dim0 = readU32(entry + 8);
+        const size_t dim1 = readU32(entry + 12);
+        const auto dtype = static_cast<PoolDType>(entry[16]);
+        const uint8_t rank = entry[17];
+        const size_t nameLength = readU16(entry + 18);
+        if (static_cast<size_t>(entry - data) + kDescriptorFixedBytes + nameLength > tableEnd) return false;
+        const std::string name(reinterpret_cast<const char*>(entry + kDescriptorFixedBytes), nameLength);
+        entry += alignUp(kDescriptorFixedBytes + nameLength, 4);
+
+        if (offset > size || byteLength > size - offset) return false;
+        const uint8_t* payload = data + offset;
+
+        switch (dtype) {
+            case PoolDType::Float32: {
+                const size_t values = rank == 2 ? dim0 * dim1 : rank == 1 ? dim0 : 1;
+                if (byteLength % sizeof(float) != 0 || values != byteLength / sizeof(float) ||
+                    (rank == 2 && dim1 > 0 && values / dim1 != dim0)) {
+                    return false;
+                }
+                if (rank == 2 && dim0 > 0) {
+                    for (size_t row = 0; row < dim0; ++row) {
+                        pool.add(name, readFloats(payload + row * dim1 * sizeof(float), dim1));
+                    }
+                } else if (rank >= 1) {
+                    pool.set(name, readFloats(payload, values));
+                } else {
+                    pool.set(name, readFloats(payload, 1)[0]);
+                }
+                break;
+            }
+            case PoolDType::RaggedFloat32: {
+                if (dim0 > byteLength / sizeof(uint32_t)) return false;
+                const uint8_t* rowData = payload + dim0 * sizeof(uint32_t);
+                const uint8_t* end = payload + byteLength;
+                for (size_t row = 0; row < dim0; ++row) {
+                    const size_t length = readU32(payload + row * sizeof(uint32_t));
+                    if (length > static_cast<size_t>(end - rowData) / sizeof(float)) return false;
+                    pool.add(name, readFloats(rowData, length));
+                    rowData += length * sizeof(float);
+                }
+                break;
+            }
+            case PoolDType::String: {
+                std::vector<std::string> values;
+                values.reserve(dim0);
+                const uint8_t* cursor = payload;
+                const uint8_t* end = payload + byteLength;
+                for (size_t j = 0; j < dim0; ++j) {
+                    if (end - cursor < static_cast<std::ptrdiff_t>(sizeof(uint32_t))) return false;
+                    const size_t length = readU32(cursor);
+                    cursor += sizeof(uint32_t);
+                    if (length > static_cast<size_t>(end - cursor)) return false;
+                    values.emplace_back(reinterpret_cast<const char*>(cursor), length);
+                    cursor += length;
+                }
+                if (rank == 0 && values.size() == 1) {
+                    pool.set(name, values[0]);
+                } else {
+                    pool.set(name, values);
+                }
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return true;
+}
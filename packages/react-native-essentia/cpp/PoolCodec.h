@@ -0,0 +1,47 @@
+// packages/react-native-essentia/cpp/PoolCodec.h
+#ifndef POOL_CODEC_H
+#define POOL_CODEC_H
+
+#include <cstdint>
+#include <vector>
+
+#include "essentia/pool.h"
+
+// Binary encoding of an essentia::Pool, an alternative to poolToJson for large
+// frame matrices. Everything is little-endian.
+//
+//   Header (16 bytes)
+//     char     magic[4]      "EPB1"
+//     uint32   version       1
+//     uint32   count         number of descriptors
+//     uint32   tableBytes    size of the descriptor table that follows
+//   Descriptor table, one entry per descriptor (each padded to 4 bytes)
+//     uint32   offset        absolute payload offset, 16-byte aligned
+//     uint32   byteLength    payload size
+//     uint32   dim0, dim1    shape (unused dims are 0)
+//     uint8    dtype         PoolDType
+//     uint8    rank          0 scalar, 1 vector, 2 matrix
+//     uint16   nameLength    followed by the UTF-8 name
+//   Payloads
+//     Float32        dim0 (x dim1) values, row-major
+//     RaggedFloat32  uint32 rowLengths[dim0], then the rows back to back
+//     String         dim0 entries of (uint32 length, UTF-8 bytes)
+//
+// The 16-byte payload alignment lets JS build Float32Array views straight over
+// the decoded buffer.
+
+enum class PoolDType : uint8_t {
+    Float32 = 0,
+    String = 1,
+    RaggedFloat32 = 2,
+};
+
+std::vector<uint8_t> poolToBinary(const essentia::Pool& pool);
+
+// Decodes poolToBinary output into pool: matrices (uniform or ragged) are added row
+// by row, vectors and scalars are set, so poolToJson of the result matches poolToJson
+// of the encoded pool. Returns false, leaving pool partly filled, if data is not a
+// well-formed encoding.
+bool binaryToPool(const uint8_t* data, size_t size, essentia::Pool& pool);
+
+#endif
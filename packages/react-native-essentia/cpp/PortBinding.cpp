@@ -0,0 +1,114 @@
+// packages/react-native-essentia/cpp/PortBinding.cpp
+#include "PortBinding.h"
+#include "Utils.h"
+
+#include <type_traits>
+
+namespace {
+
+template <typename T>
+bool holds(const std::type_info& type, PortBinding::Buffer& buffer) {
+    if (type != typeid(T)) return false;
+    buffer.emplace<T>();
+    return true;
+}
+
+// Sets buffer to an empty value of the port's type
+bool bufferFor(const std::type_info& type, PortBinding::Buffer& buffer) {
+    return holds<essentia::Real>(type, buffer) ||
+           holds<int>(type, buffer) ||
+           holds<std::string>(type, buffer) ||
+           holds<std::vector<essentia::Real>>(type, buffer) ||
+           holds<std::vector<int>>(type, buffer) ||
+           holds<std::vector<std::string>>(type, buffer) ||
+           holds<PortBinding::Matrix>(type, buffer) ||
+           holds<TNT::Array2D<essentia::Real>>(type, buffer);
+}
+
+// Empties a reused output buffer (keeping its capacity), as a fresh one would be
+void clear(PortBinding::Buffer& buffer) {
+    std::visit([](auto& value) {
+        using T = std::decay_t<decltype(value)>;
+        if constexpr (std::is_arithmetic_v<T> || std::is_same_v<T, TNT::Array2D<essentia::Real>>) {
+            value = T();
+        } else {
+            value.clear();
+        }
+    }, buffer);
+}
+
+bool isSignalName(const std::string& name) {
+    return name == "frame" || name == "signal" || name == "audio";
+}
+
+} // namespace
+
+PortBinding PortBinding::resolve(const essentia::standard::Algorithm& algo) {
+    PortBinding binding;
+    for (const auto& input : algo.inputs()) {
+        Port port;
+        port.name = input.first;
+        const std::type_info& type = input.second->typeInfo();
+        if (type == typeid(std::vector<essentia::Real>) && isSignalName(port.name)) {
+            port.isSignal = true;
+        } else if (!bufferFor(type, port.buffer)) {
+            LOGW("Input %s of %s has an unsupported type, leaving it unbound", port.name.c_str(), algo.name().c_str());
+            binding.mComplete = false;
+            continue;
+        }
+        binding.mInputs.push_back(std::move(port));
+    }
+    for (const auto& output : algo.outputs()) {
+        Port port;
+        port.name = output.first;
+        if (!bufferFor(output.second->typeInfo(), port.buffer)) {
+            LOGW("Output %s of %s has an unsupported type, leaving it unbound", port.name.c_str(), algo.name().c_str());
+            binding.mComplete = false;
+            continue;
+        }
+        binding.mOutputs.push_back(std::move(port));
+    }
+    return binding;
+}
+
+void PortBinding::bind(essentia::standard::Algorithm& algo, const std::vector<essentia::Real>& signal,
+                       essentia::Real sampleRate) {
+    for (Port& port : mInputs) {
+        if (port.isSignal) {
+            algo.input(port.name).set(signal);
+            continue;
+        }
+        if (port.name == "sampleRate") {
+            if (auto* rate = std::get_if<essentia::Real>(&port.buffer)) *rate = sampleRate;
+        }
+        std::visit([&](auto& value) { algo.input(port.name).set(value); }, port.buffer);
+    }
+    for (Port& port : mOutputs) {
+        clear(port.buffer);
+        std::visit([&](auto& value) { algo.output(port.name).set(value); }, port.buffer);
+    }
+}
+
+void PortBinding::collect(const std::string& prefix, essentia::Pool& pool) const {
+    for (const Port& port : mOutputs) {
+        const std::string key = prefix + "." + port.name;
+        std::visit([&](const auto& value) {
+            using T = std::decay_t<decltype(value)>;
+            if constexpr (std::is_same_v<T, int>) {
+                pool.set(key, static_cast<essentia::Real>(value));
+            } else if constexpr (std::is_same_v<T, std::vector<int>>) {
+                pool.set(key, std::vector<essentia::Real>(value.begin(), value.end()));
+            } else if constexpr (std::is_same_v<T, Matrix>) {
+                for (const auto& row : value) pool.add(key, row);
+            } else if constexpr (std::is_same_v<T, TNT::Array2D<essentia::Real>>) {
+                std::vector<essentia::Real> row(value.dim2());
+                for (int i = 0; i < value.dim1(); ++i) {
+                    row.assign(value[i], value[i] + value.dim2());
+                    pool.add(key, row);
+                }
+            } else {
+                pool.set(key, value);
+            }
+        }, port.buffer);
+    }
+}
@@ -0,0 +1,56 @@
+// packages/react-native-essentia/cpp/PortBinding.h
+#ifndef PORT_BINDING_H
+#define PORT_BINDING_H
+
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "essentia/algorithm.h"
+#include "essentia/pool.h"
+
+// Port buffers for running an arbitrary algorithm (executeDynamicAlgorithm).
+//
+// resolve() matches each port's type_info against the supported types once and
+// gives the port a buffer of exactly that type. The wrapper keeps one binding per
+// algorithm, so repeated calls bind the same buffers (which keep their capacity)
+// instead of allocating a holder per port per call, and nothing has to be freed
+// when compute() throws.
+//
+// Inputs named frame/signal/audio that take a vector of reals are bound to the
+// signal passed to bind(); other inputs get an empty value of their type (and
+// sampleRate the audio's rate).
+class PortBinding {
+public:
+    using Matrix = std::vector<std::vector<essentia::Real>>;
+    using Buffer = std::variant<essentia::Real, int, std::string,
+                                std::vector<essentia::Real>, std::vector<int>, std::vector<std::string>,
+                                Matrix, TNT::Array2D<essentia::Real>>;
+
+    static PortBinding resolve(const essentia::standard::Algorithm& algo);
+
+    // False if some port has a type without a buffer; it then keeps whatever it was
+    // last bound to, so the instance must not be handed out again
+    bool complete() const { return mComplete; }
+
+    // Points the algorithm's ports at the buffers and empties the outputs; cheap,
+    // done before every compute()
+    void bind(essentia::standard::Algorithm& algo, const std::vector<essentia::Real>& signal,
+              essentia::Real sampleRate);
+
+    // Copies the outputs to pool as <prefix>.<port>: scalars, vectors and strings are
+    // set, matrices added row by row
+    void collect(const std::string& prefix, essentia::Pool& pool) const;
+
+private:
+    struct Port {
+        std::string name;
+        bool isSignal = false;
+        Buffer buffer;
+    };
+    std::vector<Port> mInputs;
+    std::vector<Port> mOutputs;
+    bool mComplete = true;
+};
+
+#endif
@@ -0,0 +1,91 @@
+// packages/react-native-essentia/cpp/Profiler.cpp
+#include "Profiler.h"
+
+namespace {
+double elapsedMs(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+}
+
+Profiler::Scope::Scope(Profiler& profiler, const std::string& stage) {
+    if (!profiler.enabled()) return;
+    mProfiler = &profiler;
+    mProfiler->begin(*this);
+    mStage = mProfiler->stageIndex(stage);
+    mProfiler->mStages[mStage].calls++;
+    mStart = std::chrono::steady_clock::now();
+}
+
+Profiler::Scope::~Scope() {
+    if (!mProfiler) return;
+    mProfiler->end(*this, elapsedMs(mStart, std::chrono::steady_clock::now()));
+}
+
+void Profiler::Scope::addFrames(int64_t frames) {
+    if (mProfiler) mProfiler->mStages[mStage].frames += frames;
+}
+
+void Profiler::Scope::addBytes(int64_t bytes) {
+    if (mProfiler) mProfiler->mStages[mStage].bytes += bytes;
+}
+
+void Profiler::addStage(const std::string& stage, double ms, int64_t calls, int64_t frames, int64_t bytes) {
+    if (!mCurrent) return;
+    mCurrent->mNestedMs += ms;
+    Stage& entry = mStages[stageIndex(stage)];
+    entry.calls += calls;
+    entry.ms += ms;
+    entry.frames += frames;
+    entry.bytes += bytes;
+}
+
+nlohmann::json Profiler::toJson() const {
+    const auto now = std::chrono::steady_clock::now();
+    const auto callEnd = mCurrent ? now : mCallEnd;
+
+    // Scopes still open (typically the call building its response) count up to now
+    std::vector<Stage> current = mStages;
+    double openNestedMs = 0;
+    for (const Scope* scope = mCurrent; scope; scope = scope->mParent) {
+        const double elapsed = elapsedMs(scope->mStart, now);
+        current[scope->mStage].ms += elapsed - scope->mNestedMs - openNestedMs;
+        openNestedMs = elapsed;
+    }
+
+    nlohmann::json stages = nlohmann::json::array();
+    for (const auto& stage : current) {
+        stages.push_back({{"name", stage.name},
+                          {"calls", stage.calls},
+                          {"ms", stage.ms},
+                          {"frames", stage.frames},
+                          {"bytes", stage.bytes}});
+    }
+    return {{"totalMs", elapsedMs(mCallStart, callEnd)}, {"stages", stages}};
+}
+
+size_t Profiler::stageIndex(const std::string& stage) {
+    auto it = mStageIndex.find(stage);
+    if (it != mStageIndex.end()) return it->second;
+    mStages.push_back(Stage{stage});
+    mStageIndex.emplace(stage, mStages.size() - 1);
+    return mStages.size() - 1;
+}
+
+void Profiler::begin(Scope& scope) {
+    scope.mParent = mCurrent;
+    mCurrent = &scope;
+    if (scope.mParent) return;
+    mStages.clear();
+    mStageIndex.clear();
+    mCallStart = std::chrono::steady_clock::now();
+}
+
+void Profiler::end(Scope& scope, double elapsedMs) {
+    mStages[scope.mStage].ms += elapsedMs - scope.mNestedMs;
+    mCurrent = scope.mParent;
+    if (mCurrent) {
+        mCurrent->mNestedMs += elapsedMs;
+    } else {
+        mCallEnd = std::chrono::steady_clock::now();
+    }
+}
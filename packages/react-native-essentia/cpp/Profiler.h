@@ -0,0 +1,83 @@
+// packages/react-native-essentia/cpp/Profiler.h
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+// Per-stage timings of one wrapper call, returned in the "profile" section of its
+// response while profiling is enabled (EssentiaWrapper::setProfilingEnabled).
+//
+// Stages are named by the code that opens a Scope (an algorithm, "spectrum",
+// "pipeline.run", ...); a stage entered several times adds up its calls, time,
+// frames and bytes. Times are self times: a Scope opened inside another is taken
+// out of the outer one, so the stages add up to the call's total. The outermost
+// Scope of a call starts a fresh profile, so nothing carries over from the previous
+// call. While disabled a Scope costs one branch.
+//
+// Scopes are opened by the thread serving the call, never by frame workers; the
+// workers' time shows up in the stage that started them.
+class Profiler {
+public:
+    class Scope {
+    public:
+        Scope(Profiler& profiler, const std::string& stage);
+        ~Scope();
+
+        void addFrames(int64_t frames);
+        void addBytes(int64_t bytes);
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        friend class Profiler;
+        Profiler* mProfiler = nullptr;  // null while profiling is disabled
+        Scope* mParent = nullptr;
+        size_t mStage = 0;
+        std::chrono::steady_clock::time_point mStart;
+        double mNestedMs = 0;  // time of the stages nested in this one
+    };
+
+    // May be called from another thread than the one profiling; takes effect at the
+    // next call
+    void setEnabled(bool enabled) { mEnabled = enabled; }
+    bool enabled() const { return mEnabled; }
+
+    // For time measured by the caller, e.g. per pipeline node summed over frames;
+    // counted as nested in the innermost open Scope
+    void addStage(const std::string& stage, double ms, int64_t calls, int64_t frames, int64_t bytes = 0);
+
+    bool empty() const { return mStages.empty(); }
+    // {"totalMs": ..., "stages": [{"name", "calls", "ms", "frames", "bytes"}, ...]}, stages
+    // in the order they were first entered
+    nlohmann::json toJson() const;
+
+private:
+    struct Stage {
+        std::string name;
+        int64_t calls = 0;
+        double ms = 0;
+        int64_t frames = 0;
+        int64_t bytes = 0;
+    };
+
+    size_t stageIndex(const std::string& stage);
+    void begin(Scope& scope);
+    void end(Scope& scope, double elapsedMs);
+
+    std::atomic<bool> mEnabled{false};
+    Scope* mCurrent = nullptr;
+    std::chrono::steady_clock::time_point mCallStart;
+    std::chrono::steady_clock::time_point mCallEnd;
+    std::vector<Stage> mStages;
+    std::map<std::string, size_t> mStageIndex;
+};
+
+#endif
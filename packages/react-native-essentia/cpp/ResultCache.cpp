@@ -0,0 +1,275 @@
+// packages/react-native-essentia/cpp/ResultCache.cpp
+#include "ResultCache.h"
+#include "Utils.h"
+#include "nlohmann/json.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+const char kFileMagic[4] = {'E', 'P', 'C', '1'};
+const char* const kFileExtension = ".epc";
+
+std::string toHex(uint64_t value) {
+    char buffer[17];
+    std::snprintf(buffer, sizeof(buffer), "%016" PRIx64, value);
+    return buffer;
+}
+}
+
+ResultCache& ResultCache::shared() {
+    static ResultCache cache;
+    return cache;
+}
+
+void ResultCache::configure(size_t maxBytes, const std::string& directory) {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mMaxBytes = maxBytes;
+        mDirectory = maxBytes > 0 ? directory : std::string();
+        trimLocked();
+    }
+    if (maxBytes > 0 && !directory.empty()) {
+        std::error_code ec;
+        fs::create_directories(directory, ec);
+        if (ec) {
+            LOGW("Result cache directory %s unavailable: %s", directory.c_str(), ec.message().c_str());
+        }
+        trimDirectory();
+    }
+    LOGI("Result cache: %zu bytes%s%s", maxBytes, directory.empty() ? "" : ", persisted to ", directory.c_str());
+}
+
+bool ResultCache::enabled() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mMaxBytes > 0;
+}
+
+void ResultCache::clear() {
+    std::string directory;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mEntries.clear();
+        mIndex.clear();
+        mBytes = 0;
+        directory = mDirectory;
+    }
+    if (directory.empty()) return;
+
+    std::error_code ec;
+    for (fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->path().extension() == kFileExtension) {
+            std::error_code removeError;
+            fs::remove(it->path(), removeError);
+        }
+    }
+}
+
+std::string ResultCache::makeKey(uint64_t audioHash, double sampleRate, const std::string& kind,
+                                 const std::string& configJson) {
+    nlohmann::json config = nlohmann::json::parse(configJson, nullptr, false);
+    if (config.is_discarded()) {
+        return std::string();
+    }
+    // nlohmann::json objects keep their keys sorted, so dump() is canonical
+    return toHex(audioHash) + ":" + std::to_string(sampleRate) + ":" + kind + ":" + config.dump();
+}
+
+bool ResultCache::get(const std::string& key, std::vector<uint8_t>& encodedPool) {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mMaxBytes == 0) return false;
+        auto found = mIndex.find(key);
+        if (found != mIndex.end()) {
+            mEntries.splice(mEntries.begin(), mEntries, found->second);
+            encodedPool = found->second->encodedPool;
+            return true;
+        }
+        if (mDirectory.empty()) return false;
+    }
+
+    // Read outside the lock; other sessions keep using the memory entries meanwhile
+    if (!readFile(key, encodedPool)) return false;
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mMaxBytes > 0 && mIndex.find(key) == mIndex.end()) {
+        insertLocked(key, encodedPool);
+    }
+    return true;
+}
+
+void ResultCache::put(const std::string& key, std::vector<uint8_t> encodedPool) {
+    bool persist;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mMaxBytes == 0 || key.size() + encodedPool.size() > mMaxBytes) return;
+        persist = !mDirectory.empty();
+    }
+    if (persist) {
+        writeFile(key, encodedPool);
+        trimDirectory();
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mMaxBytes > 0 && mIndex.find(key) == mIndex.end()) {
+        insertLocked(key, std::move(encodedPool));
+    }
+}
+
+void ResultCache::insertLocked(const std::string& key, std::vector<uint8_t> encodedPool) {
+    mEntries.push_front(Entry{key, std::move(encodedPool)});
+    mIndex[key] = mEntries.begin();
+    mBytes += mEntries.front().bytes();
+    trimLocked();
+}
+
+void ResultCache::trimLocked() {
+    while (mBytes > mMaxBytes && !mEntries.empty()) {
+        mBytes -= mEntries.back().bytes();
+        mIndex.erase(mEntries.back().key);
+        mEntries.pop_back();
+    }
+}
+
+std::string ResultCache::filePath(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mDirectory.empty()) return std::string();
+    return (fs::path(mDirectory) / (toHex(hash(key.data(), key.size())) + kFileExtension)).string();
+}
+
+// File layout: magic "EPC1", uint32 key length, the key (to tell hash collisions
+// apart), then the encoded pool
+bool ResultCache::readFile(const std::string& key, std::vector<uint8_t>& encodedPool) const {
+    const std::string path = filePath(key);
+    if (path.empty()) return false;
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+
+    const std::streamoff size = file.tellg();
+    const std::streamoff headerBytes = sizeof(kFileMagic) + sizeof(uint32_t) + static_cast<std::streamoff>(key.size());
+    if (size < headerBytes) return false;
+    file.seekg(0);
+
+    char magic[sizeof(kFileMagic)];
+    uint32_t keyLength = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&keyLength), sizeof(keyLength));
+    if (!file || std::memcmp(magic, kFileMagic, sizeof(magic)) != 0 || keyLength != key.size()) return false;
+    std::string storedKey(keyLength, '\0');
+    file.read(&storedKey[0], keyLength);
+    if (!file || storedKey != key) return false;
+
+    encodedPool.resize(static_cast<size_t>(size - headerBytes));
+    file.read(reinterpret_cast<char*>(encodedPool.data()), static_cast<std::streamsize>(encodedPool.size()));
+    if (!file) return false;
+
+    // Keep recently used files out of the next trim
+    std::error_code ec;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    return true;
+}
+
+void ResultCache::writeFile(const std::string& key, const std::vector<uint8_t>& encodedPool) const {
+    const std::string path = filePath(key);
+    if (path.empty()) return;
+    // Written aside and renamed, so readers never see a partial file
+    const std::string tempPath =
+        path + ".tmp" + toHex(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        const uint32_t keyLength = static_cast<uint32_t>(key.size());
+        file.write(kFileMagic, sizeof(kFileMagic));
+        file.write(reinterpret_cast<const char*>(&keyLength), sizeof(keyLength));
+        file.write(key.data(), static_cast<std::streamsize>(key.size()));
+        file.write(reinterpret_cast<const char*>(encodedPool.data()), static_cast<std::streamsize>(encodedPool.size()));
+        if (!file) {
+            LOGW("Could not write result cache file %s", tempPath.c_str());
+            std::error_code ec;
+            fs::remove(tempPath, ec);
+            return;
+        }
+    }
+    std::error_code ec;
+    fs::rename(tempPath, path, ec);
+    if (ec) {
+        LOGW("Could not write result cache file %s: %s", path.c_str(), ec.message().c_str());
+        fs::remove(tempPath, ec);
+    }
+}
+
+void ResultCache::trimDirectory() const {
+    std::string directory;
+    size_t maxBytes;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        directory = mDirectory;
+        maxBytes = mMaxBytes;
+    }
+    if (directory.empty()) return;
+
+    struct CachedFile {
+        fs::path path;
+        fs::file_time_type time;
+        uintmax_t size;
+    };
+    std::vector<CachedFile> files;
+    uintmax_t total = 0;
+    std::error_code ec;
+    for (fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->path().extension() != kFileExtension) continue;
+        std::error_code statError;
+        CachedFile file{it->path(), it->last_write_time(statError), it->file_size(statError)};
+        if (statError) continue;
+        total += file.size;
+        files.push_back(std::move(file));
+    }
+    if (total <= maxBytes) return;
+
+    std::sort(files.begin(), files.end(), [](const CachedFile& a, const CachedFile& b) { return a.time < b.time; });
+    for (const auto& file : files) {
+        if (total <= maxBytes) break;
+        std::error_code removeError;
+        if (fs::remove(file.path, removeError)) total -= file.size;
+    }
+}
+
+uint64_t ResultCache::hash(const void* data, size_t size, uint64_t seed) {
+    const uint64_t m = 0xc6a4a7935bd1e995ULL;
+    const int r = 47;
+    uint64_t h = seed ^ (size * m);
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    const uint8_t* end = bytes + size / 8 * 8;
+    for (; bytes != end; bytes += 8) {
+        uint64_t k;
+        std::memcpy(&k, bytes, sizeof(k));
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+
+    switch (size & 7) {
+        case 7: h ^= uint64_t(bytes[6]) << 48; [[fallthrough]];
+        case 6: h ^= uint64_t(bytes[5]) << 40; [[fallthrough]];
+        case 5: h ^= uint64_t(bytes[4]) << 32; [[fallthrough]];
+        case 4: h ^= uint64_t(bytes[3]) << 24; [[fallthrough]];
+        case 3: h ^= uint64_t(bytes[2]) << 16; [[fallthrough]];
+        case 2: h ^= uint64_t(bytes[1]) << 8; [[fallthrough]];
+        case 1: h ^= uint64_t(bytes[0]);
+                h *= m;
+    }
+
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
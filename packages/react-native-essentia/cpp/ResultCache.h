@@ -0,0 +1,67 @@
+// packages/react-native-essentia/cpp/ResultCache.h
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Memo cache of extractFeatures / executePipeline results, shared by all sessions.
+// Entries are keyed by content: a hash of the audio samples and sample rate plus
+// the call's config JSON in canonical form (see makeKey), so re-running a config on
+// the same audio is a hit whichever session runs it. Values are result pools in
+// the binary encoding of PoolCodec.h.
+//
+// Disabled (maxBytes 0) by default. Entries are kept in memory up to maxBytes,
+// least recently used evicted first. With a directory, every entry is also written
+// there and memory misses are looked up on disk, so results survive restarts; the
+// directory is trimmed to maxBytes as well, oldest files first.
+class ResultCache {
+public:
+    static ResultCache& shared();
+
+    // maxBytes 0 disables the cache and drops the memory entries; an empty directory
+    // keeps entries in memory only
+    void configure(size_t maxBytes, const std::string& directory);
+    bool enabled() const;
+    // Drops every entry, on disk too
+    void clear();
+
+    // kind names the call ("extractFeatures", "executePipeline"); configJson is
+    // re-serialized with sorted keys and no whitespace. Empty when configJson does
+    // not parse.
+    static std::string makeKey(uint64_t audioHash, double sampleRate, const std::string& kind,
+                               const std::string& configJson);
+    bool get(const std::string& key, std::vector<uint8_t>& encodedPool);
+    void put(const std::string& key, std::vector<uint8_t> encodedPool);
+
+    // 64-bit MurmurHash2 (MurmurHash64A); about a memory pass over the audio
+    static uint64_t hash(const void* data, size_t size, uint64_t seed = 0);
+
+private:
+    struct Entry {
+        std::string key;
+        std::vector<uint8_t> encodedPool;
+        size_t bytes() const { return key.size() + encodedPool.size(); }
+    };
+
+    void insertLocked(const std::string& key, std::vector<uint8_t> encodedPool);
+    void trimLocked();
+    std::string filePath(const std::string& key) const;
+    bool readFile(const std::string& key, std::vector<uint8_t>& encodedPool) const;
+    void writeFile(const std::string& key, const std::vector<uint8_t>& encodedPool) const;
+    void trimDirectory() const;
+
+    mutable std::mutex mMutex;
+    size_t mMaxBytes = 0;
+    size_t mBytes = 0;
+    std::string mDirectory;
+    std::list<Entry> mEntries;  // most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> mIndex;
+};
+
+#endif
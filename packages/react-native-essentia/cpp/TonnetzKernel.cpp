@@ -0,0 +1,73 @@
+// packages/react-native-essentia/cpp/TonnetzKernel.cpp
+#include "TonnetzKernel.h"
+
+#include <algorithm>
+#include <type_traits>
+
+// NEON division is AArch64-only; 32-bit ARM takes the scalar loop
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define TONNETZ_NEON 1
+#elif defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define TONNETZ_SSE 1
+#endif
+
+static_assert(std::is_same<essentia::Real, float>::value, "the SIMD paths assume single-precision Real");
+
+void projectTonnetz(const essentia::Real* hpcp, size_t numFrames, essentia::Real* tonnetz, bool normalize) {
+    for (size_t frame = 0; frame < numFrames; ++frame, hpcp += kTonnetzHpcpSize, tonnetz += kTonnetzSize) {
+#if defined(TONNETZ_NEON)
+        float32x4_t low = vld1q_f32(hpcp);
+        float32x4_t mid = vld1q_f32(hpcp + 4);
+        float32x4_t high = vld1q_f32(hpcp + 8);
+        if (normalize) {
+            const float peak = vmaxvq_f32(vmaxq_f32(vmaxq_f32(low, mid), high));
+            if (peak != 0.0f) {
+                const float32x4_t divisor = vdupq_n_f32(peak);
+                low = vdivq_f32(low, divisor);
+                mid = vdivq_f32(mid, divisor);
+                high = vdivq_f32(high, divisor);
+            }
+        }
+        vst1q_f32(tonnetz, vaddq_f32(vaddq_f32(low, mid), high));
+        // Lanes 0..1 of (hpcp[0..], hpcp[5..], hpcp[10..])
+        const float32x4_t fifths = vaddq_f32(vaddq_f32(low, vextq_f32(mid, mid, 1)), vextq_f32(high, high, 2));
+        vst1_f32(tonnetz + 4, vget_low_f32(fifths));
+#elif defined(TONNETZ_SSE)
+        __m128 low = _mm_loadu_ps(hpcp);
+        __m128 mid = _mm_loadu_ps(hpcp + 4);
+        __m128 high = _mm_loadu_ps(hpcp + 8);
+        if (normalize) {
+            __m128 peak = _mm_max_ps(_mm_max_ps(low, mid), high);
+            peak = _mm_max_ps(peak, _mm_shuffle_ps(peak, peak, _MM_SHUFFLE(1, 0, 3, 2)));
+            peak = _mm_max_ps(peak, _mm_shuffle_ps(peak, peak, _MM_SHUFFLE(2, 3, 0, 1)));
+            if (_mm_cvtss_f32(peak) != 0.0f) {
+                low = _mm_div_ps(low, peak);
+                mid = _mm_div_ps(mid, peak);
+                high = _mm_div_ps(high, peak);
+            }
+        }
+        _mm_storeu_ps(tonnetz, _mm_add_ps(_mm_add_ps(low, mid), high));
+        // Lanes 0..1 of (hpcp[0..], hpcp[5..], hpcp[10..])
+        const __m128 fifths = _mm_add_ps(_mm_add_ps(low, _mm_shuffle_ps(mid, mid, _MM_SHUFFLE(3, 3, 2, 1))),
+                                         _mm_shuffle_ps(high, high, _MM_SHUFFLE(3, 3, 3, 2)));
+        _mm_storel_pi(reinterpret_cast<__m64*>(tonnetz + 4), fifths);
+#else
+        essentia::Real row[kTonnetzHpcpSize];
+        std::copy(hpcp, hpcp + kTonnetzHpcpSize, row);
+        if (normalize) {
+            const essentia::Real peak = *std::max_element(row, row + kTonnetzHpcpSize);
+            if (peak != 0) {
+                for (auto& value : row) value /= peak;
+            }
+        }
+        for (int k = 0; k < 4; ++k) {
+            tonnetz[k] = row[k] + row[k + 4] + row[k + 8];
+        }
+        for (int k = 0; k < 2; ++k) {
+            tonnetz[4 + k] = row[k] + row[k + 5] + row[k + 10];
+        }
+#endif
+    }
+}
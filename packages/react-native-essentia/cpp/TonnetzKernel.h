@@ -0,0 +1,27 @@
+// packages/react-native-essentia/cpp/TonnetzKernel.h
+#ifndef TONNETZ_KERNEL_H
+#define TONNETZ_KERNEL_H
+
+#include <cstddef>
+
+#include "essentia/types.h"
+
+constexpr int kTonnetzHpcpSize = 12;
+constexpr int kTonnetzSize = 6;
+
+// Project numFrames contiguous 12-bin HPCP rows onto the 6 Tonnetz axes, writing
+// numFrames contiguous 6-value rows to tonnetz (which must not overlap hpcp).
+//
+// The projection matrix is 0/1 with three ones per row, so each axis is the sum
+// of three pitch classes:
+//   0..3: hpcp[k] + hpcp[k + 4] + hpcp[k + 8]   (major-third cycles, k = 0..3)
+//   4..5: hpcp[k] + hpcp[k + 5] + hpcp[k + 10]  (k = 0..1)
+// and a frame is three 4-wide loads and adds, no multiplies.
+//
+// With normalize, each HPCP row is first divided by its largest bin (as
+// essentia::normalize, rows whose largest bin is zero are left as they are) in the
+// same pass, so callers need not normalize a copy first. Results match the
+// unfused normalize-then-project exactly.
+void projectTonnetz(const essentia::Real* hpcp, size_t numFrames, essentia::Real* tonnetz, bool normalize = false);
+
+#endif // TONNETZ_KERNEL_H
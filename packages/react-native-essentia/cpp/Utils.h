@@ -17,16 +17,46 @@
 #include "essentia/pool.h"
 #include "essentia/version.h"
 
-// Android logging macros
+// Logging. ESSENTIA_LOG_LEVEL selects what is compiled in: 0 nothing, 1 errors,
+// 2 warnings, 3 info, 4 debug (per-frame and per-descriptor detail). It defaults to
+// warnings when NDEBUG is defined (release builds) and to info otherwise. Calls above
+// the level compile to nothing; their arguments are type-checked but not evaluated.
+#ifndef ESSENTIA_LOG_LEVEL
+#ifdef NDEBUG
+#define ESSENTIA_LOG_LEVEL 2
+#else
+#define ESSENTIA_LOG_LEVEL 3
+#endif
+#endif
+
 #ifdef __ANDROID__
 #include <android/log.h>
-#define LOGI(...) ((void)__android_log_print(ANDROID_LOG_INFO, "EssentiaWrapper", __VA_ARGS__))
-#define LOGW(...) ((void)__android_log_print(ANDROID_LOG_WARN, "EssentiaWrapper", __VA_ARGS__))
-#define LOGE(...) ((void)__android_log_print(ANDROID_LOG_ERROR, "EssentiaWrapper", __VA_ARGS__))
+#define ESSENTIA_LOG_PRINT(priority, ...) ((void)__android_log_print(ANDROID_LOG_##priority, "EssentiaWrapper", __VA_ARGS__))
+#else
+#include <cstdio>
+#define ESSENTIA_LOG_PRINT(priority, ...) ((void)printf(__VA_ARGS__))
+#endif
+#define ESSENTIA_LOG_DISCARD(...) ((void)sizeof(printf(__VA_ARGS__)))
+
+#if ESSENTIA_LOG_LEVEL >= 1
+#define LOGE(...) ESSENTIA_LOG_PRINT(ERROR, __VA_ARGS__)
+#else
+#define LOGE(...) ESSENTIA_LOG_DISCARD(__VA_ARGS__)
+#endif
+#if ESSENTIA_LOG_LEVEL >= 2
+#define LOGW(...) ESSENTIA_LOG_PRINT(WARN, __VA_ARGS__)
+#else
+#define LOGW(...) ESSENTIA_LOG_DISCARD(__VA_ARGS__)
+#endif
+#if ESSENTIA_LOG_LEVEL >= 3
+#define LOGI(...) ESSENTIA_LOG_PRINT(INFO, __VA_ARGS__)
+#else
+#define LOGI(...) ESSENTIA_LOG_DISCARD(__VA_ARGS__)
+#endif
+#if ESSENTIA_LOG_LEVEL >= 4
+#define LOGD(...) ESSENTIA_LOG_PRINT(DEBUG, __VA_ARGS__)
 #else
-#define LOGI(...) printf(__VA_ARGS__)
-#define LOGW(...) printf(__VA_ARGS__)
-#define LOGE(...) printf(__VA_ARGS__)
+#define LOGD(...) ESSENTIA_LOG_DISCARD(__VA_ARGS__)
 #endif
 
 struct FeatureConfig {
@@ -136,7 +166,7 @@ inline std::map<std::string, essentia::Parameter> jsonToParamsMap(const std::str
             } else if (it.value().is_object()) {
                 std::string nestedJson = it.value().dump();
                 params.insert(std::make_pair(key, essentia::Parameter(nestedJson)));
-                LOGI("Nested object parameter %s: %s", key.c_str(), nestedJson.c_str());
+                LOGD("Nested object parameter %s: %s", key.c_str(), nestedJson.c_str());
             }
         }
     } catch (const nlohmann::json::exception& e) {
@@ -157,21 +187,21 @@ inline std::string poolToJson(const essentia::Pool& pool) {
                     framesArray.push_back(vec);
                 }
                 result[key] = framesArray;
-                LOGI("Serialized %s with %zu frames", key.c_str(), vecOfVecs.size());
+                LOGD("Serialized %s with %zu frames", key.c_str(), vecOfVecs.size());
             } else if (pool.contains<std::vector<essentia::Real>>(key)) {
                 const auto& values = pool.value<std::vector<essentia::Real>>(key);
                 result[key] = values;
-                LOGI("Serialized %s with %zu values", key.c_str(), values.size());
+                LOGD("Serialized %s with %zu values", key.c_str(), values.size());
             } else if (pool.contains<essentia::Real>(key)) {
                 result[key] = pool.value<essentia::Real>(key);
-                LOGI("Serialized %s as single value", key.c_str());
+                LOGD("Serialized %s as single value", key.c_str());
             } else if (pool.contains<std::string>(key)) {
                 result[key] = pool.value<std::string>(key);
-                LOGI("Serialized %s as string", key.c_str());
+                LOGD("Serialized %s as string", key.c_str());
             } else if (pool.contains<std::vector<std::string>>(key)) {
                 const auto& values = pool.value<std::vector<std::string>>(key);
                 result[key] = values;
-                LOGI("Serialized %s with %zu strings", key.c_str(), values.size());
+                LOGD("Serialized %s with %zu strings", key.c_str(), values.size());
             } else {
                 result[key] = "unsupported_type";
                 LOGI("Unsupported type for %s", key.c_str());
@@ -0,0 +1,100 @@
+// packages/react-native-essentia/cpp/WorkerPool.cpp
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+struct WorkerPool::Job {
+    const std::function<void(int)>* fn = nullptr;  // only used while tasks are left
+    int tasks = 0;
+    std::atomic<int> next{0};
+
+    std::mutex mutex;
+    std::condition_variable done;
+    int finished = 0;
+    std::vector<std::exception_ptr> errors;
+};
+
+WorkerPool& WorkerPool::shared() {
+    static WorkerPool pool(std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1));
+    return pool;
+}
+
+WorkerPool::WorkerPool(int maxWorkers) : mMaxWorkers(std::max(1, maxWorkers)) {}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWake.notify_all();
+    for (auto& thread : mThreads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::run(int tasks, const std::function<void(int task)>& fn) {
+    if (tasks <= 0) return;
+    if (tasks == 1) {
+        fn(0);
+        return;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->fn = &fn;
+    job->tasks = tasks;
+    job->errors.resize(tasks);
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        const int helpers = std::min(tasks - 1, mMaxWorkers);
+        while (static_cast<int>(mThreads.size()) < helpers) {
+            mThreads.emplace_back([this]() { workerLoop(); });
+        }
+        for (int i = 0; i < helpers; ++i) {
+            mQueue.push_back(job);
+        }
+    }
+    mWake.notify_all();
+
+    runTasks(*job);
+    {
+        std::unique_lock<std::mutex> lock(job->mutex);
+        job->done.wait(lock, [&job]() { return job->finished == job->tasks; });
+    }
+
+    for (const auto& error : job->errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+void WorkerPool::runTasks(Job& job) {
+    while (true) {
+        const int task = job.next.fetch_add(1);
+        if (task >= job.tasks) return;
+        try {
+            (*job.fn)(task);
+        } catch (...) {
+            job.errors[task] = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(job.mutex);
+        if (++job.finished == job.tasks) {
+            job.done.notify_all();
+        }
+    }
+}
+
+void WorkerPool::workerLoop() {
+    while (true) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWake.wait(lock, [this]() { return mStopping || !mQueue.empty(); });
+            if (mStopping) return;
+            job = std::move(mQueue.front());
+            mQueue.pop_front();
+        }
+        runTasks(*job);
+    }
+}
@@ -0,0 +1,51 @@
+// packages/react-native-essentia/cpp/WorkerPool.h
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Worker threads for frame-parallel work, shared by every EssentiaWrapper session:
+// however many sessions compute at once, at most maxWorkers() threads are started
+// (lazily, on first use) and they are reused from call to call.
+//
+// run(tasks, fn) calls fn(0) ... fn(tasks - 1) and returns once all of them are done.
+// The calling thread takes tasks as well, so a run finishes even when every worker
+// is busy with other sessions (it then just runs without help). The first exception
+// thrown by a task, in task order, is rethrown after all tasks finished.
+class WorkerPool {
+public:
+    // Sized from the number of cores
+    static WorkerPool& shared();
+
+    explicit WorkerPool(int maxWorkers);
+    ~WorkerPool();
+
+    int maxWorkers() const { return mMaxWorkers; }
+    void run(int tasks, const std::function<void(int task)>& fn);
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+private:
+    struct Job;
+
+    static void runTasks(Job& job);
+    void workerLoop();
+
+    const int mMaxWorkers;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    // One entry per worker asked to help; a worker that finds its job already
+    // finished just drops the entry
+    std::deque<std::shared_ptr<Job>> mQueue;
+    std::vector<std::thread> mThreads;
+    bool mStopping = false;
+};
+
+#endif
@@ -42,13 +42,56 @@
                    windowType:(nonnull NSString *)windowType
                     normalize:(nonnull NSNumber *)normalize
                      logScale:(nonnull NSNumber *)logScale
+                  startSample:(nonnull NSNumber *)startSample
+                    endSample:(nonnull NSNumber *)endSample
                      resolver:(nonnull RCTPromiseResolveBlock)resolve
                      rejecter:(nonnull RCTPromiseRejectBlock)reject;
 
+- (void)computeMelSpectrogramToFile:(nonnull NSNumber *)frameSize
+                            hopSize:(nonnull NSNumber *)hopSize
+                              nMels:(nonnull NSNumber *)nMels
+                               fMin:(nonnull NSNumber *)fMin
+                               fMax:(nonnull NSNumber *)fMax
+                         windowType:(nonnull NSString *)windowType
+                          normalize:(nonnull NSNumber *)normalize
+                           logScale:(nonnull NSNumber *)logScale
+                        startSample:(nonnull NSNumber *)startSample
+                          endSample:(nonnull NSNumber *)endSample
+                               path:(nonnull NSString *)path
+                        chunkFrames:(nonnull NSNumber *)chunkFrames
+                           resolver:(nonnull RCTPromiseResolveBlock)resolve
+                           rejecter:(nonnull RCTPromiseRejectBlock)reject;
+
 - (void)executePipeline:(nonnull NSString *)pipelineJsonString
                resolver:(nonnull RCTPromiseResolveBlock)resolve
                rejecter:(nonnull RCTPromiseRejectBlock)reject;
 
+- (void)preparePipeline:(nonnull NSString *)pipelineJsonString
+               resolver:(nonnull RCTPromiseResolveBlock)resolve
+               rejecter:(nonnull RCTPromiseRejectBlock)reject;
+
+- (void)runPipeline:(nonnull NSNumber *)pipelineId
+          audioData:(nullable NSArray *)audioData
+           resolver:(nonnull RCTPromiseResolveBlock)resolve
+           rejecter:(nonnull RCTPromiseRejectBlock)reject;
+
+- (void)releasePipeline:(nonnull NSNumber *)pipelineId
+               resolver:(nonnull RCTPromiseResolveBlock)resolve
+               rejecter:(nonnull RCTPromiseRejectBlock)reject;
+
+- (void)startPipelineStream:(nonnull NSNumber *)pipelineId
+                   resolver:(nonnull RCTPromiseResolveBlock)resolve
+                   rejecter:(nonnull RCTPromiseRejectBlock)reject;
+
+- (void)appendAudio:(nonnull NSNumber *)pipelineId
+          audioData:(nonnull NSArray *)audioData
+           resolver:(nonnull RCTPromiseResolveBlock)resolve
+           rejecter:(nonnull RCTPromiseRejectBlock)reject;
+
+- (void)finishPipelineStream:(nonnull NSNumber *)pipelineId
+                    resolver:(nonnull RCTPromiseResolveBlock)resolve
+                    rejecter:(nonnull RCTPromiseRejectBlock)reject;
+
 - (void)computeSpectrum:(nonnull NSNumber *)frameSize
                 hopSize:(nonnull NSNumber *)hopSize
                resolver:(nonnull RCTPromiseResolveBlock)resolve
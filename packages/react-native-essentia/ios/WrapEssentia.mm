@@ -2,6 +2,9 @@
 #ifdef __cplusplus
 #include "../cpp/EssentiaWrapper.h"
 #include "../cpp/FeatureExtractor.h"
+#include "../cpp/PoolCodec.h"
+#include "../cpp/ResultCache.h"
+#include "../cpp/EssentiaRuntime.h"
 #endif
 
 #import "WrapEssentia.h"
@@ -9,11 +12,40 @@
 // Import your C++ wrapper - use proper bridging with Objective-C++
 #include <vector>
 #include <string>
+#include <mutex>
 
 // Forward declare C++ classes to avoid exposing C++ headers directly to Objective-C
 class EssentiaWrapper;
 // class FeatureExtractor;
 
+// An independent analysis session (createSession): its own wrapper, audio and caches.
+// Calls on a session are serialized by synchronizing on it; different sessions run
+// concurrently on the worker queue.
+@interface EssentiaSession : NSObject
+@property (nonatomic, assign) EssentiaWrapper* wrapper;
+@property (nonatomic, assign) FeatureExtractor* featureExtractor;
+- (void)destroy;
+@end
+
+@implementation EssentiaSession
+
+- (void)destroy {
+  if (_featureExtractor) {
+    delete _featureExtractor;
+    _featureExtractor = nullptr;
+  }
+  if (_wrapper) {
+    delete _wrapper;
+    _wrapper = nullptr;
+  }
+}
+
+- (void)dealloc {
+  [self destroy];
+}
+
+@end
+
 @implementation Essentia {
   EssentiaWrapper* _wrapper;
   FeatureExtractor* _featureExtractor;
@@ -27,6 +59,12 @@ class EssentiaWrapper;
   // Add thread pool variables
   dispatch_queue_t _workerQueue;
   NSInteger _threadCount;
+
+  BOOL _isProfilingEnabled;
+
+  // Sessions by id (createSession)
+  NSMutableDictionary<NSNumber*, EssentiaSession*>* _sessions;
+  NSInteger _nextSessionId;
 }
 
 RCT_EXPORT_MODULE()
@@ -43,7 +81,10 @@ RCT_EXPORT_MODULE()
 
     // Initialize thread pool
     _threadCount = 4; // Default thread count
+    _isProfilingEnabled = NO;
     _workerQueue = dispatch_queue_create("net.siteed.essentia.worker", DISPATCH_QUEUE_CONCURRENT);
+    _sessions = [NSMutableDictionary dictionary];
+    _nextSessionId = 1;
 
     RCTLogInfo(@"[Essentia] Module initialized, lazy initialization will be used");
   }
@@ -70,6 +111,13 @@ RCT_EXPORT_MODULE()
     _isInitialized = NO;
   }
 
+  for (EssentiaSession* session in [_sessions allValues]) {
+    @synchronized(session) {
+      [session destroy];
+    }
+  }
+  [_sessions removeAllObjects];
+
   // No need to explicitly release _workerQueue as ARC will handle it
 }
 
@@ -104,6 +152,9 @@ RCT_EXPORT_MODULE()
           return;
         }
 
+        self->_wrapper->setFrameThreadCount(static_cast<int>(self->_threadCount));
+        self->_wrapper->setProfilingEnabled(self->_isProfilingEnabled);
+
         RCTLogInfo(@"[Essentia] Creating FeatureExtractor");
         self->_featureExtractor = new FeatureExtractor(self->_wrapper);
         self->_isInitialized = YES;
@@ -134,7 +185,7 @@ RCT_EXPORT_METHOD(setAudioData:(NSArray *)audioData
     // Convert JS array to C++ vector
     RCTLogInfo(@"[Essentia] Converting audio data to C++ vector");
     std::vector<float> buffer;
-    buffer.reserve([audioData count]);
+    buffer.reserve([audioData count] + 1);  // room for the even-length padding sample
 
     for (id item in audioData) {
       if ([item isKindOfClass:[NSNumber class]]) {
@@ -143,7 +194,8 @@ RCT_EXPORT_METHOD(setAudioData:(NSArray *)audioData
     }
 
     RCTLogInfo(@"[Essentia] Setting audio data in native layer (%lu samples)", (unsigned long)buffer.size());
-    bool success = self->_wrapper->setAudioData(buffer, [sampleRate doubleValue]);
+    // Handed over without another copy
+    bool success = self->_wrapper->setAudioData(std::move(buffer), [sampleRate doubleValue]);
 
     if (success) {
       RCTLogInfo(@"[Essentia] Successfully set audio data");
@@ -205,6 +257,47 @@ RCT_EXPORT_METHOD(executeAlgorithm:(NSString *)algorithm
   } rejecter:reject];
 }
 
+// Same as executeAlgorithm, but resolves with the result pool in the binary encoding
+// (cpp/PoolCodec.h), base64-encoded for the bridge
+RCT_EXPORT_METHOD(executeAlgorithmBinary:(NSString *)algorithm
+                  params:(NSDictionary *)params
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  RCTLogInfo(@"[Essentia] executeAlgorithmBinary called with algorithm: %@", algorithm);
+
+  if ([algorithm length] == 0) {
+    reject(@"ESSENTIA_INVALID_INPUT", @"Algorithm name cannot be empty", nil);
+    return;
+  }
+
+  [self ensureInitializedWithResolver:^(id initResult) {
+    NSError *error;
+    NSData *jsonData = [NSJSONSerialization dataWithJSONObject:params options:0 error:&error];
+
+    if (error) {
+      RCTLogError(@"[Essentia] Failed to serialize parameters: %@", error);
+      reject(@"json_error", @"Failed to serialize parameters", error);
+      return;
+    }
+
+    NSString *paramsJson = [[NSString alloc] initWithData:jsonData encoding:NSUTF8StringEncoding];
+
+    essentia::Pool pool;
+    std::string algError = self->_wrapper->executeAlgorithm([algorithm UTF8String], [paramsJson UTF8String], pool);
+    if (!algError.empty()) {
+      id resultMap = [self parseJSONString:[NSString stringWithUTF8String:algError.c_str()]];
+      if (![self handleErrorInResultMap:resultMap promise:resolve rejecter:reject]) {
+        reject(@"ESSENTIA_ALGORITHM_ERROR", @"Algorithm execution failed", nil);
+      }
+      return;
+    }
+
+    std::vector<uint8_t> encoded = poolToBinary(pool);
+    NSData *data = [NSData dataWithBytesNoCopy:encoded.data() length:encoded.size() freeWhenDone:NO];
+    resolve([data base64EncodedStringWithOptions:0]);
+  } rejecter:reject];
+}
+
 #pragma mark - Algorithm information methods
 
 // Add this helper method for JSON parsing
@@ -350,6 +443,8 @@ RCT_EXPORT_METHOD(computeMelSpectrogram:(nonnull NSNumber *)frameSize
                   windowType:(NSString *)windowType
                   normalize:(nonnull NSNumber *)normalize
                   logScale:(nonnull NSNumber *)logScale
+                  startSample:(nonnull NSNumber *)startSample
+                  endSample:(nonnull NSNumber *)endSample
                   resolver:(RCTPromiseResolveBlock)resolve
                   rejecter:(RCTPromiseRejectBlock)reject) {
   RCTLogInfo(@"[Essentia] computeMelSpectrogram called with frameSize: %@, hopSize: %@, nMels: %@",
@@ -365,7 +460,9 @@ RCT_EXPORT_METHOD(computeMelSpectrogram:(nonnull NSNumber *)frameSize
       [fMax floatValue],
       [windowType UTF8String],
       [normalize boolValue],
-      [logScale boolValue]
+      [logScale boolValue],
+      [startSample longLongValue],
+      [endSample longLongValue]
     );
     RCTLogInfo(@"[Essentia] Mel spectrogram computation completed");
 
@@ -375,6 +472,48 @@ RCT_EXPORT_METHOD(computeMelSpectrogram:(nonnull NSNumber *)frameSize
   } rejecter:reject];
 }
 
+// Same bands as computeMelSpectrogram, written to path (little-endian float32, timeSteps x
+// nMels, row-major) chunkFrames frames at a time so memory stays bounded on long audio
+RCT_EXPORT_METHOD(computeMelSpectrogramToFile:(nonnull NSNumber *)frameSize
+                  hopSize:(nonnull NSNumber *)hopSize
+                  nMels:(nonnull NSNumber *)nMels
+                  fMin:(nonnull NSNumber *)fMin
+                  fMax:(nonnull NSNumber *)fMax
+                  windowType:(NSString *)windowType
+                  normalize:(nonnull NSNumber *)normalize
+                  logScale:(nonnull NSNumber *)logScale
+                  startSample:(nonnull NSNumber *)startSample
+                  endSample:(nonnull NSNumber *)endSample
+                  path:(NSString *)path
+                  chunkFrames:(nonnull NSNumber *)chunkFrames
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  RCTLogInfo(@"[Essentia] computeMelSpectrogramToFile called with path: %@, chunkFrames: %@", path, chunkFrames);
+
+  if ([path length] == 0) {
+    reject(@"ESSENTIA_INVALID_INPUT", @"path cannot be empty", nil);
+    return;
+  }
+
+  [self ensureInitializedWithResolver:^(id initResult) {
+    std::string result = self->_featureExtractor->computeMelSpectrogramToFile(
+      [frameSize intValue],
+      [hopSize intValue],
+      [nMels intValue],
+      [fMin floatValue],
+      [fMax floatValue],
+      [windowType UTF8String],
+      [normalize boolValue],
+      [logScale boolValue],
+      [startSample longLongValue],
+      [endSample longLongValue],
+      [path UTF8String],
+      [chunkFrames intValue]
+    );
+    [self resolveNativeResult:result resolver:resolve rejecter:reject];
+  } rejecter:reject];
+}
+
 RCT_EXPORT_METHOD(executePipeline:(NSString *)pipelineJsonString
                   resolver:(RCTPromiseResolveBlock)resolve
                   rejecter:(RCTPromiseRejectBlock)reject) {
@@ -398,6 +537,123 @@ RCT_EXPORT_METHOD(executePipeline:(NSString *)pipelineJsonString
   } rejecter:reject];
 }
 
+RCT_EXPORT_METHOD(preparePipeline:(NSString *)pipelineJsonString
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  RCTLogInfo(@"[Essentia] preparePipeline called");
+
+  [self ensureInitializedWithResolver:^(id initResult) {
+    if ([pipelineJsonString length] == 0) {
+      reject(@"essentia_invalid_input", @"Pipeline configuration cannot be empty", nil);
+      return;
+    }
+
+    std::string prepareResult = self->_featureExtractor->preparePipeline([pipelineJsonString UTF8String]);
+    id resultMap = [self parseJSONString:[NSString stringWithUTF8String:prepareResult.c_str()]];
+    if ([self handleErrorInResultMap:resultMap promise:resolve rejecter:reject]) {
+      return;
+    }
+    resolve(resultMap);
+  } rejecter:reject];
+}
+
+RCT_EXPORT_METHOD(runPipeline:(nonnull NSNumber *)pipelineId
+                  audioData:(NSArray *)audioData
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  RCTLogInfo(@"[Essentia] runPipeline called with pipelineId: %@", pipelineId);
+
+  [self ensureInitializedWithResolver:^(id initResult) {
+    std::string runResult;
+    if (audioData == nil || [audioData isKindOfClass:[NSNull class]]) {
+      runResult = self->_featureExtractor->runPipeline([pipelineId intValue]);
+    } else {
+      // Run on the given samples without replacing the current audio data
+      std::vector<float> buffer;
+      buffer.reserve([audioData count]);
+      for (id item in audioData) {
+        if ([item isKindOfClass:[NSNumber class]]) {
+          buffer.push_back([item floatValue]);
+        }
+      }
+      runResult = self->_featureExtractor->runPipeline([pipelineId intValue], buffer);
+    }
+
+    id resultMap = [self parseJSONString:[NSString stringWithUTF8String:runResult.c_str()]];
+    if ([self handleErrorInResultMap:resultMap promise:resolve rejecter:reject]) {
+      return;
+    }
+    resolve(resultMap);
+  } rejecter:reject];
+}
+
+RCT_EXPORT_METHOD(releasePipeline:(nonnull NSNumber *)pipelineId
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  RCTLogInfo(@"[Essentia] releasePipeline called with pipelineId: %@", pipelineId);
+
+  [self ensureInitializedWithResolver:^(id initResult) {
+    std::string releaseResult = self->_featureExtractor->releasePipeline([pipelineId intValue]);
+    id resultMap = [self parseJSONString:[NSString stringWithUTF8String:releaseResult.c_str()]];
+    if ([self handleErrorInResultMap:resultMap promise:resolve rejecter:reject]) {
+      return;
+    }
+    resolve(resultMap);
+  } rejecter:reject];
+}
+
+RCT_EXPORT_METHOD(startPipelineStream:(nonnull NSNumber *)pipelineId
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  RCTLogInfo(@"[Essentia] startPipelineStream called with pipelineId: %@", pipelineId);
+
+  [self ensureInitializedWithResolver:^(id initResult) {
+    std::string startResult = self->_featureExtractor->startPipelineStream([pipelineId intValue]);
+    id resultMap = [self parseJSONString:[NSString stringWithUTF8String:startResult.c_str()]];
+    if ([self handleErrorInResultMap:resultMap promise:resolve rejecter:reject]) {
+      return;
+    }
+    resolve(resultMap);
+  } rejecter:reject];
+}
+
+RCT_EXPORT_METHOD(appendAudio:(nonnull NSNumber *)pipelineId
+                  audioData:(NSArray *)audioData
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  [self ensureInitializedWithResolver:^(id initResult) {
+    std::vector<float> chunk;
+    chunk.reserve([audioData count]);
+    for (id item in audioData) {
+      if ([item isKindOfClass:[NSNumber class]]) {
+        chunk.push_back([item floatValue]);
+      }
+    }
+
+    std::string appendResult = self->_featureExtractor->appendAudio([pipelineId intValue], chunk);
+    id resultMap = [self parseJSONString:[NSString stringWithUTF8String:appendResult.c_str()]];
+    if ([self handleErrorInResultMap:resultMap promise:resolve rejecter:reject]) {
+      return;
+    }
+    resolve(resultMap);
+  } rejecter:reject];
+}
+
+RCT_EXPORT_METHOD(finishPipelineStream:(nonnull NSNumber *)pipelineId
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  RCTLogInfo(@"[Essentia] finishPipelineStream called with pipelineId: %@", pipelineId);
+
+  [self ensureInitializedWithResolver:^(id initResult) {
+    std::string finishResult = self->_featureExtractor->finishPipelineStream([pipelineId intValue]);
+    id resultMap = [self parseJSONString:[NSString stringWithUTF8String:finishResult.c_str()]];
+    if ([self handleErrorInResultMap:resultMap promise:resolve rejecter:reject]) {
+      return;
+    }
+    resolve(resultMap);
+  } rejecter:reject];
+}
+
 RCT_EXPORT_METHOD(computeSpectrum:(nonnull NSNumber *)frameSize
                   hopSize:(nonnull NSNumber *)hopSize
                   resolver:(RCTPromiseResolveBlock)resolve
@@ -554,6 +810,15 @@ RCT_EXPORT_METHOD(setThreadCount:(nonnull NSNumber *)count
       // Note: In iOS/GCD, we don't need to recreate the queue as GCD manages threads
       RCTLogInfo(@"[Essentia] Thread count updated to %ld", (long)_threadCount);
     }
+    // Frame-parallel native processing uses the same count
+    if (_wrapper) {
+      _wrapper->setFrameThreadCount(static_cast<int>(_threadCount));
+    }
+    for (EssentiaSession* session in [_sessions allValues]) {
+      if (session.wrapper) {
+        session.wrapper->setFrameThreadCount(static_cast<int>(_threadCount));
+      }
+    }
   }
 
   resolve(@YES);
@@ -565,6 +830,248 @@ RCT_EXPORT_METHOD(getThreadCount:(RCTPromiseResolveBlock)resolve
   resolve(@(_threadCount));
 }
 
+RCT_EXPORT_METHOD(setProfilingEnabled:(BOOL)enabled
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  RCTLogInfo(@"[Essentia] setProfilingEnabled called with enabled: %@", enabled ? @"YES" : @"NO");
+
+  @synchronized(self) {
+    _isProfilingEnabled = enabled;
+    if (_wrapper) {
+      _wrapper->setProfilingEnabled(enabled);
+    }
+    for (EssentiaSession* session in [_sessions allValues]) {
+      if (session.wrapper) {
+        session.wrapper->setProfilingEnabled(enabled);
+      }
+    }
+  }
+
+  resolve(@YES);
+}
+
+#pragma mark - Result cache
+
+// Sizes the memo cache of extractFeatures / executePipeline results shared by all
+// sessions (0 disables it); persist keeps the entries in the app's caches directory
+RCT_EXPORT_METHOD(setResultCache:(nonnull NSNumber *)maxBytes
+                  persist:(BOOL)persist
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  RCTLogInfo(@"[Essentia] setResultCache called with maxBytes: %@, persist: %@", maxBytes, persist ? @"YES" : @"NO");
+
+  if ([maxBytes longLongValue] < 0) {
+    reject(@"ESSENTIA_INVALID_INPUT", @"maxBytes must not be negative", nil);
+    return;
+  }
+
+  dispatch_async(_workerQueue, ^{
+    std::string directory;
+    if (persist) {
+      NSString *caches = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject;
+      directory = [[caches stringByAppendingPathComponent:@"essentia-results"] UTF8String];
+    }
+    ResultCache::shared().configure(static_cast<size_t>([maxBytes longLongValue]), directory);
+    resolve(@YES);
+  });
+}
+
+RCT_EXPORT_METHOD(clearResultCache:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  RCTLogInfo(@"[Essentia] clearResultCache called");
+
+  dispatch_async(_workerQueue, ^{
+    ResultCache::shared().clear();
+    resolve(@YES);
+  });
+}
+
+#pragma mark - Algorithm registration
+
+// Lazy (default): algorithms are registered on the first algorithm call, so
+// initialize returns quickly; otherwise during initialize. Applies to the next
+// initialization.
+RCT_EXPORT_METHOD(setLazyRegistration:(BOOL)enabled
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  RCTLogInfo(@"[Essentia] setLazyRegistration called with enabled: %@", enabled ? @"YES" : @"NO");
+  EssentiaRuntime::setLazyRegistration(enabled);
+  resolve(@YES);
+}
+
+#pragma mark - Sessions
+
+// Runs block on the worker queue with the session, holding it so that calls on one
+// session run one at a time (and never after destroySession)
+- (void)withSession:(nonnull NSNumber *)sessionId
+           rejecter:(RCTPromiseRejectBlock)reject
+              block:(void (^)(EssentiaSession* session))block {
+  EssentiaSession* session;
+  @synchronized(self) {
+    session = _sessions[sessionId];
+  }
+  if (!session) {
+    reject(@"ESSENTIA_INVALID_SESSION", [NSString stringWithFormat:@"No session with id %@", sessionId], nil);
+    return;
+  }
+
+  dispatch_async(_workerQueue, ^{
+    @synchronized(session) {
+      if (!session.wrapper) {
+        reject(@"ESSENTIA_INVALID_SESSION", [NSString stringWithFormat:@"Session %@ was destroyed", sessionId], nil);
+        return;
+      }
+      std::lock_guard<std::mutex> lock(session.wrapper->sessionMutex());
+      block(session);
+    }
+  });
+}
+
+- (void)resolveNativeResult:(const std::string&)result
+                   resolver:(RCTPromiseResolveBlock)resolve
+                   rejecter:(RCTPromiseRejectBlock)reject {
+  id resultMap = [self parseJSONString:[NSString stringWithUTF8String:result.c_str()]];
+  if (![self handleErrorInResultMap:resultMap promise:resolve rejecter:reject]) {
+    resolve(resultMap);
+  }
+}
+
+RCT_EXPORT_METHOD(createSession:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  RCTLogInfo(@"[Essentia] createSession called");
+
+  dispatch_async(_workerQueue, ^{
+    EssentiaSession* session = [[EssentiaSession alloc] init];
+    session.wrapper = new EssentiaWrapper();
+    if (!session.wrapper->initialize()) {
+      [session destroy];
+      reject(@"init_failed", @"Failed to initialize Essentia wrapper", nil);
+      return;
+    }
+    session.featureExtractor = new FeatureExtractor(session.wrapper);
+
+    NSNumber* sessionId;
+    @synchronized(self) {
+      session.wrapper->setFrameThreadCount(static_cast<int>(self->_threadCount));
+      session.wrapper->setProfilingEnabled(self->_isProfilingEnabled);
+      sessionId = @(self->_nextSessionId++);
+      self->_sessions[sessionId] = session;
+    }
+    resolve(sessionId);
+  });
+}
+
+RCT_EXPORT_METHOD(destroySession:(nonnull NSNumber *)sessionId
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  RCTLogInfo(@"[Essentia] destroySession called with sessionId: %@", sessionId);
+
+  EssentiaSession* session;
+  @synchronized(self) {
+    session = _sessions[sessionId];
+    [_sessions removeObjectForKey:sessionId];
+  }
+  if (!session) {
+    resolve(@NO);
+    return;
+  }
+
+  dispatch_async(_workerQueue, ^{
+    @synchronized(session) {
+      [session destroy];
+    }
+    resolve(@YES);
+  });
+}
+
+RCT_EXPORT_METHOD(sessionSetAudioData:(nonnull NSNumber *)sessionId
+                  audioData:(NSArray *)audioData
+                  sampleRate:(nonnull NSNumber *)sampleRate
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  RCTLogInfo(@"[Essentia] sessionSetAudioData called for session %@ with %lu samples",
+             sessionId, (unsigned long)[audioData count]);
+
+  [self withSession:sessionId rejecter:reject block:^(EssentiaSession* session) {
+    std::vector<float> buffer;
+    buffer.reserve([audioData count] + 1);  // room for the even-length padding sample
+    for (id item in audioData) {
+      if ([item isKindOfClass:[NSNumber class]]) {
+        buffer.push_back([item floatValue]);
+      }
+    }
+
+    if (session.wrapper->setAudioData(std::move(buffer), [sampleRate doubleValue])) {
+      resolve(@YES);
+    } else {
+      reject(@"set_audio_failed", @"Failed to set audio data", nil);
+    }
+  }];
+}
+
+RCT_EXPORT_METHOD(sessionExecuteAlgorithm:(nonnull NSNumber *)sessionId
+                  algorithm:(NSString *)algorithm
+                  params:(NSDictionary *)params
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  RCTLogInfo(@"[Essentia] sessionExecuteAlgorithm called for session %@ with algorithm: %@", sessionId, algorithm);
+
+  if ([algorithm length] == 0) {
+    reject(@"ESSENTIA_INVALID_INPUT", @"Algorithm name cannot be empty", nil);
+    return;
+  }
+  NSError *error;
+  NSData *jsonData = [NSJSONSerialization dataWithJSONObject:params options:0 error:&error];
+  if (error) {
+    reject(@"json_error", @"Failed to serialize parameters", error);
+    return;
+  }
+  NSString *paramsJson = [[NSString alloc] initWithData:jsonData encoding:NSUTF8StringEncoding];
+
+  [self withSession:sessionId rejecter:reject block:^(EssentiaSession* session) {
+    std::string result = session.wrapper->executeAlgorithm([algorithm UTF8String], [paramsJson UTF8String]);
+    [self resolveNativeResult:result resolver:resolve rejecter:reject];
+  }];
+}
+
+RCT_EXPORT_METHOD(sessionExtractFeatures:(nonnull NSNumber *)sessionId
+                  features:(NSArray *)features
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  RCTLogInfo(@"[Essentia] sessionExtractFeatures called for session %@ with %lu features",
+             sessionId, (unsigned long)[features count]);
+
+  NSError *error;
+  NSData *jsonData = [NSJSONSerialization dataWithJSONObject:features options:0 error:&error];
+  if (error) {
+    reject(@"json_error", @"Failed to serialize features", error);
+    return;
+  }
+  NSString *featuresJson = [[NSString alloc] initWithData:jsonData encoding:NSUTF8StringEncoding];
+
+  [self withSession:sessionId rejecter:reject block:^(EssentiaSession* session) {
+    std::string result = session.featureExtractor->extractFeatures([featuresJson UTF8String]);
+    [self resolveNativeResult:result resolver:resolve rejecter:reject];
+  }];
+}
+
+RCT_EXPORT_METHOD(sessionExecutePipeline:(nonnull NSNumber *)sessionId
+                  pipelineJson:(NSString *)pipelineJsonString
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  RCTLogInfo(@"[Essentia] sessionExecutePipeline called for session %@", sessionId);
+
+  if ([pipelineJsonString length] == 0) {
+    reject(@"essentia_invalid_input", @"Pipeline configuration cannot be empty", nil);
+    return;
+  }
+
+  [self withSession:sessionId rejecter:reject block:^(EssentiaSession* session) {
+    std::string result = session.featureExtractor->executePipeline([pipelineJsonString UTF8String]);
+    [self resolveNativeResult:result resolver:resolve rejecter:reject];
+  }];
+}
+
 // Helper method to handle errors in result maps
 - (BOOL)handleErrorInResultMap:(id)resultMap
                        promise:(RCTPromiseResolveBlock)resolve
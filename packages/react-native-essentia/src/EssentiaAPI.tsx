@@ -24,6 +24,8 @@ import type {
   LoudnessResult,
   MelBandsParams,
   MelBandsResult,
+  MelSpectrogramFileParams,
+  MelSpectrogramFileResult,
   MelSpectrogramParams,
   MelSpectrogramResult,
   MFCCParams,
@@ -47,16 +49,23 @@ import type {
 
 import type {
   AlgorithmParams,
+  AnalysisRange,
   EssentiaInterface,
   EssentiaResult,
+  EssentiaSession,
+  ExecuteAlgorithmOptions,
   FeatureConfig,
   PipelineConfig,
   PipelineResult,
+  PipelineStreamResult,
+  ResultCacheOptions,
+  ResultFormat,
 } from './types/core.types';
 import type {
   MusicGenreFeatures,
   SpeechEmotionFeatures,
 } from './types/pipeline.types';
+import { decodeBinaryPool } from './utils/binaryPool';
 import { validateAlgorithmParams } from './utils/parameterValidation';
 
 // Get the native module
@@ -71,12 +80,83 @@ const Essentia = NativeModules.Essentia
       }
     );
 
+// The typed helpers below post-process plain arrays, whatever the default format
+const JSON_RESULT: ExecuteAlgorithmOptions = { resultFormat: 'json' };
+
+// Handle on a native session; see EssentiaAPI.createSession
+class EssentiaSessionHandle implements EssentiaSession {
+  constructor(readonly id: number) {}
+
+  async setAudioData(
+    pcmData: number[] | Float32Array,
+    sampleRate: number
+  ): Promise<boolean> {
+    if (!pcmData || pcmData.length === 0) {
+      throw new Error('Invalid PCM data: must be a non-empty array');
+    }
+    if (sampleRate <= 0) {
+      throw new Error('Sample rate must be positive');
+    }
+    return await Essentia.sessionSetAudioData(
+      this.id,
+      Array.from(pcmData),
+      sampleRate
+    );
+  }
+
+  async executeAlgorithm(
+    algorithm: string,
+    params: AlgorithmParams = {}
+  ): Promise<any> {
+    if (!algorithm || !algorithm.trim()) {
+      throw {
+        code: 'INVALID_PARAMETERS',
+        message: 'Algorithm name must be a non-empty string',
+      };
+    }
+    return await Essentia.sessionExecuteAlgorithm(
+      this.id,
+      algorithm,
+      validateAlgorithmParams(algorithm, params) || {}
+    );
+  }
+
+  async extractFeatures(
+    features: FeatureConfig[],
+    range?: AnalysisRange
+  ): Promise<any> {
+    if (!features || features.length === 0) {
+      throw new Error('Feature list cannot be empty');
+    }
+    const cleanedFeatures = features.map((feature) => ({
+      name: feature.name,
+      params: {
+        ...(validateAlgorithmParams(feature.name, feature.params) || {}),
+        ...range,
+      },
+    }));
+    return await Essentia.sessionExtractFeatures(this.id, cleanedFeatures);
+  }
+
+  async executePipeline(config: PipelineConfig): Promise<PipelineResult> {
+    return await Essentia.sessionExecutePipeline(
+      this.id,
+      JSON.stringify(config)
+    );
+  }
+
+  async destroy(): Promise<boolean> {
+    return await Essentia.destroySession(this.id);
+  }
+}
+
 // Implement the API class
 class EssentiaAPI implements EssentiaInterface {
   // JavaScript-side caching
   private algorithmInfoCache: Map<string, any> = new Map();
   private allAlgorithmsCache: any = null;
   private isCacheEnabledValue: boolean = true;
+  private resultFormat: ResultFormat = 'json';
 
   /**
    * Initializes the Essentia library, preparing it for use.
@@ -169,11 +249,13 @@ class EssentiaAPI implements EssentiaInterface {
    * Executes a specified Essentia algorithm on the set audio data, using provided parameters.
    * @param algorithm Name of the Essentia algorithm (e.g., "MFCC", "Spectrum", "Key")
    * @param params An object containing key-value pairs for algorithm configuration
+   * @param options resultFormat overrides the default set with setResultFormat
    * @returns A Promise that resolves to an object containing the algorithm's output
    */
   async executeAlgorithm(
     algorithm: string,
-    params: AlgorithmParams = {}
+    params: AlgorithmParams = {},
+    options: ExecuteAlgorithmOptions = {}
   ): Promise<any> {
     try {
       // Validate algorithm name
@@ -195,6 +277,15 @@ class EssentiaAPI implements EssentiaInterface {
       // Validate specific parameters based on algorithm type
       this.validateAlgorithmParams(algorithm, params);
 
+      const resultFormat = options.resultFormat ?? this.resultFormat;
+      if (resultFormat === 'binary') {
+        const encoded: string = await Essentia.executeAlgorithmBinary(
+          algorithm,
+          params
+        );
+        return { success: true, data: decodeBinaryPool(encoded) };
+      }
+
       return await Essentia.executeAlgorithm(algorithm, params);
     } catch (error) {
       console.error(`Essentia algorithm error (${algorithm}):`, error);
@@ -202,6 +293,30 @@ class EssentiaAPI implements EssentiaInterface {
     }
   }
 
+  /**
+   * Sets the default result format of executeAlgorithm.
+   * 'binary' avoids the JSON round trip for large frame-wise outputs (MFCC,
+   * MelBands, ...) and returns Float32Array views; 'json' (the default) returns
+   * plain arrays, which the extract* helpers rely on and which is easier to debug.
+   * @param format 'json' or 'binary'
+   */
+  setResultFormat(format: ResultFormat): void {
+    if (format !== 'json' && format !== 'binary') {
+      throw {
+        code: 'INVALID_PARAMETERS',
+        message: "Result format must be 'json' or 'binary'",
+      };
+    }
+    this.resultFormat = format;
+  }
+
+  /**
+   * Gets the default result format of executeAlgorithm.
+   */
+  getResultFormat(): ResultFormat {
+    return this.resultFormat;
+  }
+
   /**
    * Validates parameters for specific algorithms to prevent native crashes
    * @param algorithm Name of the algorithm
@@ -371,183 +486,296 @@ class EssentiaAPI implements EssentiaInterface {
    */
   async executePipeline(config: PipelineConfig): Promise<PipelineResult> {
     try {
-      // Validate the pipeline configuration
-      if (!config || typeof config !== 'object' || config === null) {
+      await this.validatePipelineConfig(config);
+
+      const pipelineJson = JSON.stringify(config);
+      return await Essentia.executePipeline(pipelineJson);
+    } catch (error) {
+      console.error('Essentia executePipeline error:', error);
+      throw error;
+    }
+  }
+
+  /**
+   * Validates and compiles a pipeline once. The returned id can be passed to
+   * runPipeline any number of times (e.g. after each setAudioData) without
+   * re-parsing the configuration or re-creating its algorithms.
+   *
+   * @param config Configuration object defining the pipeline steps
+   * @returns A Promise that resolves to the pipeline id
+   */
+  async preparePipeline(config: PipelineConfig): Promise<number> {
+    try {
+      await this.validatePipelineConfig(config);
+
+      const result = await Essentia.preparePipeline(JSON.stringify(config));
+      return result.data.pipelineId;
+    } catch (error) {
+      console.error('Essentia preparePipeline error:', error);
+      throw error;
+    }
+  }
+
+  /**
+   * Runs a prepared pipeline on the current audio data, or on pcmData when
+   * given (the current audio data is left unchanged).
+   *
+   * @param pipelineId Id returned by preparePipeline
+   * @param pcmData Optional samples to run on instead of the current audio
+   * @returns A Promise that resolves to the same result as executePipeline
+   */
+  async runPipeline(
+    pipelineId: number,
+    pcmData?: Float32Array | number[]
+  ): Promise<PipelineResult> {
+    try {
+      const audio = pcmData ? Array.from(pcmData) : null;
+      return await Essentia.runPipeline(pipelineId, audio);
+    } catch (error) {
+      console.error('Essentia runPipeline error:', error);
+      throw error;
+    }
+  }
+
+  /**
+   * Releases a prepared pipeline and the algorithm instances it holds.
+   * @param pipelineId Id returned by preparePipeline
+   */
+  async releasePipeline(pipelineId: number): Promise<boolean> {
+    try {
+      const result = await Essentia.releasePipeline(pipelineId);
+      return result.success;
+    } catch (error) {
+      console.error('Essentia releasePipeline error:', error);
+      throw error;
+    }
+  }
+
+  /**
+   * Starts feeding live audio to a prepared frame-based pipeline. Call
+   * appendAudio with each new chunk and finishPipelineStream at the end.
+   * @param pipelineId Id returned by preparePipeline
+   */
+  async startPipelineStream(pipelineId: number): Promise<boolean> {
+    try {
+      const result = await Essentia.startPipelineStream(pipelineId);
+      return result.success;
+    } catch (error) {
+      console.error('Essentia startPipelineStream error:', error);
+      throw error;
+    }
+  }
+
+  /**
+   * Processes the frames completed by the next chunk of a pipeline stream.
+   * The FrameCutter overlap and the state of stateful algorithms carry over
+   * from the previous chunk, so only new frames are computed.
+   *
+   * @param pipelineId Id of a pipeline with a stream in progress
+   * @param chunk Samples following the previous chunk
+   * @returns The rows of the new frames per feature
+   */
+  async appendAudio(
+    pipelineId: number,
+    chunk: Float32Array | number[]
+  ): Promise<PipelineStreamResult> {
+    try {
+      return await Essentia.appendAudio(pipelineId, Array.from(chunk));
+    } catch (error) {
+      console.error('Essentia appendAudio error:', error);
+      throw error;
+    }
+  }
+
+  /**
+   * Ends a pipeline stream: processes the remaining zero-padded frames and
+   * returns their rows together with the mean/variance summary.
+   * @param pipelineId Id of a pipeline with a stream in progress
+   */
+  async finishPipelineStream(pipelineId: number): Promise<PipelineStreamResult> {
+    try {
+      return await Essentia.finishPipelineStream(pipelineId);
+    } catch (error) {
+      console.error('Essentia finishPipelineStream error:', error);
+      throw error;
+    }
+  }
+
+  /**
+   * Checks a pipeline configuration before it is sent to the native side.
+   * Throws an { code, message } error for the first problem found.
+   */
+  private async validatePipelineConfig(config: PipelineConfig): Promise<void> {
+    // Validate the pipeline configuration
+    if (!config || typeof config !== 'object' || config === null) {
+      throw {
+        code: 'INVALID_PARAMETERS',
+        message: 'Pipeline configuration must be an object',
+      };
+    }
+
+    if (
+      !config.preprocess ||
+      !Array.isArray(config.preprocess) ||
+      config.preprocess.length === 0
+    ) {
+      throw {
+        code: 'INVALID_PARAMETERS',
+        message:
+          'Pipeline configuration must include at least one preprocessing step',
+      };
+    }
+
+    if (
+      !config.features ||
+      !Array.isArray(config.features) ||
+      config.features.length === 0
+    ) {
+      throw {
+        code: 'INVALID_PARAMETERS',
+        message:
+          'Pipeline configuration must include at least one feature extraction step',
+      };
+    }
+
+    // Validate preprocessing steps
+    for (let i = 0; i < config.preprocess.length; i++) {
+      const step = config.preprocess[i];
+      // TypeScript safety check
+      if (!step) {
         throw {
           code: 'INVALID_PARAMETERS',
-          message: 'Pipeline configuration must be an object',
+          message: `Preprocessing step at index ${i} is undefined`,
         };
       }
 
-      if (
-        !config.preprocess ||
-        !Array.isArray(config.preprocess) ||
-        config.preprocess.length === 0
-      ) {
+      if (!step.name || typeof step.name !== 'string' || !step.name.trim()) {
         throw {
           code: 'INVALID_PARAMETERS',
-          message:
-            'Pipeline configuration must include at least one preprocessing step',
+          message: `Preprocessing step at index ${i} must have a valid name`,
         };
       }
 
       if (
-        !config.features ||
-        !Array.isArray(config.features) ||
-        config.features.length === 0
+        step.params !== undefined &&
+        (typeof step.params !== 'object' || step.params === null)
       ) {
         throw {
           code: 'INVALID_PARAMETERS',
-          message:
-            'Pipeline configuration must include at least one feature extraction step',
+          message: `Preprocessing step '${step.name}' has invalid params (must be an object)`,
         };
       }
 
-      // Validate preprocessing steps
-      for (let i = 0; i < config.preprocess.length; i++) {
-        const step = config.preprocess[i];
-        // TypeScript safety check
-        if (!step) {
-          throw {
-            code: 'INVALID_PARAMETERS',
-            message: `Preprocessing step at index ${i} is undefined`,
-          };
-        }
-
-        if (!step.name || typeof step.name !== 'string' || !step.name.trim()) {
-          throw {
-            code: 'INVALID_PARAMETERS',
-            message: `Preprocessing step at index ${i} must have a valid name`,
-          };
-        }
-
-        if (
-          step.params !== undefined &&
-          (typeof step.params !== 'object' || step.params === null)
-        ) {
-          throw {
-            code: 'INVALID_PARAMETERS',
-            message: `Preprocessing step '${step.name}' has invalid params (must be an object)`,
-          };
-        }
-
-        // Validate algorithm-specific parameters
-        if (step.params) {
-          this.validateAlgorithmParams(step.name, step.params);
-        }
+      // Validate algorithm-specific parameters
+      if (step.params) {
+        this.validateAlgorithmParams(step.name, step.params);
       }
+    }
 
-      // Validate feature extraction steps
-      for (let i = 0; i < config.features.length; i++) {
-        const feature = config.features[i];
-        // TypeScript safety check
-        if (!feature) {
-          throw {
-            code: 'INVALID_PARAMETERS',
-            message: `Feature at index ${i} is undefined`,
-          };
-        }
-
-        if (
-          !feature.name ||
-          typeof feature.name !== 'string' ||
-          !feature.name.trim()
-        ) {
-          throw {
-            code: 'INVALID_PARAMETERS',
-            message: `Feature at index ${i} must have a valid name`,
-          };
-        }
-
-        if (
-          !feature.input ||
-          typeof feature.input !== 'string' ||
-          !feature.input.trim()
-        ) {
-          throw {
-            code: 'INVALID_PARAMETERS',
-            message: `Feature '${feature.name}' is missing required 'input' field`,
-          };
-        }
-
-        if (
-          feature.params !== undefined &&
-          (typeof feature.params !== 'object' || feature.params === null)
-        ) {
-          throw {
-            code: 'INVALID_PARAMETERS',
-            message: `Feature '${feature.name}' has invalid params (must be an object)`,
-          };
-        }
-
-        if (
-          feature.postProcess !== undefined &&
-          (typeof feature.postProcess !== 'object' ||
-            feature.postProcess === null)
-        ) {
-          throw {
-            code: 'INVALID_PARAMETERS',
-            message: `Feature '${feature.name}' has invalid postProcess (must be an object)`,
-          };
-        }
+    // Validate feature extraction steps
+    for (let i = 0; i < config.features.length; i++) {
+      const feature = config.features[i];
+      // TypeScript safety check
+      if (!feature) {
+        throw {
+          code: 'INVALID_PARAMETERS',
+          message: `Feature at index ${i} is undefined`,
+        };
+      }
 
-        // Validate algorithm-specific parameters
-        if (feature.params) {
-          this.validateAlgorithmParams(feature.name, feature.params);
-        }
+      if (
+        !feature.name ||
+        typeof feature.name !== 'string' ||
+        !feature.name.trim()
+      ) {
+        throw {
+          code: 'INVALID_PARAMETERS',
+          message: `Feature at index ${i} must have a valid name`,
+        };
       }
 
-      // Validate post-processing options if present
       if (
-        config.postProcess !== undefined &&
-        (typeof config.postProcess !== 'object' || config.postProcess === null)
+        !feature.input ||
+        typeof feature.input !== 'string' ||
+        !feature.input.trim()
       ) {
         throw {
           code: 'INVALID_PARAMETERS',
-          message: `Pipeline has invalid postProcess (must be an object)`,
+          message: `Feature '${feature.name}' is missing required 'input' field`,
         };
       }
 
-      // Check if all algorithms exist in Essentia registry
-      const algorithmsResponse = await this.getAllAlgorithms();
-      if (!algorithmsResponse.success) {
+      if (
+        feature.params !== undefined &&
+        (typeof feature.params !== 'object' || feature.params === null)
+      ) {
         throw {
-          code: 'ALGORITHM_LIST_ERROR',
-          message: 'Failed to retrieve the list of available algorithms',
+          code: 'INVALID_PARAMETERS',
+          message: `Feature '${feature.name}' has invalid params (must be an object)`,
         };
       }
 
-      const allAlgorithms = algorithmsResponse.data;
+      if (
+        feature.postProcess !== undefined &&
+        (typeof feature.postProcess !== 'object' ||
+          feature.postProcess === null)
+      ) {
+        throw {
+          code: 'INVALID_PARAMETERS',
+          message: `Feature '${feature.name}' has invalid postProcess (must be an object)`,
+        };
+      }
 
-      // Check preprocessing algorithms
-      for (const step of config.preprocess) {
-        if (!allAlgorithms.includes(step.name)) {
-          throw {
-            code: 'INVALID_ALGORITHM',
-            message: `Preprocessing algorithm '${step.name}' not found in Essentia registry`,
-          };
-        }
+      // Validate algorithm-specific parameters
+      if (feature.params) {
+        this.validateAlgorithmParams(feature.name, feature.params);
       }
+    }
 
-      const customAlgorithms = ['Tonnetz'];
-      // // Check feature algorithms
-      for (const feature of config.features) {
-        if (
-          !allAlgorithms.includes(feature.name) &&
-          !customAlgorithms.includes(feature.name)
-        ) {
-          throw {
-            code: 'INVALID_ALGORITHM',
-            message: `Algorithm '${feature.name}' not found in Essentia registry`,
-          };
-        }
+    // Validate post-processing options if present
+    if (
+      config.postProcess !== undefined &&
+      (typeof config.postProcess !== 'object' || config.postProcess === null)
+    ) {
+      throw {
+        code: 'INVALID_PARAMETERS',
+        message: `Pipeline has invalid postProcess (must be an object)`,
+      };
+    }
+
+    // Check if all algorithms exist in Essentia registry
+    const algorithmsResponse = await this.getAllAlgorithms();
+    if (!algorithmsResponse.success) {
+      throw {
+        code: 'ALGORITHM_LIST_ERROR',
+        message: 'Failed to retrieve the list of available algorithms',
+      };
+    }
+
+    const allAlgorithms = algorithmsResponse.data;
+
+    // Check preprocessing algorithms
+    for (const step of config.preprocess) {
+      if (!allAlgorithms.includes(step.name)) {
+        throw {
+          code: 'INVALID_ALGORITHM',
+          message: `Preprocessing algorithm '${step.name}' not found in Essentia registry`,
+        };
       }
+    }
 
-      const pipelineJson = JSON.stringify(config);
-      return await Essentia.executePipeline(pipelineJson);
-    } catch (error) {
-      console.error('Essentia executePipeline error:', error);
-      throw error;
+    const customAlgorithms = ['Tonnetz'];
+    // // Check feature algorithms
+    for (const feature of config.features) {
+      if (
+        !allAlgorithms.includes(feature.name) &&
+        !customAlgorithms.includes(feature.name)
+      ) {
+        throw {
+          code: 'INVALID_ALGORITHM',
+          message: `Algorithm '${feature.name}' not found in Essentia registry`,
+        };
+      }
     }
   }
 
@@ -682,9 +910,13 @@ class EssentiaAPI implements EssentiaInterface {
   /**
    * Extracts multiple audio features in a single batch operation.
    * @param features Array of feature configurations, each with a name and optional parameters
+   * @param range Optional part of the loaded audio to analyse (samples or seconds)
    * @returns A Promise that resolves to an object containing all extracted features
    */
-  async extractFeatures(features: FeatureConfig[]): Promise<any> {
+  async extractFeatures(
+    features: FeatureConfig[],
+    range?: AnalysisRange
+  ): Promise<any> {
     try {
       if (!features || features.length === 0) {
         throw new Error('Feature list cannot be empty');
@@ -699,7 +931,10 @@ class EssentiaAPI implements EssentiaInterface {
         // Create a validated copy with clean parameters
         return {
           name: feature.name,
-          params: validateAlgorithmParams(feature.name, feature.params) || {},
+          params: {
+            ...(validateAlgorithmParams(feature.name, feature.params) || {}),
+            ...range,
+          },
         };
       });
 
@@ -708,7 +943,11 @@ class EssentiaAPI implements EssentiaInterface {
         const singleFeature = cleanedFeatures[0];
         if (singleFeature && singleFeature.name === 'Key') {
           console.log('Using direct executeAlgorithm approach for Key');
-          return await this.executeAlgorithm('Key', singleFeature.params);
+          return await this.executeAlgorithm(
+            'Key',
+            singleFeature.params,
+            JSON_RESULT
+          );
         }
       }
 
@@ -729,7 +968,7 @@ class EssentiaAPI implements EssentiaInterface {
    * @returns A Promise that resolves to the MFCC features
    */
   async extractMFCC(params: MFCCParams = {}): Promise<MFCCResult> {
-    const result = await this.executeAlgorithm('MFCC', params);
+    const result = await this.executeAlgorithm('MFCC', params, JSON_RESULT);
     return result.data?.mfcc
       ? { mfcc: result.data.mfcc, bands: result.data.mfcc_bands }
       : result;
@@ -790,7 +1029,11 @@ class EssentiaAPI implements EssentiaInterface {
 
       // IMPORTANT: Use executeAlgorithm directly instead of extractFeatures
       // This bypasses the problematic extractFeatures bridge method
-      const result = await this.executeAlgorithm('Key', validatedParams);
+      const result = await this.executeAlgorithm(
+        'Key',
+        validatedParams,
+        JSON_RESULT
+      );
 
       // Debug log the result
       console.log('Raw result from Key extraction:', JSON.stringify(result));
@@ -1272,6 +1515,8 @@ class EssentiaAPI implements EssentiaInterface {
 
   /**
    * Sets the number of threads used by the native thread pool.
+   * The same count caps the workers used for frame-parallel processing
+   * (MFCC, Key, HPCP, Tonnetz, MelBands, SpectralContrast).
    * Higher values may improve performance on high-end devices,
    * while lower values may be better for low-end devices.
    *
@@ -1303,6 +1548,85 @@ class EssentiaAPI implements EssentiaInterface {
     }
   }
 
+  /**
+   * Enable or disable native profiling. While enabled, results carry a `profile`
+   * section with per-stage timings (ms), frame counts and buffer bytes.
+   * @param enabled True to enable profiling, false to disable
+   * @returns A Promise that resolves to true on success
+   */
+  async setProfilingEnabled(enabled: boolean): Promise<boolean> {
+    try {
+      return await Essentia.setProfilingEnabled(enabled);
+    } catch (error) {
+      console.error('Essentia setProfilingEnabled error:', error);
+      throw error;
+    }
+  }
+
+  /**
+   * Enable the memo cache of extractFeatures / executePipeline results. Running the
+   * same config again on the same audio (in any session) then returns the stored
+   * result without recomputing any frames.
+   * @param options Byte budget (0 disables the cache) and whether to persist entries
+   * @returns A Promise that resolves to true on success
+   */
+  async setResultCache(options: ResultCacheOptions): Promise<boolean> {
+    try {
+      return await Essentia.setResultCache(
+        options.maxBytes,
+        options.persist ?? false
+      );
+    } catch (error) {
+      console.error('Essentia setResultCache error:', error);
+      throw error;
+    }
+  }
+
+  /**
+   * Drop every memoized result, including persisted ones
+   * @returns A Promise that resolves to true on success
+   */
+  async clearResultCache(): Promise<boolean> {
+    try {
+      return await Essentia.clearResultCache();
+    } catch (error) {
+      console.error('Essentia clearResultCache error:', error);
+      throw error;
+    }
+  }
+
+  /**
+   * Choose when the native library registers its algorithms. Lazy registration (the
+   * default) defers it to the first algorithm call so initialize() returns quickly;
+   * disable it to pay that cost up front. Applies to the next initialization.
+   * @param enabled True to register on first use, false to register in initialize()
+   * @returns A Promise that resolves to true on success
+   */
+  async setLazyRegistration(enabled: boolean): Promise<boolean> {
+    try {
+      return await Essentia.setLazyRegistration(enabled);
+    } catch (error) {
+      console.error('Essentia setLazyRegistration error:', error);
+      throw error;
+    }
+  }
+
+  /**
+   * Creates an independent analysis session with its own audio and caches, e.g. one
+   * per file of a batch import. Sessions run concurrently, sharing Essentia and the
+   * native worker threads; call destroy() on the session when done with it.
+   * @returns A Promise that resolves to the new session
+   */
+  async createSession(): Promise<EssentiaSession> {
+    try {
+      const id: number = await Essentia.createSession();
+      return new EssentiaSessionHandle(id);
+    } catch (error) {
+      console.error('Essentia createSession error:', error);
+      throw error;
+    }
+  }
+
   /**
    * Enable or disable algorithm information caching.
    * Controls both JavaScript and native caching.
@@ -1374,6 +1698,102 @@ class EssentiaAPI implements EssentiaInterface {
     this.allAlgorithmsCache = null;
   }
 
+  /**
+   * Applies the defaults of computeMelSpectrogram and validates the parameters
+   */
+  private resolveMelSpectrogramParams(params: MelSpectrogramParams) {
+    // Destructure with defaults
+    const {
+      frameSize = 2048,
+      hopSize = 1024,
+      nMels = 40,
+      fMin = 0,
+      fMax = 22050,
+      windowType = 'hann',
+      normalize = true,
+      logScale = true,
+      startSample = 0,
+      endSample = -1,
+    } = params;
+
+    // Validate inputs
+    if (
+      !Number.isFinite(frameSize) ||
+      frameSize <= 0 ||
+      !Number.isInteger(frameSize)
+    ) {
+      throw {
+        code: 'INVALID_PARAMETERS',
+        message: 'Frame size must be a positive integer',
+      };
+    }
+    if (
+      !Number.isFinite(hopSize) ||
+      hopSize <= 0 ||
+      !Number.isInteger(hopSize)
+    ) {
+      throw {
+        code: 'INVALID_PARAMETERS',
+        message: 'Hop size must be a positive integer',
+      };
+    }
+
+    if (!Number.isFinite(nMels) || nMels <= 0 || !Number.isInteger(nMels)) {
+      throw {
+        code: 'INVALID_PARAMETERS',
+        message: 'Number of mel bands must be a positive integer',
+      };
+    }
+
+    if (!Number.isFinite(fMin) || fMin < 0) {
+      throw {
+        code: 'INVALID_PARAMETERS',
+        message: 'Minimum frequency must be non-negative',
+      };
+    }
+
+    if (!Number.isFinite(fMax) || fMax <= fMin) {
+      throw {
+        code: 'INVALID_PARAMETERS',
+        message: 'Maximum frequency must be greater than minimum frequency',
+      };
+    }
+
+    if (!windowType || typeof windowType !== 'string' || !windowType.trim()) {
+      throw {
+        code: 'INVALID_PARAMETERS',
+        message: 'Window type must be a non-empty string',
+      };
+    }
+
+    if (typeof normalize !== 'boolean') {
+      throw {
+        code: 'INVALID_PARAMETERS',
+        message: 'Normalize parameter must be a boolean',
+      };
+    }
+
+    if (typeof logScale !== 'boolean') {
+      throw {
+        code: 'INVALID_PARAMETERS',
+        message: 'LogScale parameter must be a boolean',
+      };
+    }
+
+    return {
+      frameSize,
+      hopSize,
+      nMels,
+      fMin,
+      fMax,
+      windowType,
+      normalize,
+      logScale,
+      startSample,
+      endSample,
+    };
+  }
+
   /**
    * Computes a mel spectrogram directly from loaded audio data.
    * This is optimized for efficient computation by processing all frames in C++.
@@ -1385,83 +1805,77 @@ class EssentiaAPI implements EssentiaInterface {
     params: MelSpectrogramParams = {}
   ): Promise<MelSpectrogramResult> {
     try {
-      // Destructure with defaults
       const {
-        frameSize = 2048,
-        hopSize = 1024,
-        nMels = 40,
-        fMin = 0,
-        fMax = 22050,
-        windowType = 'hann',
-        normalize = true,
-        logScale = true,
-      } = params;
-
-      // Validate inputs
-      if (
-        !Number.isFinite(frameSize) ||
-        frameSize <= 0 ||
-        !Number.isInteger(frameSize)
-      ) {
-        throw {
-          code: 'INVALID_PARAMETERS',
-          message: 'Frame size must be a positive integer',
-        };
-      }
-      if (
-        !Number.isFinite(hopSize) ||
-        hopSize <= 0 ||
-        !Number.isInteger(hopSize)
-      ) {
-        throw {
-          code: 'INVALID_PARAMETERS',
-          message: 'Hop size must be a positive integer',
-        };
-      }
-
-      if (!Number.isFinite(nMels) || nMels <= 0 || !Number.isInteger(nMels)) {
-        throw {
-          code: 'INVALID_PARAMETERS',
-          message: 'Number of mel bands must be a positive integer',
-        };
-      }
-
-      if (!Number.isFinite(fMin) || fMin < 0) {
-        throw {
-          code: 'INVALID_PARAMETERS',
-          message: 'Minimum frequency must be non-negative',
-        };
-      }
-
-      if (!Number.isFinite(fMax) || fMax <= fMin) {
-        throw {
-          code: 'INVALID_PARAMETERS',
-          message: 'Maximum frequency must be greater than minimum frequency',
-        };
-      }
+        frameSize,
+        hopSize,
+        nMels,
+        fMin,
+        fMax,
+        windowType,
+        normalize,
+        logScale,
+        startSample,
+        endSample,
+      } = this.resolveMelSpectrogramParams(params);
 
-      if (!windowType || typeof windowType !== 'string' || !windowType.trim()) {
-        throw {
-          code: 'INVALID_PARAMETERS',
-          message: 'Window type must be a non-empty string',
-        };
-      }
+      return await Essentia.computeMelSpectrogram(
+        frameSize,
+        hopSize,
+        nMels,
+        fMin,
+        fMax,
+        windowType,
+        normalize,
+        logScale,
+        startSample,
+        endSample
+      );
+    } catch (error) {
+      console.error('Essentia computeMelSpectrogram error:', error);
+      throw error;
+    }
+  }
 
-      if (typeof normalize !== 'boolean') {
+  /**
+   * Computes the same mel spectrogram as computeMelSpectrogram but writes the bands to
+   * a file, `chunkFrames` frames at a time, instead of returning them. Memory use stays
+   * the same however long the audio is. The file holds timeSteps x nMels little-endian
+   * float32 values, row-major.
+   *
+   * @param params Mel spectrogram parameters plus the output path and chunk size
+   * @returns A Promise that resolves to the shape of the result and the path
+   */
+  async computeMelSpectrogramToFile(
+    params: MelSpectrogramFileParams
+  ): Promise<MelSpectrogramFileResult> {
+    try {
+      const { path, chunkFrames = 256 } = params;
+      if (!path || typeof path !== 'string') {
         throw {
           code: 'INVALID_PARAMETERS',
-          message: 'Normalize parameter must be a boolean',
+          message: 'path must be a non-empty string',
         };
       }
-
-      if (typeof logScale !== 'boolean') {
+      if (!Number.isInteger(chunkFrames) || chunkFrames <= 0) {
         throw {
           code: 'INVALID_PARAMETERS',
-          message: 'LogScale parameter must be a boolean',
+          message: 'chunkFrames must be a positive integer',
         };
       }
+      const {
+        frameSize,
+        hopSize,
+        nMels,
+        fMin,
+        fMax,
+        windowType,
+        normalize,
+        logScale,
+        startSample,
+        endSample,
+      } = this.resolveMelSpectrogramParams(params);
 
-      return await Essentia.computeMelSpectrogram(
+      return await Essentia.computeMelSpectrogramToFile(
         frameSize,
         hopSize,
         nMels,
@@ -1469,10 +1883,14 @@ class EssentiaAPI implements EssentiaInterface {
         fMax,
         windowType,
         normalize,
-        logScale
+        logScale,
+        startSample,
+        endSample,
+        path,
+        chunkFrames
       );
     } catch (error) {
-      console.error('Essentia computeMelSpectrogram error:', error);
+      console.error('Essentia computeMelSpectrogramToFile error:', error);
       throw error;
     }
   }
@@ -1485,7 +1903,11 @@ class EssentiaAPI implements EssentiaInterface {
   async extractChroma(
     params: ChromagramParams = {}
   ): Promise<ChromaResult | EssentiaResult<any>> {
-    const result = await this.executeAlgorithm('Chromagram', params);
+    const result = await this.executeAlgorithm(
+      'Chromagram',
+      params,
+      JSON_RESULT
+    );
 
     if (result.success && result.data) {
       // Check if we have frame-wise or single-frame results
@@ -1521,7 +1943,8 @@ class EssentiaAPI implements EssentiaInterface {
   ): Promise<SpectralContrastResult> {
     const result = await this.executeAlgorithm(
       'SpectralContrast',
-      params as AlgorithmParams
+      params as AlgorithmParams,
+      JSON_RESULT
     );
 
     // Return properly formatted SpectralContrastResult
@@ -1629,7 +2052,11 @@ class EssentiaAPI implements EssentiaInterface {
         throw new Error('computeMean must be a boolean value');
       }
 
-      const result = await this.executeAlgorithm('Tonnetz', validatedParams);
+      const result = await this.executeAlgorithm(
+        'Tonnetz',
+        validatedParams,
+        JSON_RESULT
+      );
 
       if (result.success && result.data) {
         // Check if we have frame-wise or single-frame results
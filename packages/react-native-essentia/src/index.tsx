@@ -10,6 +10,8 @@ export * from './types/algorithms.types';
 export * from './types/pipeline.types';
 
 export { EssentiaCategory };
+export { decodeBinaryPool } from './utils/binaryPool';
+export type { BinaryPool, BinaryPoolValue } from './utils/binaryPool';
 
 // Export the API instance
 export default new EssentiaAPI();
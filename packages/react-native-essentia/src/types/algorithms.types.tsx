@@ -82,6 +82,31 @@ export interface MelSpectrogramParams {
    * The sample rate of the audio in Hz
    */
   sampleRate?: number;
+
+  /**
+   * First sample of the loaded audio to analyse
+   * @default 0
+   */
+  startSample?: number;
+
+  /**
+   * Sample after the last one to analyse
+   * @default end of the audio
+   */
+  endSample?: number;
+}
+
+export interface MelSpectrogramFileParams extends MelSpectrogramParams {
+  /**
+   * File to create (or overwrite) with the bands
+   */
+  path: string;
+
+  /**
+   * Frames computed and written at a time; bounds the native memory used
+   * @default 256
+   */
+  chunkFrames?: number;
 }
 
 export interface AllPassParams extends AlgorithmParams {
@@ -155,6 +180,11 @@ export interface ChromagramParams extends AlgorithmParams {
   normalizeType?: string; // "unit_max"
   minFrequency?: number; // 32.70000076293945
   binsPerOctave?: number; // 12
+  // Wrapper options: "cqt" (default) runs the constant-Q Chromagram on 16384-sample
+  // frames; "stft" folds the cached STFT spectrum into chroma, which is much faster
+  method?: 'cqt' | 'stft';
+  frameSize?: number; // 2048, "stft" only
+  hopSize?: number; // frameSize / 2, "stft" only
 }
 export interface BFCCParams extends AlgorithmParams {
   weighting?: string;
@@ -1225,6 +1255,24 @@ export interface MelSpectrogramResult {
   error?: { code: string; message: string; details?: string };
 }
 
+/**
+ * Result of computeMelSpectrogramToFile: the bands are in the file, timeSteps x nMels
+ * little-endian float32 values, row-major
+ */
+export interface MelSpectrogramFileResult {
+  success: boolean;
+  data?: {
+    path: string;
+    format: 'float32le';
+    sampleRate: number;
+    nMels: number;
+    timeSteps: number;
+    durationMs: number;
+    chunkFrames: number;
+  };
+  error?: { code: string; message: string; details?: string };
+}
+
 /**
  * Result type for Chroma feature extraction
  */
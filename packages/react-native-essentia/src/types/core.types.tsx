@@ -1,5 +1,7 @@
 // packages/react-native-essentia/src/types/core.ts
 import type {
+  MelSpectrogramFileParams,
+  MelSpectrogramFileResult,
   MelSpectrogramParams,
   MelSpectrogramResult,
 } from './algorithms.types';
@@ -8,6 +10,22 @@ export interface AlgorithmParams {
   [key: string]: string | number | boolean | number[] | string[] | undefined;
 }
 
+// 'json' returns plain arrays (easy to inspect, slow for large frame matrices);
+// 'binary' transfers the result pool in a compact encoding and returns
+// Float32Array views (see utils/binaryPool)
+export type ResultFormat = 'json' | 'binary';
+
+export interface ExecuteAlgorithmOptions {
+  resultFormat?: ResultFormat;
+}
+
+// Memo cache of extractFeatures / executePipeline results, keyed by the audio
+// content and the config (setResultCache)
+export interface ResultCacheOptions {
+  maxBytes: number; // 0 disables the cache
+  persist?: boolean; // also keep entries in the app's cache directory
+}
+
 // Define the base interface for the native module
 export interface EssentiaInterface {
   // Core functionality
@@ -19,15 +37,26 @@ export interface EssentiaInterface {
   ): Promise<boolean>;
   executeAlgorithm(
     algorithm: string,
-    params: AlgorithmParams
+    params: AlgorithmParams,
+    options?: ExecuteAlgorithmOptions
   ): Promise<AlgorithmResult>;
+  setResultFormat(format: ResultFormat): void;
+  getResultFormat(): ResultFormat;
   executeBatch(algorithms: FeatureConfig[]): Promise<BatchProcessingResults>;
   testConnection(): Promise<string>;
   getAlgorithmInfo(algorithm: string): Promise<AlgorithmInfo>;
   getAllAlgorithms(): Promise<{ algorithms: string[] }>;
-  extractFeatures(features: FeatureConfig[]): Promise<BatchProcessingResults>;
+  extractFeatures(
+    features: FeatureConfig[],
+    range?: AnalysisRange
+  ): Promise<BatchProcessingResults>;
   setThreadCount(count: number): Promise<boolean>;
   getThreadCount(): Promise<number>;
+  setProfilingEnabled(enabled: boolean): Promise<boolean>;
+  setResultCache(options: ResultCacheOptions): Promise<boolean>;
+  clearResultCache(): Promise<boolean>;
+  setLazyRegistration(enabled: boolean): Promise<boolean>;
+  createSession(): Promise<EssentiaSession>;
 
   // Cache-related functionality
   setCacheEnabled(enabled: boolean): Promise<boolean>;
@@ -38,9 +67,35 @@ export interface EssentiaInterface {
   computeMelSpectrogram(
     params?: MelSpectrogramParams
   ): Promise<MelSpectrogramResult>;
+  computeMelSpectrogramToFile(
+    params: MelSpectrogramFileParams
+  ): Promise<MelSpectrogramFileResult>;
 
   // Pipeline functionality
   executePipeline(config: PipelineConfig): Promise<PipelineResult>;
+  preparePipeline(config: PipelineConfig): Promise<number>;
+  runPipeline(
+    pipelineId: number,
+    pcmData?: Float32Array | number[]
+  ): Promise<PipelineResult>;
+  releasePipeline(pipelineId: number): Promise<boolean>;
+  startPipelineStream(pipelineId: number): Promise<boolean>;
+  appendAudio(
+    pipelineId: number,
+    chunk: Float32Array | number[]
+  ): Promise<PipelineStreamResult>;
+  finishPipelineStream(pipelineId: number): Promise<PipelineStreamResult>;
+}
+
+// Part of the loaded audio to analyse, in samples or (startTime/endTime) in seconds;
+// the end defaults to the end of the audio. Accepted in executeAlgorithm params, by
+// extractFeatures and at the top level of an executePipeline config. Spectral
+// features use the frames centred in the range, so ranges share cached spectra.
+export interface AnalysisRange {
+  startSample?: number;
+  endSample?: number;
+  startTime?: number;
+  endTime?: number;
 }
 
 // Define feature configuration interface
@@ -127,6 +182,45 @@ export interface EssentiaResult<T = Record<string, unknown>> {
   success: boolean;
   data?: T;
   error?: { code: string; message: string; details?: string };
+  // Present while profiling is enabled (setProfilingEnabled)
+  profile?: ProfileReport;
+}
+
+// Native timings of one call. Stage times are self times: a stage nested in
+// another (e.g. "spectrum" inside "MFCC") is not counted again in the outer one.
+export interface ProfileStage {
+  name: string; // algorithm, or "spectrum", "serialize", "pipeline.<node>", ...
+  calls: number;
+  ms: number;
+  frames: number;
+  bytes: number; // buffers allocated for the stage (spectrogram, range slice, ...)
+}
+
+export interface ProfileReport {
+  totalMs: number;
+  stages: ProfileStage[];
+}
+
+// An independent analysis context with its own audio and caches (createSession).
+// Calls on one session run one at a time; different sessions run concurrently on
+// the native worker threads (see setThreadCount).
+export interface EssentiaSession {
+  readonly id: number;
+  setAudioData(
+    pcmData: number[] | Float32Array,
+    sampleRate: number
+  ): Promise<boolean>;
+  executeAlgorithm(
+    algorithm: string,
+    params?: AlgorithmParams
+  ): Promise<AlgorithmResult>;
+  extractFeatures(
+    features: FeatureConfig[],
+    range?: AnalysisRange
+  ): Promise<BatchProcessingResults>;
+  executePipeline(config: PipelineConfig): Promise<PipelineResult>;
+  // Frees the native resources; later calls reject
+  destroy(): Promise<boolean>;
 }
 
 // Removed MelSpectrogramResult interface - now only defined in results.types.tsx
@@ -144,7 +238,10 @@ export interface PipelineFeatureStep {
   postProcess?: {
     mean?: boolean;
     variance?: boolean;
-    // Optional: add other statistics like stddev, min, max in the future if needed
+    min?: boolean;
+    max?: boolean;
+    // Estimated with a fixed-size sketch; each one is returned as `<name>.p<percentile>`
+    percentiles?: number[];
   };
 }
 
@@ -152,7 +249,7 @@ export interface PipelinePostProcessing {
   concatenate?: boolean;
 }
 
-export interface PipelineConfig {
+export interface PipelineConfig extends AnalysisRange {
   preprocess: PipelinePreprocessStep[];
   features: PipelineFeatureStep[];
   postProcess?: PipelinePostProcessing;
@@ -165,8 +262,24 @@ export interface PipelineResult {
     {
       mean?: number | number[];
       variance?: number | number[];
+      min?: number | number[];
+      max?: number | number[];
       // Add a raw field if needed, e.g., raw?: number[][] for frame-wise data
     }
   >;
   error?: { code: string; message: string; details?: string };
 }
+
+// Incremental output of appendAudio / finishPipelineStream
+export interface PipelineStreamResult {
+  success: boolean;
+  data?: {
+    startFrame: number; // index of the first frame in this result
+    frameCount: number;
+    features: Record<string, number[][]>; // one row per new frame
+    // finishPipelineStream only
+    summary?: Record<string, number | number[] | number[][]>;
+    totalFrames?: number;
+  };
+  error?: { code: string; message: string; details?: string };
+}
@@ -0,0 +1,161 @@
+// packages/react-native-essentia/src/utils/binaryPool.ts
+// Decoder for the binary Pool encoding produced by cpp/PoolCodec.cpp.
+// Float payloads are returned as Float32Array views over the decoded buffer
+// (matrices as one view per row), so no per-number copies are made.
+
+export type BinaryPoolValue =
+  | number
+  | string
+  | string[]
+  | Float32Array
+  | Float32Array[];
+
+export type BinaryPool = Record<string, BinaryPoolValue>;
+
+const POOL_MAGIC = 'EPB1';
+const HEADER_BYTES = 16;
+const DESCRIPTOR_FIXED_BYTES = 20;
+
+const DTYPE_FLOAT32 = 0;
+const DTYPE_STRING = 1;
+const DTYPE_RAGGED_FLOAT32 = 2;
+
+const BASE64_ALPHABET =
+  'ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/';
+const BASE64_LOOKUP = (() => {
+  const table = new Uint8Array(256);
+  for (let i = 0; i < BASE64_ALPHABET.length; i++) {
+    table[BASE64_ALPHABET.charCodeAt(i)] = i;
+  }
+  return table;
+})();
+
+/**
+ * Decodes a base64 string into a fresh ArrayBuffer.
+ */
+export function base64ToArrayBuffer(base64: string): ArrayBuffer {
+  let padding = 0;
+  if (base64.endsWith('==')) padding = 2;
+  else if (base64.endsWith('=')) padding = 1;
+
+  const byteLength = (base64.length * 3) / 4 - padding;
+  const bytes = new Uint8Array(byteLength);
+  let out = 0;
+  for (let i = 0; i < base64.length; i += 4) {
+    const a = BASE64_LOOKUP[base64.charCodeAt(i)]!;
+    const b = BASE64_LOOKUP[base64.charCodeAt(i + 1)]!;
+    const c = BASE64_LOOKUP[base64.charCodeAt(i + 2)]!;
+    const d = BASE64_LOOKUP[base64.charCodeAt(i + 3)]!;
+    const triple = (a << 18) | (b << 12) | (c << 6) | d;
+    if (out < byteLength) bytes[out++] = (triple >> 16) & 0xff;
+    if (out < byteLength) bytes[out++] = (triple >> 8) & 0xff;
+    if (out < byteLength) bytes[out++] = triple & 0xff;
+  }
+  return bytes.buffer;
+}
+
+function decodeUtf8(bytes: Uint8Array): string {
+  let result = '';
+  let i = 0;
+  while (i < bytes.length) {
+    const byte = bytes[i++]!;
+    let codePoint: number;
+    if (byte < 0x80) {
+      codePoint = byte;
+    } else if ((byte & 0xe0) === 0xc0) {
+      codePoint = ((byte & 0x1f) << 6) | (bytes[i++]! & 0x3f);
+    } else if ((byte & 0xf0) === 0xe0) {
+      codePoint =
+        ((byte & 0x0f) << 12) |
+        ((bytes[i++]! & 0x3f) << 6) |
+        (bytes[i++]! & 0x3f);
+    } else if ((byte & 0xf8) === 0xf0) {
+      codePoint =
+        ((byte & 0x07) << 18) |
+        ((bytes[i++]! & 0x3f) << 12) |
+        ((bytes[i++]! & 0x3f) << 6) |
+        (bytes[i++]! & 0x3f);
+    } else {
+      codePoint = 0xfffd;
+    }
+    result += String.fromCodePoint(codePoint);
+  }
+  return result;
+}
+
+/**
+ * Decodes a binary Pool (as returned by executeAlgorithm with
+ * `resultFormat: 'binary'`) into descriptor name -> value.
+ */
+export function decodeBinaryPool(input: ArrayBuffer | string): BinaryPool {
+  const buffer = typeof input === 'string' ? base64ToArrayBuffer(input) : input;
+  const view = new DataView(buffer);
+  const bytes = new Uint8Array(buffer);
+
+  if (
+    buffer.byteLength < HEADER_BYTES ||
+    decodeUtf8(bytes.subarray(0, 4)) !== POOL_MAGIC
+  ) {
+    throw new Error('Invalid binary pool: bad magic');
+  }
+  const version = view.getUint32(4, true);
+  if (version !== 1) {
+    throw new Error(`Unsupported binary pool version ${version}`);
+  }
+
+  const count = view.getUint32(8, true);
+  const result: BinaryPool = {};
+  let entry = HEADER_BYTES;
+
+  for (let n = 0; n < count; n++) {
+    const offset = view.getUint32(entry, true);
+    const byteLength = view.getUint32(entry + 4, true);
+    const dim0 = view.getUint32(entry + 8, true);
+    const dim1 = view.getUint32(entry + 12, true);
+    const dtype = view.getUint8(entry + 16);
+    const rank = view.getUint8(entry + 17);
+    const nameLength = view.getUint16(entry + 18, true);
+    const nameStart = entry + DESCRIPTOR_FIXED_BYTES;
+    const name = decodeUtf8(bytes.subarray(nameStart, nameStart + nameLength));
+    entry += (DESCRIPTOR_FIXED_BYTES + nameLength + 3) & ~3;
+
+    if (offset + byteLength > buffer.byteLength) {
+      throw new Error(`Invalid binary pool: ${name} is out of bounds`);
+    }
+
+    if (dtype === DTYPE_FLOAT32) {
+      if (rank === 0) {
+        result[name] = view.getFloat32(offset, true);
+      } else if (rank === 1) {
+        result[name] = new Float32Array(buffer, offset, dim0);
+      } else {
+        const rows: Float32Array[] = [];
+        for (let r = 0; r < dim0; r++) {
+          rows.push(new Float32Array(buffer, offset + r * dim1 * 4, dim1));
+        }
+        result[name] = rows;
+      }
+    } else if (dtype === DTYPE_RAGGED_FLOAT32) {
+      const rows: Float32Array[] = [];
+      let values = offset + dim0 * 4;
+      for (let r = 0; r < dim0; r++) {
+        const length = view.getUint32(offset + r * 4, true);
+        rows.push(new Float32Array(buffer, values, length));
+        values += length * 4;
+      }
+      result[name] = rows;
+    } else if (dtype === DTYPE_STRING) {
+      const strings: string[] = [];
+      let cursor = offset;
+      for (let s = 0; s < dim0; s++) {
+        const length = view.getUint32(cursor, true);
+        cursor += 4;
+        strings.push(decodeUtf8(bytes.subarray(cursor, cursor + length)));
+        cursor += length;
+      }
+      result[name] = rank === 0 ? (strings[0] ?? '') : strings;
+    }
+  }
+
+  return result;
+}